@@ -0,0 +1,193 @@
+#include <stddef.h>
+#include <string.h>
+#include "telesim.h"
+#include "../call_center/call_center.h"
+#include "../call_center/call_center_kw.h"
+#include "../call_center/call_center_ctmc.h"
+#include "../config/config.h"
+#include "../system/system.h"
+
+// delays are handed out as telesim_delay without copying
+typedef char telesim_delay_matches_delay[(sizeof(telesim_delay) == sizeof(delay) &&
+                                          offsetof(telesim_delay, actual) == offsetof(delay, actual)) ? 1 : -1];
+
+// Runs with its own seed on the calling thread, leaving the caller's stream untouched
+typedef struct {
+    rng_state state;
+    int antithetic;
+} saved_rng;
+
+static saved_rng enter_rng(uint64_t seed, int antithetic) {
+    saved_rng saved;
+    rng_get_state(&saved.state);
+    saved.antithetic = rng_get_antithetic();
+    rng_seed(seed);
+    rng_set_antithetic(antithetic);
+    return saved;
+}
+
+static void leave_rng(const saved_rng *saved) {
+    rng_set_state(&saved->state);
+    rng_set_antithetic(saved->antithetic);
+}
+
+int telesim_api_version(void) {
+    return TELESIM_API_VERSION;
+}
+
+void telesim_default_call_center_config(telesim_call_center_config *config) {
+    scenario_config scenario;
+    default_scenario_config(&scenario);
+
+    memset(config, 0, sizeof(*config));
+    config->gen_operators = scenario.call_center.number_of_gen_opr;
+    config->spec_operators = scenario.call_center.number_of_spec_opr;
+    config->gen_queue_length = scenario.call_center.length_gen_queue;
+    config->arrival_rate_per_hour = scenario.arrival_rate_per_hour;
+    config->general_purpose_ratio = scenario.call_center.general_purpose_ratio;
+    config->gen_only_min_duration_s = scenario.gen_call_only.gen_min_duration_s;
+    config->gen_only_avg_duration_s = scenario.gen_call_only.gen_avg_duration_s;
+    config->gen_only_max_duration_s = scenario.gen_call_only.gen_max_duration_s;
+    config->spec_min_duration_s = scenario.gen_call_specific.spec_min_duration_s;
+    config->spec_avg_duration_s = scenario.gen_call_specific.spec_avg_duration_s;
+    config->spec_std_duration_s = scenario.gen_call_specific.spec_std_duration_s;
+    config->spec_max_duration_s = scenario.gen_call_specific.spec_max_duration_s;
+    config->area_spec_min_duration_s = scenario.area_spec.min_duration_s;
+    config->area_spec_avg_duration_s = scenario.area_spec.avg_duration_s;
+    config->number_of_events = scenario.simulation.number_of_events;
+    config->engine = TELESIM_ENGINE_EVENT;
+    config->seed = (uint64_t)scenario.simulation.random_seed;
+}
+
+int telesim_run_call_center(const telesim_call_center_config *config, telesim_call_center_result *result) {
+    if (config->gen_operators <= 0 || config->spec_operators <= 0 || config->gen_queue_length < 0 ||
+        config->number_of_events <= 0 || config->arrival_rate_per_hour <= 0.0 ||
+        config->engine < TELESIM_ENGINE_EVENT || config->engine > TELESIM_ENGINE_CTMC) {
+        return TELESIM_EINVAL;
+    }
+
+    // Nested engine config on the stack; nothing outlives the call
+    generic_call_gen_only_config gen_only = {
+        config->gen_only_min_duration_s, config->gen_only_avg_duration_s, config->gen_only_max_duration_s
+    };
+    generic_call_specific_config gen_specific = {
+        config->spec_min_duration_s, config->spec_avg_duration_s,
+        config->spec_std_duration_s, config->spec_max_duration_s
+    };
+    general_purpose_config general = {&gen_only, &gen_specific};
+    area_specific_config area = {config->area_spec_min_duration_s, config->area_spec_avg_duration_s};
+    call_center_config cc = {
+        config->gen_operators, config->spec_operators, config->gen_queue_length,
+        config->arrival_rate_per_hour / 3600.0, config->general_purpose_ratio, &general, &area,
+        WAIT_PREDICTOR_QUEUE_AVERAGE, 0.0, 0.0, 1, 0, {1.0}, NULL, NULL, false, false
+    };
+
+    saved_rng saved = enter_rng(config->seed, config->antithetic);
+    call_center_stats stats;
+    switch (config->engine) {
+    case TELESIM_ENGINE_KW:
+        stats = start_call_center_kw(cc, config->number_of_events);
+        break;
+    case TELESIM_ENGINE_CTMC:
+        stats = start_call_center_ctmc(cc, config->number_of_events);
+        break;
+    default:
+        stats = start_call_center(cc, config->number_of_events);
+        break;
+    }
+    leave_rng(&saved);
+
+    const general_purpose_stats *g = &stats.general_p_stats;
+    const area_specific_stats *a = &stats.area_spec_stats;
+    result->prob_call_delayed = g->prob_call_delayed;
+    result->prob_call_lost = g->prob_call_lost;
+    result->avg_delay_s = g->avg_delay_of_calls;
+    result->avg_abs_prediction_error = g->avg_abs_prediction_error;
+    result->avg_rel_prediction_error = g->avg_rel_prediction_error;
+    result->gen_avg_busy_operators = g->avg_busy_operators;
+    result->gen_avg_queue_length = g->avg_queue_length;
+    result->avg_answer_time_s = a->avg_answ_time;
+    result->spec_avg_busy_operators = a->avg_busy_operators;
+    result->spec_avg_queue_length = a->avg_queue_length;
+    result->mean_interarrival_time = g->mean_interarrival_time;
+    result->generic_only_fraction = g->generic_only_fraction;
+    result->mean_service_time = g->mean_service_time;
+    result->delay_p50_s = hdr_histogram_percentile(&g->delay_histogram, 50.0);
+    result->delay_p90_s = hdr_histogram_percentile(&g->delay_histogram, 90.0);
+    result->delay_p99_s = hdr_histogram_percentile(&g->delay_histogram, 99.0);
+    result->delay_p999_s = hdr_histogram_percentile(&g->delay_histogram, 99.9);
+    free_hdr_histogram(&stats.general_p_stats.delay_histogram);
+    // Ownership of the engine's buffers moves to the result
+    result->delays = (telesim_delay *)g->delays.data;
+    result->n_delays = g->delays.size;
+    result->gen_queue_length_distribution = g->queue_length_distribution;
+    result->gen_queue_length_distribution_size = g->queue_length_distribution_size;
+    result->spec_queue_length_distribution = a->queue_length_distribution;
+    result->spec_queue_length_distribution_size = a->queue_length_distribution_size;
+    return TELESIM_OK;
+}
+
+void telesim_free_call_center_result(telesim_call_center_result *result) {
+    free(result->delays);
+    free(result->gen_queue_length_distribution);
+    free(result->spec_queue_length_distribution);
+    result->delays = NULL;
+    result->gen_queue_length_distribution = NULL;
+    result->spec_queue_length_distribution = NULL;
+    result->n_delays = 0;
+    result->gen_queue_length_distribution_size = 0;
+    result->spec_queue_length_distribution_size = 0;
+}
+
+int telesim_run_erlang(int channels, int lambda, double avg_duration_s, int number_of_events,
+                       double delay_threshold_s, int queue_capacity, uint64_t seed,
+                       telesim_erlang_result *result) {
+    if (channels <= 0 || lambda <= 0 || avg_duration_s <= 0.0 || number_of_events <= 0 || queue_capacity < 0) {
+        return TELESIM_EINVAL;
+    }
+
+    saved_rng saved = enter_rng(seed, 0);
+    ErlangGenStat st = erlang_gen_system(channels, lambda, avg_duration_s, NULL, number_of_events,
+                                         delay_threshold_s, queue_capacity);
+    leave_rng(&saved);
+
+    result->prob_delayed = st.prob_pkt_delayed;
+    result->avg_delay_s = st.avg_delay_all_pkt;
+    result->prob_delayed_more = st.prob_pkt_delayed_more_ax;
+    result->block_probability = st.block_probability;
+    result->avg_busy = st.avg_busy;
+    result->avg_queue_length = st.avg_queue_length;
+    result->mean_interarrival = st.mean_interarrival;
+    result->mean_service = st.mean_service;
+    result->delay_p50_s = hdr_histogram_percentile(&st.log_histogram, 50.0);
+    result->delay_p90_s = hdr_histogram_percentile(&st.log_histogram, 90.0);
+    result->delay_p99_s = hdr_histogram_percentile(&st.log_histogram, 99.0);
+    result->delay_p999_s = hdr_histogram_percentile(&st.log_histogram, 99.9);
+    free_hdr_histogram(&st.log_histogram);
+    result->delay_histogram = st.histogram;
+    result->delay_histogram_size = st.histogram_size;
+    result->queue_length_distribution = st.queue_length_distribution;
+    result->queue_length_distribution_size = st.queue_length_distribution_size;
+    return TELESIM_OK;
+}
+
+void telesim_free_erlang_result(telesim_erlang_result *result) {
+    free(result->delay_histogram);
+    free(result->queue_length_distribution);
+    result->delay_histogram = NULL;
+    result->queue_length_distribution = NULL;
+    result->delay_histogram_size = 0;
+    result->queue_length_distribution_size = 0;
+}
+
+int telesim_erlang_b_curve(int max_channels, int lambda, double avg_duration_s,
+                           int number_of_events, uint64_t seed, double *blocking) {
+    if (max_channels <= 0 || lambda <= 0 || avg_duration_s <= 0.0 || number_of_events <= 0) {
+        return TELESIM_EINVAL;
+    }
+
+    saved_rng saved = enter_rng(seed, 0);
+    erlang_b_curve(max_channels, lambda, avg_duration_s, number_of_events, blocking);
+    leave_rng(&saved);
+    return TELESIM_OK;
+}
@@ -0,0 +1,130 @@
+#ifndef TELESIM_H
+#define TELESIM_H
+
+// Stable C API of libtelesim.so (make libtelesim.so).
+//
+// Every call is self-contained: it takes a flat configuration with an explicit
+// seed, runs on the calling thread's own RNG stream (saving and restoring the
+// caller's stream) and returns results in caller-owned structs. Calls on
+// different threads never share state, so they can run concurrently.
+//
+// Arrays inside results are allocated by the library and released with the
+// matching telesim_free_* function; scripts/telesim.py wraps them as numpy
+// arrays without copying.
+
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#    define TELESIM_API __attribute__((visibility("default")))
+#else
+#    define TELESIM_API
+#endif
+
+// Bumped whenever a struct layout or signature below changes
+#define TELESIM_API_VERSION 2
+
+#define TELESIM_OK 0
+#define TELESIM_EINVAL (-1)       // Invalid configuration value
+
+typedef enum {
+    TELESIM_ENGINE_EVENT = 0,     // Event-list simulation
+    TELESIM_ENGINE_KW = 1,        // Kiefer-Wolfowitz recursion
+    TELESIM_ENGINE_CTMC = 2       // Steady-state CTMC (exponential durations, no delays)
+} telesim_engine;
+
+typedef struct {
+    int gen_operators;
+    int spec_operators;
+    int gen_queue_length;
+    double arrival_rate_per_hour;
+    double general_purpose_ratio;
+    double gen_only_min_duration_s;
+    double gen_only_avg_duration_s;
+    double gen_only_max_duration_s;
+    double spec_min_duration_s;
+    double spec_avg_duration_s;
+    double spec_std_duration_s;
+    double spec_max_duration_s;
+    double area_spec_min_duration_s;
+    double area_spec_avg_duration_s;
+    int number_of_events;
+    int engine;                   // telesim_engine
+    uint64_t seed;
+    int antithetic;               // Mirror every uniform draw (u -> 1 - u)
+} telesim_call_center_config;
+
+typedef struct {
+    double predicted;
+    double actual;
+} telesim_delay;
+
+typedef struct {
+    // General-purpose tier
+    double prob_call_delayed;
+    double prob_call_lost;
+    double avg_delay_s;
+    double avg_abs_prediction_error;
+    double avg_rel_prediction_error;
+    double gen_avg_busy_operators;
+    double gen_avg_queue_length;
+    // Area-specific tier
+    double avg_answer_time_s;
+    double spec_avg_busy_operators;
+    double spec_avg_queue_length;
+    // Input sample means (control variates)
+    double mean_interarrival_time;
+    double generic_only_fraction;
+    double mean_service_time;
+    // Percentiles of the waits of delayed calls (log-linear histogram, within 1%)
+    double delay_p50_s;
+    double delay_p90_s;
+    double delay_p99_s;
+    double delay_p999_s;
+    // Owned arrays
+    telesim_delay *delays;                    // One per call that waited
+    int64_t n_delays;
+    double *gen_queue_length_distribution;    // Fraction of time with k calls queued
+    int32_t gen_queue_length_distribution_size;
+    double *spec_queue_length_distribution;
+    int32_t spec_queue_length_distribution_size;
+} telesim_call_center_result;
+
+typedef struct {
+    double prob_delayed;
+    double avg_delay_s;
+    double prob_delayed_more;                 // P(delay > delay_threshold)
+    double block_probability;
+    double avg_busy;
+    double avg_queue_length;
+    double mean_interarrival;
+    double mean_service;
+    double delay_p50_s;
+    double delay_p90_s;
+    double delay_p99_s;
+    double delay_p999_s;
+    // Owned arrays
+    int32_t *delay_histogram;
+    int32_t delay_histogram_size;
+    double *queue_length_distribution;
+    int32_t queue_length_distribution_size;
+} telesim_erlang_result;
+
+TELESIM_API int telesim_api_version(void);
+
+// Defaults of constants.h
+TELESIM_API void telesim_default_call_center_config(telesim_call_center_config *config);
+
+TELESIM_API int telesim_run_call_center(const telesim_call_center_config *config, telesim_call_center_result *result);
+TELESIM_API void telesim_free_call_center_result(telesim_call_center_result *result);
+
+// M/M/c/K system of erlang_gen_system (K = channels + queue_capacity)
+TELESIM_API int telesim_run_erlang(int channels, int lambda, double avg_duration_s, int number_of_events,
+                                   double delay_threshold_s, int queue_capacity, uint64_t seed,
+                                   telesim_erlang_result *result);
+TELESIM_API void telesim_free_erlang_result(telesim_erlang_result *result);
+
+// Erlang-B blocking for 1..max_channels into blocking[max_channels] (caller-owned)
+TELESIM_API int telesim_erlang_b_curve(int max_channels, int lambda, double avg_duration_s,
+                                       int number_of_events, uint64_t seed, double *blocking);
+
+#endif // TELESIM_H
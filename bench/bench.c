@@ -0,0 +1,603 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../models/linked-list.h"
+#include "../models/linked_list_call.h"
+#include "../models/event_set.h"
+#include "../models/class_queue.h"
+#include "../models/arrival_process.h"
+#include "../models/service_dist.h"
+#include "../poisson/poisson.h"
+#include "../system/system.h"
+#include "../call_center/call_center.h"
+#include "../call_center/call_center_kw.h"
+#include "../call_center/call_center_pdes.h"
+#include "../system/kiefer_wolfowitz.h"
+#include "../models/wait_predictor.h"
+#include "../config/config.h"
+#include "bench_util.h"
+
+// Micro and macro benchmarks for the simulation kernels. Results are written
+// as JSON so successive runs can be diffed to catch regressions.
+// Usage: ./bench [--quick] [output.json]
+
+#define BENCH_SEED 42
+
+typedef struct {
+    FILE *out;
+    int n_results;
+    int repetitions;
+    long long micro_ops;
+    int macro_samples;
+} bench_ctx;
+
+// Keeps the optimizer from discarding benchmarked computations
+static volatile double sink;
+
+static void emit_result(bench_ctx *ctx, const char *group, const char *name, const char *params,
+                        const char *unit, long long ops, double seconds) {
+    fprintf(ctx->out, "%s\n    {\"group\": \"%s\", \"name\": \"%s\", \"params\": {%s}, "
+                      "\"unit\": \"%s\", \"ops\": %lld, \"seconds\": %.6f, \"ns_per_op\": %.2f, \"ops_per_sec\": %.1f}",
+            (ctx->n_results > 0) ? "," : "", group, name, params, unit, ops, seconds,
+            1e9 * seconds / ops, ops / seconds);
+    ctx->n_results++;
+
+    fprintf(stderr, "  %-6s %-22s %-40s %10.2f ns/%s\n", group, name, params, 1e9 * seconds / ops, unit);
+}
+
+// ------------------- MICRO BENCHMARKS ------------------- //
+
+// Hold model: pop the earliest event and schedule a new one, keeping `pending` events
+static double bench_event_list_hold(int pending, long long ops) {
+    list *events = NULL;
+    for (int i = 0; i < pending; i++) {
+        events = __add(events, ARRIVAL, next_poisson(1.0));
+    }
+
+    double start = now_seconds();
+    for (long long i = 0; i < ops; i++) {
+        double t = events->time;
+        events = __remove(events);
+        events = __add(events, DEPARTURE, t + next_poisson(1.0));
+    }
+    double elapsed = now_seconds() - start;
+
+    sink = events->time;
+    while (events != NULL) {
+        events = __remove(events);
+    }
+    return elapsed;
+}
+
+static double bench_call_list_hold(int pending, long long ops) {
+    call c;
+    memset(&c, 0, sizeof(c));
+
+    call_list *events = NULL;
+    for (int i = 0; i < pending; i++) {
+        events = _add(events, ARRIVAL, next_poisson(1.0), c);
+    }
+
+    double start = now_seconds();
+    for (long long i = 0; i < ops; i++) {
+        double t = events->time;
+        events = _remove(events);
+        events = _add(events, DEPARTURE, t + next_poisson(1.0), c);
+    }
+    double elapsed = now_seconds() - start;
+
+    sink = events->time;
+    while (events != NULL) {
+        events = _remove(events);
+    }
+    return elapsed;
+}
+
+// Cancel a random pending event through its handle and schedule a new one, keeping
+// `pending` events (timers of queued calls, most answered before they expire)
+static double bench_event_set_cancel(int pending, long long ops) {
+    event_set events;
+    init_event_set(&events, pending);
+    int *handles = malloc(pending * sizeof(int));
+    if (!handles) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < pending; i++) {
+        handles[i] = event_set_schedule(&events, next_poisson(1.0), NULL);
+    }
+
+    double t = 0.0;
+    double start = now_seconds();
+    for (long long i = 0; i < ops; i++) {
+        int j = (int)(next_uniform() * pending);
+        event_set_cancel(&events, handles[j]);
+        t += 1e-3;
+        handles[j] = event_set_schedule(&events, t + next_poisson(1.0), NULL);
+    }
+    double elapsed = now_seconds() - start;
+
+    sink = event_set_next_time(&events);
+    free(handles);
+    free_event_set(&events);
+    return elapsed;
+}
+
+// Enqueue at the tail and dequeue at the head of a FIFO holding `length` items
+static double bench_fifo(int length, long long ops) {
+    list *queue = NULL;
+    for (int i = 0; i < length; i++) {
+        queue = __add_fifo(queue, ARRIVAL, (double)i);
+    }
+
+    double start = now_seconds();
+    for (long long i = 0; i < ops; i++) {
+        queue = __add_fifo(queue, ARRIVAL, (double)i);
+        queue = __remove(queue);
+    }
+    double elapsed = now_seconds() - start;
+
+    sink = queue->time;
+    while (queue != NULL) {
+        queue = __remove(queue);
+    }
+    return elapsed;
+}
+
+// Same FIFO traffic through a priority queue of 4 classes, each item in a random class
+static double bench_class_queue(int length, long long ops) {
+    class_queue queue;
+    init_class_queue(&queue, 4, length + 1);
+    for (int i = 0; i < length; i++) {
+        class_queue_push(&queue, (int)(next_uniform() * 4), &queue);
+    }
+
+    double start = now_seconds();
+    for (long long i = 0; i < ops; i++) {
+        class_queue_push(&queue, (int)(next_uniform() * 4), &queue);
+        class_queue_pop(&queue);
+    }
+    double elapsed = now_seconds() - start;
+
+    sink = queue.size;
+    free_class_queue(&queue);
+    return elapsed;
+}
+
+typedef double (*variate_fn)(void);
+
+static double draw_poisson(void) {
+    return next_poisson(1.0);
+}
+
+static double draw_box_muller(void) {
+    return box_muller();
+}
+
+// Gaps popped from a block-generated arrival process (default MMPP and batch settings)
+static double bench_arrival_process(arrival_kind kind, long long ops) {
+    arrival_config config = {kind, 2, {0.5, 1.5}, {1800.0, 1800.0}, 2.0, NULL, 0};
+    arrival_process arrivals;
+    init_arrival_process(&arrivals, &config, 80.0 / 3600.0);
+
+    double acc = 0.0;
+    double start = now_seconds();
+    for (long long i = 0; i < ops; i++) {
+        acc += arrival_process_next(&arrivals);
+    }
+    double elapsed = now_seconds() - start;
+
+    sink = acc;
+    free_arrival_process(&arrivals);
+    return elapsed;
+}
+
+// Table-driven inverse CDF, to set against next_poisson
+static double bench_service_dist(service_kind kind, long long ops) {
+    static service_dist dist;
+    dist.kind = kind;
+    dist.cv = 2.0;
+    prepare_service_dist(&dist);
+
+    double acc = 0.0;
+    double start = now_seconds();
+    for (long long i = 0; i < ops; i++) {
+        acc += service_dist_draw(&dist, 150.0);
+    }
+    double elapsed = now_seconds() - start;
+    sink = acc;
+    return elapsed;
+}
+
+static double bench_variate(variate_fn fn, long long ops) {
+    double acc = 0.0;
+    double start = now_seconds();
+    for (long long i = 0; i < ops; i++) {
+        acc += fn();
+    }
+    double elapsed = now_seconds() - start;
+    sink = acc;
+    return elapsed;
+}
+
+// Live wait prediction: every op answers one prediction and applies one event
+// of a recorded event stream of a saturated pool
+#define PREDICTOR_OPERATORS 8
+#define PREDICTOR_MAX_QUEUE 32
+#define PREDICTOR_STREAM_LEN 4096
+
+typedef struct {
+    int type;       // 0 arrival, 1 answer, 2 departure
+    double value;   // Wait (answer) or service time (departure)
+} predictor_event;
+
+static void record_predictor_stream(predictor_event *stream) {
+    int busy = 0, queued = 0;
+    int n = 0;
+    while (n < PREDICTOR_STREAM_LEN) {
+        bool arrival = (busy == 0) || (next_uniform() < 0.5 && queued < PREDICTOR_MAX_QUEUE);
+        if (arrival) {
+            stream[n++] = (predictor_event){0, 0.0};
+            if (busy < PREDICTOR_OPERATORS) {
+                busy++;
+            } else {
+                queued++;
+            }
+            continue;
+        }
+        stream[n++] = (predictor_event){2, next_poisson(120.0)};
+        busy--;
+        // The freed operator takes the next queued call
+        if (queued > 0 && n < PREDICTOR_STREAM_LEN) {
+            stream[n++] = (predictor_event){1, next_poisson(60.0)};
+            queued--;
+            busy++;
+        }
+    }
+}
+
+static double bench_wait_predictor(wait_predictor_kind kind, long long ops) {
+    predictor_event stream[PREDICTOR_STREAM_LEN];
+    record_predictor_stream(stream);
+
+    wait_predictor p;
+    double acc = 0.0;
+    double start = now_seconds();
+    for (long long i = 0; i < ops; i++) {
+        int k = (int)(i % PREDICTOR_STREAM_LEN);
+        if (k == 0) {
+            init_wait_predictor(&p, kind, PREDICTOR_OPERATORS, 120.0, WAIT_PREDICTOR_DEFAULT_SMOOTHING);
+        }
+        acc += wait_predictor_predict(&p);
+        switch (stream[k].type) {
+        case 0:
+            wait_predictor_arrival(&p);
+            break;
+        case 1:
+            wait_predictor_answer(&p, stream[k].value);
+            break;
+        default:
+            wait_predictor_departure(&p, stream[k].value);
+            break;
+        }
+    }
+    double elapsed = now_seconds() - start;
+    sink = acc;
+    return elapsed;
+}
+
+// ------------------- MACRO BENCHMARKS ------------------- //
+
+typedef enum {
+    KERNEL_ERLANG_B,
+    KERNEL_ERLANG_B_CURVE,
+    KERNEL_ERLANG_C,
+    KERNEL_ERLANG_C_KW,
+    KERNEL_ERLANG_GEN,
+    KERNEL_ERLANG_CTMC,
+} erlang_kernel;
+
+// Replications per lockstep CTMC run; its cost per arrival covers all of them
+#define BENCH_CTMC_REPLICATIONS 32
+
+static double run_erlang_kernel(erlang_kernel kernel, int channels, int lambda, double avg_duration, int n_samples) {
+    double start = now_seconds();
+    switch (kernel) {
+    case KERNEL_ERLANG_B:
+        sink = erlang_b_system(channels, lambda, avg_duration, n_samples);
+        break;
+    case KERNEL_ERLANG_B_CURVE: {
+        // Whole curve for 1..channels, compare against `channels` erlang_b_system runs
+        double *blocking = malloc(channels * sizeof(double));
+        erlang_b_curve(channels, lambda, avg_duration, n_samples, blocking);
+        sink = blocking[channels - 1];
+        free(blocking);
+        break;
+    }
+    case KERNEL_ERLANG_C: {
+        ErlangCstat st = erlang_c_system(channels, lambda, avg_duration, n_samples, 0.01);
+        sink = st.prob_pkt_delayed;
+        free(st.histogram);
+        free_hdr_histogram(&st.log_histogram);
+        break;
+    }
+    case KERNEL_ERLANG_C_KW: {
+        ErlangCstat st = erlang_c_system_kw(channels, lambda, avg_duration, n_samples, 0.01);
+        sink = st.prob_pkt_delayed;
+        free(st.histogram);
+        free_hdr_histogram(&st.log_histogram);
+        break;
+    }
+    case KERNEL_ERLANG_GEN: {
+        ErlangGenStat st = erlang_gen_system(channels, lambda, avg_duration, NULL, n_samples, 0.01, 10);
+        sink = st.block_probability;
+        free(st.histogram);
+        free_hdr_histogram(&st.log_histogram);
+        free(st.queue_length_distribution);
+        break;
+    }
+    case KERNEL_ERLANG_CTMC: {
+        ErlangRepStat st[BENCH_CTMC_REPLICATIONS];
+        erlang_ctmc_replications(channels, lambda, avg_duration, 10, n_samples, BENCH_CTMC_REPLICATIONS, st);
+        sink = st[0].block_probability;
+        break;
+    }
+    }
+    return now_seconds() - start;
+}
+
+static double best_of(bench_ctx *ctx, double (*once)(void *), void *arg) {
+    double best = 1e30;
+    for (int r = 0; r < ctx->repetitions; r++) {
+        rng_seed(BENCH_SEED);
+        double t = once(arg);
+        if (t < best) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+typedef struct {
+    erlang_kernel kernel;
+    int channels;
+    int lambda;
+    double avg_duration;
+    int n_samples;
+} erlang_args;
+
+static double erlang_once(void *arg) {
+    erlang_args *a = arg;
+    return run_erlang_kernel(a->kernel, a->channels, a->lambda, a->avg_duration, a->n_samples);
+}
+
+typedef struct {
+    call_center_stats (*engine)(call_center_config config, int number_of_events);
+    call_center_config config;
+    int n_events;
+} call_center_args;
+
+static double call_center_once(void *arg) {
+    call_center_args *a = arg;
+    double start = now_seconds();
+    call_center_stats st = a->engine(a->config, a->n_events);
+    double elapsed = now_seconds() - start;
+    sink = st.general_p_stats.prob_call_delayed;
+    free_call_center_stats(&st);
+    return elapsed;
+}
+
+static void run_micro(bench_ctx *ctx) {
+    static const int pending_sizes[] = {10, 100, 1000};
+    char params[128];
+
+    for (size_t i = 0; i < sizeof(pending_sizes) / sizeof(pending_sizes[0]); i++) {
+        int k = pending_sizes[i];
+        // The sorted lists are O(k) per insert, so scale the work down with k
+        long long ops = ctx->micro_ops / (k >= 1000 ? 10 : 1);
+        double best_list = 1e30, best_call = 1e30, best_fifo = 1e30, best_cancel = 1e30, best_classes = 1e30;
+
+        for (int r = 0; r < ctx->repetitions; r++) {
+            rng_seed(BENCH_SEED);
+            double t = bench_event_list_hold(k, ops);
+            best_list = (t < best_list) ? t : best_list;
+            rng_seed(BENCH_SEED);
+            t = bench_call_list_hold(k, ops);
+            best_call = (t < best_call) ? t : best_call;
+            t = bench_fifo(k, ops);
+            best_fifo = (t < best_fifo) ? t : best_fifo;
+            rng_seed(BENCH_SEED);
+            t = bench_event_set_cancel(k, ctx->micro_ops);
+            best_cancel = (t < best_cancel) ? t : best_cancel;
+            rng_seed(BENCH_SEED);
+            t = bench_class_queue(k, ctx->micro_ops);
+            best_classes = (t < best_classes) ? t : best_classes;
+        }
+
+        snprintf(params, sizeof(params), "\"pending\": %d", k);
+        emit_result(ctx, "micro", "event_list_hold", params, "op", ops, best_list);
+        emit_result(ctx, "micro", "call_list_hold", params, "op", ops, best_call);
+        emit_result(ctx, "micro", "event_set_cancel", params, "op", ctx->micro_ops, best_cancel);
+        snprintf(params, sizeof(params), "\"length\": %d", k);
+        emit_result(ctx, "micro", "fifo_enqueue_dequeue", params, "op", ops, best_fifo);
+        emit_result(ctx, "micro", "class_queue_push_pop", params, "op", ctx->micro_ops, best_classes);
+    }
+
+    struct {
+        const char *name;
+        variate_fn fn;
+    } variates[] = {
+        {"next_uniform", next_uniform},
+        {"next_poisson", draw_poisson},
+        {"box_muller", draw_box_muller},
+    };
+
+    for (size_t i = 0; i < sizeof(variates) / sizeof(variates[0]); i++) {
+        double best = 1e30;
+        for (int r = 0; r < ctx->repetitions; r++) {
+            rng_seed(BENCH_SEED);
+            double t = bench_variate(variates[i].fn, ctx->micro_ops);
+            best = (t < best) ? t : best;
+        }
+        emit_result(ctx, "micro", variates[i].name, "", "draw", ctx->micro_ops, best);
+    }
+
+    static const arrival_kind arrival_kinds[] = {ARRIVAL_MMPP, ARRIVAL_BATCH};
+    for (size_t i = 0; i < sizeof(arrival_kinds) / sizeof(arrival_kinds[0]); i++) {
+        double best = 1e30;
+        for (int r = 0; r < ctx->repetitions; r++) {
+            rng_seed(BENCH_SEED);
+            double t = bench_arrival_process(arrival_kinds[i], ctx->micro_ops);
+            best = (t < best) ? t : best;
+        }
+        snprintf(params, sizeof(params), "\"process\": \"%s\"", arrival_kind_name(arrival_kinds[i]));
+        emit_result(ctx, "micro", "arrival_gap", params, "draw", ctx->micro_ops, best);
+    }
+
+    static const service_kind service_kinds[] = {SERVICE_LOGNORMAL, SERVICE_HYPEREXPONENTIAL};
+    for (size_t i = 0; i < sizeof(service_kinds) / sizeof(service_kinds[0]); i++) {
+        double best = 1e30;
+        for (int r = 0; r < ctx->repetitions; r++) {
+            rng_seed(BENCH_SEED);
+            double t = bench_service_dist(service_kinds[i], ctx->micro_ops);
+            best = (t < best) ? t : best;
+        }
+        snprintf(params, sizeof(params), "\"law\": \"%s\"", service_kind_name(service_kinds[i]));
+        emit_result(ctx, "micro", "service_draw", params, "draw", ctx->micro_ops, best);
+    }
+
+    static const wait_predictor_kind predictors[] = {WAIT_PREDICTOR_QUEUE_AVERAGE, WAIT_PREDICTOR_COMPLETION_RATE};
+    for (size_t i = 0; i < sizeof(predictors) / sizeof(predictors[0]); i++) {
+        double best = 1e30;
+        for (int r = 0; r < ctx->repetitions; r++) {
+            rng_seed(BENCH_SEED);
+            double t = bench_wait_predictor(predictors[i], ctx->micro_ops);
+            best = (t < best) ? t : best;
+        }
+        snprintf(params, sizeof(params), "\"predictor\": \"%s\"", wait_predictor_name(predictors[i]));
+        emit_result(ctx, "micro", "wait_predictor", params, "prediction", ctx->micro_ops, best);
+    }
+}
+
+static void run_macro(bench_ctx *ctx) {
+    static const struct {
+        erlang_kernel kernel;
+        const char *name;
+    } kernels[] = {
+        {KERNEL_ERLANG_B, "erlang_b_system"},
+        {KERNEL_ERLANG_B_CURVE, "erlang_b_curve"},
+        {KERNEL_ERLANG_C, "erlang_c_system"},
+        {KERNEL_ERLANG_C_KW, "erlang_c_system_kw"},
+        {KERNEL_ERLANG_GEN, "erlang_gen_system"},
+        {KERNEL_ERLANG_CTMC, "erlang_ctmc_x32"},
+    };
+    static const int channel_counts[] = {2, 5, 10};
+    static const double loads[] = {0.5, 0.8, 0.95};  // Offered load per channel
+    char params[128];
+
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        for (size_t c = 0; c < sizeof(channel_counts) / sizeof(channel_counts[0]); c++) {
+            for (size_t l = 0; l < sizeof(loads) / sizeof(loads[0]); l++) {
+                erlang_args args = {kernels[k].kernel, channel_counts[c], 200,
+                                    loads[l] * channel_counts[c] / 200.0, ctx->macro_samples};
+                double t = best_of(ctx, erlang_once, &args);
+
+                snprintf(params, sizeof(params), "\"channels\": %d, \"load\": %.2f", channel_counts[c], loads[l]);
+                emit_result(ctx, "macro", kernels[k].name, params, "arrival", args.n_samples, t);
+            }
+        }
+    }
+
+    static const struct {
+        int gen, spec, queue;
+    } staffing[] = {
+        {4, 5, 6},
+        {6, 8, 10},
+        {10, 12, 20},
+    };
+    static const double rates_per_hour[] = {50.0, 80.0, 110.0};
+
+    scenario_config scenario;
+    default_scenario_config(&scenario);
+
+    static const struct {
+        const char *name;
+        call_center_stats (*engine)(call_center_config config, int number_of_events);
+    } engines[] = {
+        {"start_call_center", start_call_center},
+        {"start_call_center_kw", start_call_center_kw},
+        {"start_call_center_pdes", start_call_center_pdes},
+    };
+
+    for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+        for (size_t s = 0; s < sizeof(staffing) / sizeof(staffing[0]); s++) {
+            for (size_t r = 0; r < sizeof(rates_per_hour) / sizeof(rates_per_hour[0]); r++) {
+                call_center_args args;
+                args.engine = engines[e].engine;
+                args.config = scenario.call_center;
+                args.config.number_of_gen_opr = staffing[s].gen;
+                args.config.number_of_spec_opr = staffing[s].spec;
+                args.config.length_gen_queue = staffing[s].queue;
+                args.config.arrival_rate = rates_per_hour[r] / 3600.0;
+                args.n_events = ctx->macro_samples;
+
+                double t = best_of(ctx, call_center_once, &args);
+
+                snprintf(params, sizeof(params), "\"gen\": %d, \"spec\": %d, \"queue\": %d, \"arrival_rate_per_hour\": %.0f",
+                         staffing[s].gen, staffing[s].spec, staffing[s].queue, rates_per_hour[r]);
+                emit_result(ctx, "macro", engines[e].name, params, "arrival", args.n_events, t);
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    bench_ctx ctx = {stdout, 0, 3, 2000000, 200000};
+    const char *output_path = NULL;
+    int quick = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = 1;
+            ctx.repetitions = 1;
+            ctx.micro_ops = 200000;
+            ctx.macro_samples = 20000;
+        } else if (output_path == NULL) {
+            output_path = argv[i];
+        } else {
+            fprintf(stderr, "Usage: %s [--quick] [output.json]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (output_path != NULL) {
+        ctx.out = fopen(output_path, "w");
+        if (ctx.out == NULL) {
+            fprintf(stderr, "Error: Could not open %s\n", output_path);
+            return 1;
+        }
+    }
+
+    char timestamp[32];
+    time_t now = time(NULL);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    fprintf(ctx.out, "{\n  \"timestamp\": \"%s\",\n  \"compiler\": \"%s\",\n  \"quick\": %s,\n"
+                     "  \"repetitions\": %d,\n  \"seed\": %d,\n  \"results\": [",
+            timestamp, __VERSION__, quick ? "true" : "false", ctx.repetitions, BENCH_SEED);
+
+    fprintf(stderr, "Micro benchmarks (best of %d):\n", ctx.repetitions);
+    run_micro(&ctx);
+    fprintf(stderr, "Macro benchmarks (best of %d):\n", ctx.repetitions);
+    run_macro(&ctx);
+
+    fprintf(ctx.out, "\n  ]\n}\n");
+
+    if (ctx.out != stdout) {
+        fclose(ctx.out);
+        fprintf(stderr, "Results saved to %s\n", output_path);
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../call_center/call_center.h"
+#include "../call_center/call_center_specialized.h"
+#include "../config/config.h"
+#include "bench_util.h"
+
+// Generic vs compile-time specialized start_call_center on the frozen scenario.
+// Usage: ./bench_specialized [events] [repetitions]
+
+#define BENCH_SEED 42
+
+typedef call_center_stats (*engine_fn)(call_center_config config, int number_of_events);
+
+// Best-of-N wall time, so one-off scheduler noise does not skew the ratio
+static double time_engine(engine_fn engine, call_center_config config, int events, int repetitions, call_center_stats *last) {
+    double best = 1e30;
+    for (int r = 0; r < repetitions; r++) {
+        rng_seed(BENCH_SEED);
+        double start = now_seconds();
+        call_center_stats stats = engine(config, events);
+        double elapsed = now_seconds() - start;
+
+        if (elapsed < best) {
+            best = elapsed;
+        }
+        if (r + 1 < repetitions) {
+            free_call_center_stats(&stats);
+        } else {
+            *last = stats;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    int events = (argc > 1) ? atoi(argv[1]) : 200000;
+    int repetitions = (argc > 2) ? atoi(argv[2]) : 5;
+
+    if (events <= 0 || repetitions <= 0) {
+        fprintf(stderr, "Usage: %s [events] [repetitions]\n", argv[0]);
+        return 1;
+    }
+
+    scenario_config scenario;
+    default_scenario_config(&scenario);
+
+    // Run the generic engine on exactly the frozen scenario. A single-tier
+    // variant is compared against the generic engine with every call generic-only.
+    int tiers = 2;
+    sscanf(call_center_specialized_name(), "gen=%d spec=%d queue=%d tiers=%d",
+           &scenario.call_center.number_of_gen_opr,
+           &scenario.call_center.number_of_spec_opr,
+           &scenario.call_center.length_gen_queue,
+           &tiers);
+    if (tiers == 1) {
+        scenario.call_center.general_purpose_ratio = 1.0;
+    }
+    call_center_config config = scenario.call_center;
+
+    call_center_stats generic_stats, specialized_stats;
+    double generic_s = time_engine(start_call_center, config, events, repetitions, &generic_stats);
+    double specialized_s = time_engine(start_call_center_specialized, config, events, repetitions, &specialized_stats);
+
+    bool identical = call_center_specialized_matches(config) &&
+                     generic_stats.general_p_stats.prob_call_delayed == specialized_stats.general_p_stats.prob_call_delayed &&
+                     generic_stats.general_p_stats.prob_call_lost == specialized_stats.general_p_stats.prob_call_lost &&
+                     generic_stats.general_p_stats.avg_delay_of_calls == specialized_stats.general_p_stats.avg_delay_of_calls &&
+                     generic_stats.area_spec_stats.avg_answ_time == specialized_stats.area_spec_stats.avg_answ_time;
+
+    printf("Specialized scenario: %s\n", call_center_specialized_name());
+    printf("Events: %d, best of %d runs\n\n", events, repetitions);
+    printf("  generic:     %8.3f s  (%7.1f ns/event)\n", generic_s, 1e9 * generic_s / events);
+    printf("  specialized: %8.3f s  (%7.1f ns/event)\n", specialized_s, 1e9 * specialized_s / events);
+    printf("  speedup:     %8.3fx\n", generic_s / specialized_s);
+    if (call_center_specialized_matches(config)) {
+        printf("  identical results: %s\n", identical ? "yes" : "no");
+    } else {
+        printf("  identical results: n/a (single-tier variant skips the call-type draw)\n");
+    }
+
+    free_call_center_stats(&generic_stats);
+    free_call_center_stats(&specialized_stats);
+
+    return identical || !call_center_specialized_matches(config) ? 0 : 1;
+}
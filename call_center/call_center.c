@@ -1,317 +1,275 @@
 #include "call_center.h"
-
-bool is_general_call(double gen_purpose_prob) {
-    double u = (double)rand() / (double)RAND_MAX;
-
-    return u <= gen_purpose_prob;
-}
+#include "call_center_draws.h"
+
+// Generic engine: every parameter is read from the runtime config
+#define CC_VARIANT generic
+#define CC_HAS_SPECIFIC_TIER 1
+#define CC_NUM_GEN_OPR (config.number_of_gen_opr)
+#define CC_NUM_SPEC_OPR (config.number_of_spec_opr)
+#define CC_LENGTH_GEN_QUEUE (config.length_gen_queue)
+#define CC_ARRIVAL_RATE (config.arrival_rate)
+#define CC_GENERAL_PURPOSE_RATIO (config.general_purpose_ratio)
+#define CC_GEN_MIN_DURATION_S (config.general_p_config->gen_call_gen_only_config->gen_min_duration_s)
+#define CC_GEN_AVG_DURATION_S (config.general_p_config->gen_call_gen_only_config->gen_avg_duration_s)
+#define CC_GEN_MAX_DURATION_S (config.general_p_config->gen_call_gen_only_config->gen_max_duration_s)
+#define CC_SPEC_MIN_DURATION_S (config.general_p_config->gen_call_specific_config->spec_min_duration_s)
+#define CC_SPEC_AVG_DURATION_S (config.general_p_config->gen_call_specific_config->spec_avg_duration_s)
+#define CC_SPEC_STD_DURATION_S (config.general_p_config->gen_call_specific_config->spec_std_duration_s)
+#define CC_SPEC_MAX_DURATION_S (config.general_p_config->gen_call_specific_config->spec_max_duration_s)
+#define CC_AREA_SPEC_MIN_DURATION_S (config.area_spec_config->min_duration_s)
+#define CC_AREA_SPEC_AVG_DURATION_S (config.area_spec_config->avg_duration_s)
+#define CC_GEN_PATIENCE_AVG_S (config.gen_patience_avg_s)
+#define CC_SPEC_PATIENCE_AVG_S (config.spec_patience_avg_s)
+#define CC_PRIORITY_CLASSES (config.priority_classes)
+#define CC_PRIORITY_SHARES (config.priority_shares)
+#define CC_PREEMPTIVE (config.priority_preemptive)
+#define CC_ARRIVAL_PROCESS (call_center_has_arrival_process(config))
+#define CC_GENERAL_SERVICE (call_center_has_general_service(config))
+#include "call_center_engine.h"
 
 double box_muller() {
-    double u1 = (double)rand() / (double)RAND_MAX;
-    double u2 = (double)rand() / (double)RAND_MAX;
-
-    double theta = 2 * u1 * M_PI;
-    double r = sqrt(-2 * log(u2));
-
-    return r * cos(theta);
+    return standard_normal();
 }
 
-double generate_general_purpose_area_specific_duration(generic_call_specific_config config) {
-    double duration = 0.0;
-
-    while (duration < config.spec_min_duration_s) {
-        double rv = box_muller();
-        duration = rv * config.spec_std_duration_s + config.spec_avg_duration_s;
-    }
-
-    return (duration > config.spec_max_duration_s) ? config.spec_max_duration_s : duration;
+call_center_stats start_call_center(call_center_config config, int number_of_events) {
+    return run_call_center_generic(config, number_of_events);
 }
 
-
-double generate_exponential_duration(double min, double avg, bool has_max, double max) {
-    double duration = min + next_poisson(avg);
-
-    if (has_max) {
-        return (duration > max) ? max : duration;
-    }
-
-    return duration;
+void init_call_center_state(call_center_config config, call_center_state *state) {
+    init_call_center_state_generic(config, state);
 }
 
-double generate_general_purpose_duration(general_purpose_config config, CALL_TYPE type) {
-    switch (type) {
-    case GENERAL_PURPOSE:
-        return generate_exponential_duration(
-            config.gen_call_gen_only_config->gen_min_duration_s,
-            config.gen_call_gen_only_config->gen_avg_duration_s,
-            true,
-            config.gen_call_gen_only_config->gen_max_duration_s);
-    case AREA_SPECIFIC:
-        return generate_general_purpose_area_specific_duration(*config.gen_call_specific_config);
-    default:
-        return 0.0;
-    }
+void advance_call_center(call_center_config config, call_center_state *state, int64_t number_of_events) {
+    advance_call_center_generic(config, state, number_of_events);
 }
 
-double generate_specific_duration(area_specific_config config) {
-    return generate_exponential_duration(
-        config.min_duration_s,
-        config.avg_duration_s,
-        false,
-        0);
+void run_specific_tier(call_center_config config, call_center_state *state, call_center_channel *channel) {
+    run_specific_tier_generic(config, state, channel);
 }
 
-double running_avg(int n, double old_avg, double sample) {
-    return (old_avg * ((n - 1.0) / n)) + (sample * (1.0 / n));
+// The specialist tier is charged at its own events only; this charges it up to
+// the clock, the time of the last general event
+static void catch_up_specific_tier(call_center_state *state) {
+    double now = state->gen_busy_avg.last_time;
+    time_average_advance(&state->spec_busy_avg, now, state->counters.specific_opr_busy);
+    time_average_advance(&state->spec_queue_avg, now, state->counters.in_queue_specific_call);
 }
 
-void handle_general_call_arrival(
-    call_center_config config,
-    int *general_opr_busy,
-    int *in_queue_general_call,
-    int *blocked_general_call,
-    int *delayed_general_call,
-    call_list **event_list,
-    call_list **general_waiting_queue,
-    double avg_gen_waiting_time
-) {
-    if ((*general_opr_busy) < config.number_of_gen_opr) {
-        // I have capacity lets process it
-        (*general_opr_busy)++;
-
-        CALL_TYPE type = (*event_list)->c.gen_call.is_generic_only ? GENERAL_PURPOSE : AREA_SPECIFIC;
-
-        double duration = generate_general_purpose_duration(*config.general_p_config, type); // Generate duration based on call type
-
-        call new_call = (*event_list)->c;
-        
-        new_call.gen_call.answer_time = (*event_list)->time;
-
-        *event_list = _add(*event_list, DEPARTURE, (*event_list)->time + duration, new_call);
-
-    } else {
-        // I dont have capacity to process now
-        if ((*in_queue_general_call) < config.length_gen_queue) {
-            // Queue still has space
-            (*delayed_general_call)++;
-
-            call new_call = (*event_list)->c;
-            
-            new_call.gen_call.answer_time = 0.0;
-            new_call.gen_call.prediction_waiting = (*in_queue_general_call) * avg_gen_waiting_time;
-            new_call.gen_call.original_arrival_time = (*event_list)->time;
-
-            (*in_queue_general_call)++;
-            (*general_waiting_queue) = _add(*general_waiting_queue, ARRIVAL, (*event_list)->time, new_call);
+// Every stored time lies within a few service and patience times of the clock,
+// which has just passed CALL_CENTER_EPOCH_S, so each subtraction is exact
+void rebase_call_center_time(call_list *event_list, class_queue *general_waiting_queue,
+                             class_queue *specific_waiting_queue, event_set *patience_timers,
+                             call_center_in_service *in_service, time_average *averages[4]) {
+    const double shift = CALL_CENTER_EPOCH_S;
+    for (call_list *p = event_list; p != NULL; p = p->next) {
+        p->time -= shift;
+        p->c.gen_call.answer_time -= shift;
+        p->c.gen_call.original_arrival_time -= shift;
+        p->c.gen_call.service_start -= shift;
+    }
+    class_queue *queues[2] = {general_waiting_queue, specific_waiting_queue};
+    for (int q = 0; q < 2; q++) {
+        for (int k = 0; k < queues[q]->n_classes; k++) {
+            for (uint32_t i = 0; i < class_queue_class_size(queues[q], k); i++) {
+                call_list *p = class_queue_at(queues[q], k, i);
+                p->time -= shift;
+                p->c.gen_call.answer_time -= shift;
+                p->c.gen_call.original_arrival_time -= shift;
+                p->c.gen_call.service_start -= shift;
+            }
         }
-        else {
-            // If queue is full, call is blocked
-            (*blocked_general_call)++;
+    }
+    event_set_shift(patience_timers, -shift);
+    for (int t = 0; t < 2; t++) {
+        for (int k = 0; k < CALL_CENTER_MAX_PRIORITY_CLASSES; k++) {
+            event_set_shift(&in_service->calls[t][k], shift);
         }
     }
+    for (int i = 0; i < 4; i++) {
+        averages[i]->start_time -= shift;
+        averages[i]->last_time -= shift;
+    }
 }
 
-void handle_specific_call_arrival(
-    call_center_config config,
-    int *specific_opr_busy,
-    call_list **event_list,
-    call_list **specific_waiting_queue,
-    double *total_elapsed_time_between_gen,
-    double *total_specific,
-    call arriving_call,      
-    double current_time      
-) {
-    if ((*specific_opr_busy) < config.number_of_spec_opr) {
-        double duration = generate_specific_duration(*config.area_spec_config);
-
-        call new_call;
-        new_call.type = AREA_SPECIFIC;
-        new_call.gen_call = arriving_call.gen_call;
-
-        // Calculate time from ORIGINAL arrival to general system until now (answered by area-specific)
-        (*total_elapsed_time_between_gen) += current_time - arriving_call.gen_call.original_arrival_time;
-        (*total_specific)++;
-
-        (*specific_opr_busy)++;
-        *event_list = _add(
-            *event_list,
-            DEPARTURE,
-            current_time + duration,
-            new_call);
-    } else {
-        // If I dont have capacity, put in infinite waiting queue
-        call new_call;
-        new_call.type = AREA_SPECIFIC;
-        new_call.gen_call = arriving_call.gen_call;
-        
-        *specific_waiting_queue = _add(
-            *specific_waiting_queue,
-            ARRIVAL,
-            current_time,
-            new_call);
+void init_call_center_in_service(call_center_in_service *in_service, call_center_config config) {
+    memset(in_service, 0, sizeof(*in_service));
+    if (!call_center_has_preemption(config)) {
+        return;
+    }
+    for (int k = 0; k < config.priority_classes; k++) {
+        init_event_set(&in_service->calls[GENERAL_PURPOSE][k], config.number_of_gen_opr);
+        init_event_set(&in_service->calls[AREA_SPECIFIC][k], config.number_of_spec_opr);
     }
 }
 
-call_center_stats start_call_center(call_center_config config, int number_of_events) {
-    int general_opr_busy = 0;
-    int specific_opr_busy = 0;
-    int in_queue_general_call = 0;
-    int blocked_general_call = 0;
-    int delayed_general_call = 0;
-    int general_arrivals = 0;  
-    double avg_gen_waiting_time = 0.0;
-    int current_gen_waiting_calls = 0;
-
-    double total_elapsed_time_between_gen = 0.0;
-    double total_specific = 0.0;
-
-    call_list *event_list = NULL;
-    call_list *general_waiting_queue = NULL;
-    call_list *specific_waiting_queue = NULL;
-
-    delay_array delays;
-    init_delay_array(&delays);
-
-    bool is_generic_only = is_general_call(config.general_purpose_ratio);
-
-    struct call c;
-    
-    c.type = GENERAL_PURPOSE;
-    struct general_call gen_call = {is_generic_only, 0.0, 0.0, 0.0};
-    c.gen_call = gen_call;
-
-    event_list = _add(event_list, ARRIVAL, 0.0, c);
-
-    while (general_arrivals < number_of_events) {
-        // Arrival or Departure?
-        if (event_list->type == ARRIVAL) {
-            // Only General Calls Arrive via the event list
-            general_arrivals++; 
-            handle_general_call_arrival(
-                config,
-                &general_opr_busy,
-                &in_queue_general_call,
-                &blocked_general_call,
-                &delayed_general_call,
-                &event_list,
-                &general_waiting_queue,
-                avg_gen_waiting_time
-            );
-            
-            is_generic_only = is_general_call(config.general_purpose_ratio);
-
-            double tmp = next_poisson(1.0 / config.arrival_rate);
-
-            c.type = GENERAL_PURPOSE; // Generate new general purpose call 
-            struct general_call gen_call = {is_generic_only, 0.0, 0.0, event_list->time + tmp};
-            c.gen_call = gen_call;
-
-            event_list = _add(event_list, ARRIVAL, event_list->time + tmp, c);
-        } else if (event_list->type == DEPARTURE) {
-            if (event_list->c.type == AREA_SPECIFIC) {
-                if (specific_waiting_queue != NULL) {
-                    double duration = generate_specific_duration(*config.area_spec_config);
-
-                    // Calculate time from ORIGINAL arrival to general system until now
-                    total_elapsed_time_between_gen += event_list->time - specific_waiting_queue->c.gen_call.original_arrival_time;
-                    total_specific++;
-
-                    call new_call = specific_waiting_queue->c;
-
-                    event_list = _add(event_list, DEPARTURE, event_list->time + duration, new_call);
-
-                    specific_waiting_queue = _remove(specific_waiting_queue);
-                } else {
-                    specific_opr_busy--;
-                }
-            } else if (event_list->c.type == GENERAL_PURPOSE) {
-                // Process next call in queue if any
-                bool departing_call_needs_specific = !event_list->c.gen_call.is_generic_only;
-                call departing_call = event_list->c;
-                double current_time = event_list->time;
-
-                if (general_waiting_queue != NULL)
-                {
-                    CALL_TYPE type = general_waiting_queue->c.gen_call.is_generic_only ? GENERAL_PURPOSE : AREA_SPECIFIC;
-
-                    double duration = generate_general_purpose_duration(*config.general_p_config, type);
-
-                    // Calculate actual waiting time
-                    double waiting_time = event_list->time - general_waiting_queue->time;
-
-                    avg_gen_waiting_time = running_avg(++current_gen_waiting_calls, avg_gen_waiting_time, waiting_time);
-
-                    // Store prediction vs actual for statistics
-                    delay d = {general_waiting_queue->c.gen_call.prediction_waiting, waiting_time};
-                    add_delay(&delays, d);
-
-                    // Mark when this call was answered by general operator
-                    general_waiting_queue->c.gen_call.answer_time = event_list->time;
-
-                    event_list = _add(event_list, DEPARTURE, event_list->time + duration, general_waiting_queue->c);
-                    general_waiting_queue = _remove(general_waiting_queue);
-                    in_queue_general_call--;
-                }
-                else
-                {
-                    general_opr_busy--;
-                }
-                if (departing_call_needs_specific) {
-                    handle_specific_call_arrival(
-                        config,
-                        &specific_opr_busy,
-                        &event_list,
-                        &specific_waiting_queue,
-                        &total_elapsed_time_between_gen,
-                        &total_specific,
-                        departing_call,
-                        current_time
-                    );
-                }
-            }
+void index_call_center_in_service(call_center_in_service *in_service, call_list *event_list) {
+    for (call_list *p = event_list; p != NULL; p = p->next) {
+        if (p->type == DEPARTURE && !p->c.abandoned) {
+            p->c.patience_timer = event_set_schedule(&in_service->calls[p->c.type][p->c.priority], -p->time, p);
         }
-        event_list = _remove(event_list);
     }
+}
 
-
-    double prob_delay = (double)delayed_general_call / (double)general_arrivals;
-    double prob_blocked = (double)blocked_general_call / (double)general_arrivals;
-
-    double total_actual_delay = 0.0;
-    double total_abs_pred_error = 0.0;
-    double total_rel_pred_error = 0.0;
-
-
-    for (int i = 0; i < delays.size; i++) {
-        total_actual_delay += delays.data[i].actual;
-        total_abs_pred_error += fabs(delays.data[i].predicted - delays.data[i].actual);
-        total_rel_pred_error += fabs(delays.data[i].predicted - delays.data[i].actual) / fabs(delays.data[i].actual);
+void free_call_center_in_service(call_center_in_service *in_service) {
+    for (int t = 0; t < 2; t++) {
+        for (int k = 0; k < CALL_CENTER_MAX_PRIORITY_CLASSES; k++) {
+            free_event_set(&in_service->calls[t][k]);
+        }
     }
+}
 
-    while (event_list != NULL) {
-        event_list = _remove(event_list);
+// Starts the statistics afresh from the current state, keeping calls in the
+// system (e.g. after a warm-up period); occupancy and queues are untouched
+void reset_call_center_statistics(call_center_state *state) {
+    call_center_counters *k = &state->counters;
+    k->blocked_general_call = 0;
+    k->delayed_general_call = 0;
+    k->abandoned_general_call = 0;
+    k->abandoned_specific_call = 0;
+    k->preempted_general_call = 0;
+    k->preempted_specific_call = 0;
+    memset(k->classes, 0, sizeof(k->classes));
+    k->general_arrivals = 0;
+    k->waits = 0;
+    k->wait_total = (compensated_sum){0.0, 0.0};
+    k->abs_prediction_error_total = (compensated_sum){0.0, 0.0};
+    k->rel_prediction_error_total = (compensated_sum){0.0, 0.0};
+    k->total_elapsed_time_between_gen = (compensated_sum){0.0, 0.0};
+    k->total_specific = 0;
+    k->interarrival_total = (compensated_sum){0.0, 0.0};
+    k->general_service_total = (compensated_sum){0.0, 0.0};
+    k->generic_only_calls = 0;
+    state->delays.size = 0;
+    hdr_histogram_reset(&state->delay_histogram);
+    catch_up_specific_tier(state);
+    time_average_reset(&state->gen_busy_avg);
+    time_average_reset(&state->gen_queue_avg);
+    time_average_reset(&state->spec_busy_avg);
+    time_average_reset(&state->spec_queue_avg);
+}
+
+void free_call_center_state(call_center_state *state) {
+    while (state->event_list != NULL) {
+        state->event_list = _remove(state->event_list);
     }
-    while (general_waiting_queue != NULL) {
-        general_waiting_queue = _remove(general_waiting_queue);
+    call_list *node;
+    while ((node = class_queue_pop(&state->general_waiting_queue)) != NULL) {
+        free(node);
     }
-    while (specific_waiting_queue != NULL) {
-        specific_waiting_queue = _remove(specific_waiting_queue);
+    while ((node = class_queue_pop(&state->specific_waiting_queue)) != NULL) {
+        free(node);
     }
+    free_class_queue(&state->general_waiting_queue);
+    free_class_queue(&state->specific_waiting_queue);
+    free_event_set(&state->patience_timers);
+    free_call_center_in_service(&state->in_service);
+    free_arrival_process(&state->arrivals);
+    free_delay_array(&state->delays);
+    free_hdr_histogram(&state->delay_histogram);
+    free_time_average(&state->gen_busy_avg);
+    free_time_average(&state->gen_queue_avg);
+    free_time_average(&state->spec_busy_avg);
+    free_time_average(&state->spec_queue_avg);
+}
+
+// Statistics of the run so far; frees the state
+call_center_stats finish_call_center(call_center_state *state) {
+    catch_up_specific_tier(state);
+    const call_center_counters *k = &state->counters;
+    const delay_array *delays = &state->delays;
+
+    double prob_delay = (double)k->delayed_general_call / (double)k->general_arrivals;
+    double prob_blocked = (double)k->blocked_general_call / (double)k->general_arrivals;
+    // Kept as running sums, so they hold in long-run mode where delays stays empty
+    double waits = (k->waits > 0) ? (double)k->waits : 1.0;
 
     call_center_stats result;
     general_purpose_stats general_result;
     general_result.prob_call_delayed = prob_delay;
     general_result.prob_call_lost = prob_blocked;
-    general_result.avg_delay_of_calls = (delays.size > 0) ? (total_actual_delay / delays.size) : 0.0;
-    general_result.avg_abs_prediction_error = (delays.size > 0) ? (total_abs_pred_error / delays.size) : 0.0;
-    general_result.avg_rel_prediction_error = (delays.size > 0) ? (total_rel_pred_error / delays.size) : 0.0;
-    general_result.delays = delays;
+    general_result.prob_call_abandoned = (double)k->abandoned_general_call / (double)k->general_arrivals;
+    general_result.prob_call_preempted = (double)k->preempted_general_call / (double)k->general_arrivals;
+    general_result.avg_delay_of_calls = compensated_value(&k->wait_total) / waits;
+    general_result.avg_abs_prediction_error = compensated_value(&k->abs_prediction_error_total) / waits;
+    general_result.avg_rel_prediction_error = compensated_value(&k->rel_prediction_error_total) / waits;
+    general_result.delays = *delays;
+    general_result.delay_histogram = state->delay_histogram;
+    general_result.avg_busy_operators = time_average_mean(&state->gen_busy_avg);
+    general_result.avg_queue_length = time_average_mean(&state->gen_queue_avg);
+    general_result.queue_length_distribution =
+        time_average_distribution(&state->gen_queue_avg, &general_result.queue_length_distribution_size);
+    general_result.mean_interarrival_time = compensated_value(&k->interarrival_total) / k->general_arrivals;
+    general_result.generic_only_fraction = (double)k->generic_only_calls / k->general_arrivals;
+    // Every admitted call except those still queued or abandoned has drawn its duration
+    int64_t general_started = k->general_arrivals - k->blocked_general_call - k->in_queue_general_call -
+                              k->abandoned_general_call;
+    general_result.mean_service_time =
+        (general_started > 0) ? compensated_value(&k->general_service_total) / general_started : 0.0;
 
     area_specific_stats specific_result;
-    specific_result.avg_answ_time = (total_specific > 0) ? (total_elapsed_time_between_gen / total_specific) : 0.0;
+    specific_result.avg_answ_time =
+        (k->total_specific > 0) ? compensated_value(&k->total_elapsed_time_between_gen) / k->total_specific : 0.0;
+    double specific_settled = (double)(k->total_specific + k->abandoned_specific_call);
+    specific_result.prob_call_abandoned = (specific_settled > 0) ? k->abandoned_specific_call / specific_settled : 0.0;
+    specific_result.prob_call_preempted =
+        (k->total_specific > 0) ? (double)k->preempted_specific_call / k->total_specific : 0.0;
+    specific_result.avg_busy_operators = time_average_mean(&state->spec_busy_avg);
+    specific_result.avg_queue_length = time_average_mean(&state->spec_queue_avg);
+    specific_result.queue_length_distribution =
+        time_average_distribution(&state->spec_queue_avg, &specific_result.queue_length_distribution_size);
+
+    result.n_priority_classes = state->general_waiting_queue.n_classes;
+    for (int i = 0; i < result.n_priority_classes; i++) {
+        const call_center_class_counters *cc = &k->classes[i];
+        call_center_class_stats *cs = &result.priority_classes[i];
+        double arrivals = (cc->arrivals > 0) ? (double)cc->arrivals : 1.0;
+        double specific_settled = (double)(cc->specific_answered + cc->specific_abandoned);
+        cs->share_of_arrivals = (double)cc->arrivals / k->general_arrivals;
+        cs->prob_call_delayed = cc->delayed / arrivals;
+        cs->prob_call_lost = cc->blocked / arrivals;
+        cs->prob_call_abandoned = cc->abandoned / arrivals;
+        cs->avg_delay_of_calls = (cc->waits > 0) ? compensated_value(&cc->wait_total) / cc->waits : 0.0;
+        cs->avg_answ_time =
+            (cc->specific_answered > 0) ? compensated_value(&cc->specific_elapsed_total) / cc->specific_answered : 0.0;
+        cs->prob_specific_abandoned = (specific_settled > 0) ? cc->specific_abandoned / specific_settled : 0.0;
+    }
+
+    // The delays now belong to the result
+    state->delays.data = NULL;
+    state->delays.size = state->delays.capacity = 0;
+    state->delay_histogram.counts = NULL;
+    free_call_center_state(state);
 
     result.general_p_stats = general_result;
     result.area_spec_stats = specific_result;
 
     return result;
-}
\ No newline at end of file
+}
+
+__thread trace_writer *call_center_trace = NULL;
+
+void free_call_center_stats(call_center_stats *stats) {
+    free_delay_array(&stats->general_p_stats.delays);
+    free_hdr_histogram(&stats->general_p_stats.delay_histogram);
+    free(stats->general_p_stats.queue_length_distribution);
+    free(stats->area_spec_stats.queue_length_distribution);
+    stats->general_p_stats.queue_length_distribution = NULL;
+    stats->area_spec_stats.queue_length_distribution = NULL;
+    stats->general_p_stats.queue_length_distribution_size = 0;
+    stats->area_spec_stats.queue_length_distribution_size = 0;
+}
+
+// Expected values of the control variates reported in general_purpose_stats
+void call_center_input_means(call_center_config config, double *mean_interarrival_time,
+                             double *generic_only_fraction, double *mean_service_time) {
+    const generic_call_gen_only_config *gen = config.general_p_config->gen_call_gen_only_config;
+    const generic_call_specific_config *spec = config.general_p_config->gen_call_specific_config;
+    double p = config.general_purpose_ratio;
+
+    *mean_interarrival_time = 1.0 / config.arrival_rate;
+    *generic_only_fraction = p;
+    *mean_service_time =
+        p * expected_exponential_duration(gen->gen_min_duration_s, gen->gen_avg_duration_s, true, gen->gen_max_duration_s) +
+        (1.0 - p) * expected_truncated_normal_duration(spec->spec_min_duration_s, spec->spec_avg_duration_s,
+                                                       spec->spec_std_duration_s, spec->spec_max_duration_s);
+}
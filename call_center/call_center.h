@@ -2,16 +2,41 @@
 #define CALL_CENTER_H
 
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include "../poisson/poisson.h"
+#include "../models/arrival_process.h"
+#include "../models/class_queue.h"
+#include "../models/compensated_sum.h"
 #include "../models/delay_array.h"
+#include "../models/event_set.h"
+#include "../models/hdr_histogram.h"
+#include "../models/service_dist.h"
 #include "../models/linked_list_call.h"
+#include "../models/time_average.h"
+#include "../models/trace_writer.h"
+#include "../models/wait_predictor.h"
 
 #ifndef M_PI
 #    define M_PI 3.14159265358979323846
 #endif
 
+// Part of every stored-result key; bump when an engine's output for a given
+// configuration and seed changes, so older stored results are no longer used
+#define CALL_CENTER_RESULTS_VERSION 5
+
+// Layout of the delay histograms, shared by every engine so they can be merged
+#define CALL_CENTER_DELAY_RESOLUTION_S 0.001
+#define CALL_CENTER_DELAY_HIGHEST_S 1e7
+
+#define CALL_CENTER_MAX_PRIORITY_CLASSES 8
+
+// Simulated time is kept relative to an epoch that moves forward by this much
+// whenever the clock passes it, so timestamps keep sub-microsecond resolution
+// however long the run. A power of two: rebasing subtracts exactly.
+#define CALL_CENTER_EPOCH_S 16777216.0
+
 // ------------------- INPUT MODELS ------------------- //
 typedef struct {
     double gen_min_duration_s;
@@ -44,6 +69,25 @@ typedef struct {
     double general_purpose_ratio;
     general_purpose_config *general_p_config;
     area_specific_config *area_spec_config;
+    wait_predictor_kind wait_predictor;  // Estimate stored with each queued general call
+    // Mean (exponential) patience of a queued caller before hanging up; 0: callers never abandon
+    double gen_patience_avg_s;
+    double spec_patience_avg_s;
+    // Priority classes share both queues, class 0 being served first; 1 keeps a single FIFO per tier
+    int priority_classes;
+    int priority_preemptive;            // Higher classes interrupt lower ones in service (preemptive-resume)
+    double priority_shares[CALL_CENTER_MAX_PRIORITY_CLASSES];  // Fraction of arrivals in each class
+    const arrival_config *arrival_config;  // NULL or ARRIVAL_POISSON: Poisson arrivals at arrival_rate
+    // Law of the specialist service time above its minimum (mean area avg_duration_s); NULL: exponential
+    const service_dist *area_service;
+    // Long-run mode (event engine): per-call delays are not kept, only their
+    // histogram and running sums, so memory stays flat over billions of calls
+    bool long_run;
+    // The specialist tier draws from its own stream (counters.specific_stream)
+    // instead of sharing the caller's, so the tiers can run as parallel logical
+    // processes with the same results (call_center_pdes.h). Only --engine pdes
+    // and the sequential run ./main pdes compares it with set it.
+    bool tier_streams;
 } call_center_config;
 
 // ------------------- OUTPUT MODELS ------------------- //
@@ -51,22 +95,185 @@ typedef struct {
 typedef struct {
     double prob_call_delayed;
     double prob_call_lost;
+    double prob_call_abandoned;         // Arrivals that hung up while queued
+    double prob_call_preempted;         // Interruptions of a call in service, per arrival
     double avg_delay_of_calls;
     double avg_abs_prediction_error;
     double avg_rel_prediction_error;
     delay_array delays;
+    hdr_histogram delay_histogram;      // Waits of the delayed calls, for percentiles
+    // Time-weighted occupancy over the simulated horizon
+    double avg_busy_operators;
+    double avg_queue_length;
+    double *queue_length_distribution;  // Fraction of time with k calls queued
+    int queue_length_distribution_size;
+    // Sample means of the random inputs; their expectations are known
+    // (call_center_input_means), so they serve as control variates
+    double mean_interarrival_time;
+    double generic_only_fraction;
+    double mean_service_time;
 } general_purpose_stats;
 
 typedef struct {
     double avg_answ_time;
+    double prob_call_abandoned;         // Calls handed to the tier that hung up while queued
+    double prob_call_preempted;         // Interruptions of a call in service, per call answered
+    // Time-weighted occupancy over the simulated horizon
+    double avg_busy_operators;
+    double avg_queue_length;
+    double *queue_length_distribution;  // Fraction of time with k calls queued
+    int queue_length_distribution_size;
 } area_specific_stats;
 
+// Outcome of one priority class, over both tiers
+typedef struct {
+    double share_of_arrivals;
+    double prob_call_delayed;
+    double prob_call_lost;
+    double prob_call_abandoned;
+    double avg_delay_of_calls;          // Waits of its delayed calls in the general tier
+    double avg_answ_time;               // General arrival to area-specific handling
+    double prob_specific_abandoned;
+} call_center_class_stats;
+
 typedef struct {
     general_purpose_stats general_p_stats;
     area_specific_stats area_spec_stats;
+    int n_priority_classes;             // 0 when the engine does not report classes
+    call_center_class_stats priority_classes[CALL_CENTER_MAX_PRIORITY_CLASSES];
 } call_center_stats;
 
+// ------------------- ENGINE STATE ------------------- //
+
+// Counters the event-list engine keeps per priority class
+typedef struct {
+    int64_t arrivals;
+    int64_t delayed;
+    int64_t blocked;
+    int64_t abandoned;
+    int64_t waits;                      // Delayed calls answered so far
+    compensated_sum wait_total;
+    int64_t specific_answered;
+    int64_t specific_abandoned;
+    compensated_sum specific_elapsed_total;
+} call_center_class_counters;
+
+// Scalar state of the event-list engine: occupancy, counters and accumulators.
+// Counters are 64-bit and sums compensated, so runs of billions of calls stay exact.
+typedef struct {
+    int general_opr_busy;
+    int specific_opr_busy;
+    int in_queue_general_call;
+    int in_queue_specific_call;
+    int64_t blocked_general_call;
+    int64_t delayed_general_call;
+    int64_t abandoned_general_call;
+    int64_t abandoned_specific_call;
+    int64_t preempted_general_call;
+    int64_t preempted_specific_call;
+    int64_t general_arrivals;
+    int64_t epochs;                     // Times the clock was rebased by CALL_CENTER_EPOCH_S
+    wait_predictor predictor;           // Fed with the general tier's events
+    // Answered waits of the general tier and the prediction errors made for them
+    int64_t waits;
+    compensated_sum wait_total;
+    compensated_sum abs_prediction_error_total;
+    compensated_sum rel_prediction_error_total;
+    compensated_sum total_elapsed_time_between_gen;
+    int64_t total_specific;
+    compensated_sum interarrival_total;
+    compensated_sum general_service_total;
+    int64_t generic_only_calls;
+    call_center_class_counters classes[CALL_CENTER_MAX_PRIORITY_CLASSES];
+    rng_state specific_stream;          // Draws of the specialist tier when config.tier_streams
+} call_center_counters;
+
+// Calls in service by tier (CALL_TYPE) and class, keyed by minus their
+// departure time, with their event list node as data and its handle in the
+// node's patience_timer. A preemption pops the victim in O(log n) and leaves
+// its departure in the list as an abandoned tombstone. Preemptive runs only.
+typedef struct {
+    event_set calls[2][CALL_CENTER_MAX_PRIORITY_CLASSES];
+} call_center_in_service;
+
+// Everything the event-list engine carries between two events, apart from the
+// calling thread's RNG stream (see call_center_snapshot.h)
+typedef struct {
+    call_center_counters counters;
+    call_list *event_list;
+    class_queue general_waiting_queue;  // Queued calls (call_list nodes) by priority class
+    class_queue specific_waiting_queue;
+    event_set patience_timers;          // Deadlines of queued calls, data = their queue node
+    call_center_in_service in_service;
+    arrival_process arrivals;           // Buffered gaps of a non-Poisson arrival process
+    delay_array delays;
+    hdr_histogram delay_histogram;      // Same waits as delays, rebuilt from them on restore
+    time_average gen_busy_avg;
+    time_average gen_queue_avg;
+    time_average spec_busy_avg;
+    time_average spec_queue_avg;
+} call_center_state;
+
+// While set, every waited-for general call is also streamed as (actual, predicted)
+// delay to this writer as it is answered (per thread; NULL disables)
+extern __thread trace_writer *call_center_trace;
+
+static inline void call_center_trace_delay(delay d) {
+    if (call_center_trace != NULL) {
+        double row[2] = {d.actual, d.predicted};
+        trace_writer_push(call_center_trace, row);
+    }
+}
+
+// Queued callers hang up in this configuration (event engine only)
+static inline bool call_center_has_patience(call_center_config config) {
+    return config.gen_patience_avg_s > 0.0 || config.spec_patience_avg_s > 0.0;
+}
+
+// Arrivals follow an MMPP, batch or renewal process rather than Poisson (event engine only)
+static inline bool call_center_has_arrival_process(call_center_config config) {
+    return config.arrival_config != NULL && config.arrival_config->kind != ARRIVAL_POISSON;
+}
+
+// Specialist service times follow a general law instead of min + exponential
+static inline bool call_center_has_general_service(call_center_config config) {
+    return service_dist_is_general(config.area_service);
+}
+
+// Arrivals are split into priority classes (event engine only)
+static inline bool call_center_has_priorities(call_center_config config) {
+    return config.priority_classes > 1;
+}
+
+static inline bool call_center_has_preemption(call_center_config config) {
+    return call_center_has_priorities(config) && config.priority_preemptive;
+}
+
+static inline void init_call_center_delay_histogram(hdr_histogram *h) {
+    init_hdr_histogram(h, CALL_CENTER_DELAY_RESOLUTION_S, CALL_CENTER_DELAY_HIGHEST_S, HDR_DEFAULT_BITS);
+}
+
 call_center_stats start_call_center(call_center_config config, int number_of_events);
+
+// Resumable form of start_call_center: init, advance (repeatedly), finish
+void init_call_center_state(call_center_config config, call_center_state *state);
+// Runs until number_of_events general arrivals have been counted in total
+void advance_call_center(call_center_config config, call_center_state *state, int64_t number_of_events);
+// Moves every timestamp of the state back by CALL_CENTER_EPOCH_S
+void rebase_call_center_time(call_list *event_list, class_queue *general_waiting_queue,
+                             class_queue *specific_waiting_queue, event_set *patience_timers,
+                             call_center_in_service *in_service, time_average *averages[4]);
+// Empty index, allocated only when the configuration is preemptive
+void init_call_center_in_service(call_center_in_service *in_service, call_center_config config);
+// Indexes every departure of a restored event list
+void index_call_center_in_service(call_center_in_service *in_service, call_list *event_list);
+void free_call_center_in_service(call_center_in_service *in_service);
+void reset_call_center_statistics(call_center_state *state);
+call_center_stats finish_call_center(call_center_state *state);
+void free_call_center_state(call_center_state *state);
+void free_call_center_stats(call_center_stats *stats);
+void call_center_input_means(call_center_config config, double *mean_interarrival_time,
+                             double *generic_only_fraction, double *mean_service_time);
 double box_muller();
 
 #endif // CALL_CENTER_H
\ No newline at end of file
@@ -0,0 +1,407 @@
+#include <string.h>
+#include "call_center_ctmc.h"
+#include "call_center_draws.h"
+#include "../models/profiling.h"
+
+// Sparse generator stored by destination, which is the access pattern of Gauss-Seidel:
+// pi[k] = sum(pi[src] * rate over edges into k) / out_rate[k]
+typedef struct {
+    int n_states;
+    int *in_start;      // Edges into k are in_start[k] .. in_start[k + 1] - 1
+    int *in_src;
+    double *in_rate;
+    double *out_rate;
+    // Transitions collected before compression
+    int *from, *to;
+    double *rate;
+    int n_edges, edge_capacity;
+} sparse_generator;
+
+static void *ctmc_alloc(size_t bytes) {
+    void *p = malloc(bytes);
+    PROF_ALLOC();
+    if (!p) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+static void add_transition(sparse_generator *q, int from, int to, double rate) {
+    if (rate <= 0.0 || from == to) {
+        return;
+    }
+    if (q->n_edges == q->edge_capacity) {
+        q->edge_capacity *= 2;
+        q->from = realloc(q->from, q->edge_capacity * sizeof(int));
+        q->to = realloc(q->to, q->edge_capacity * sizeof(int));
+        q->rate = realloc(q->rate, q->edge_capacity * sizeof(double));
+        if (!q->from || !q->to || !q->rate) {
+            perror("realloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+    q->from[q->n_edges] = from;
+    q->to[q->n_edges] = to;
+    q->rate[q->n_edges] = rate;
+    q->n_edges++;
+    q->out_rate[from] += rate;
+}
+
+static void compress_generator(sparse_generator *q) {
+    q->in_start = calloc(q->n_states + 1, sizeof(int));
+    q->in_src = ctmc_alloc(q->n_edges * sizeof(int));
+    q->in_rate = ctmc_alloc(q->n_edges * sizeof(double));
+    if (!q->in_start) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int e = 0; e < q->n_edges; e++) {
+        q->in_start[q->to[e] + 1]++;
+    }
+    for (int k = 0; k < q->n_states; k++) {
+        q->in_start[k + 1] += q->in_start[k];
+    }
+    int *fill = ctmc_alloc(q->n_states * sizeof(int));
+    memcpy(fill, q->in_start, q->n_states * sizeof(int));
+    for (int e = 0; e < q->n_edges; e++) {
+        int slot = fill[q->to[e]]++;
+        q->in_src[slot] = q->from[e];
+        q->in_rate[slot] = q->rate[e];
+    }
+    free(fill);
+
+    free(q->from);
+    free(q->to);
+    free(q->rate);
+    q->from = q->to = NULL;
+    q->rate = NULL;
+}
+
+static void free_generator(sparse_generator *q) {
+    free(q->in_start);
+    free(q->in_src);
+    free(q->in_rate);
+    free(q->out_rate);
+}
+
+// Over-relaxed Gauss-Seidel sweeps from the initial guess in pi, renormalizing after each, until no
+// state changes by more than the tolerance (relative to the largest probability).
+// Returns the number of sweeps.
+static int gauss_seidel(const sparse_generator *q, double *pi, double *residual) {
+    int sweep;
+    *residual = 1.0;
+    for (sweep = 1; sweep <= CTMC_MAX_SWEEPS && *residual > CTMC_TOLERANCE; sweep++) {
+        double max_change = 0.0, max_pi = 0.0, sum = 0.0;
+
+        for (int k = 0; k < q->n_states; k++) {
+            if (q->out_rate[k] <= 0.0) {
+                continue;
+            }
+            double inflow = 0.0;
+            for (int e = q->in_start[k]; e < q->in_start[k + 1]; e++) {
+                inflow += pi[q->in_src[e]] * q->in_rate[e];
+            }
+            double updated = (1.0 - CTMC_RELAXATION) * pi[k] + CTMC_RELAXATION * inflow / q->out_rate[k];
+            double change = fabs(updated - pi[k]);
+            max_change = (change > max_change) ? change : max_change;
+            max_pi = (updated > max_pi) ? updated : max_pi;
+            pi[k] = updated;
+            sum += updated;
+        }
+
+        for (int k = 0; k < q->n_states; k++) {
+            pi[k] /= sum;
+        }
+        *residual = (max_pi > 0.0) ? max_change / max_pi : 0.0;
+    }
+    return sweep - 1;
+}
+
+typedef struct {
+    int c, L, s;
+    double lambda, p;
+    double mu_generic, mu_spec_general, mu_specific;
+    double mean_spec_general;
+    // General-tier states (i generic-only in service, j specific-type in service, q queued);
+    // calls only queue once every operator is busy
+    int n_gen;
+    int *gen_id;
+    int *gi, *gj, *gq;
+} ctmc_model;
+
+#define GEN_STATE(m, i, j, q) (m)->gen_id[((i) * ((m)->c + 1) + (j)) * ((m)->L + 1) + (q)]
+// Specific count outermost so a Gauss-Seidel sweep follows the hand-over direction
+#define STATE(m, g, ns) ((ns) * (m)->n_gen + (g))
+
+static void init_ctmc_model(ctmc_model *m, call_center_config config) {
+    const generic_call_gen_only_config *gen = config.general_p_config->gen_call_gen_only_config;
+    const generic_call_specific_config *spec = config.general_p_config->gen_call_specific_config;
+
+    m->c = config.number_of_gen_opr;
+    m->L = config.length_gen_queue;
+    m->s = config.number_of_spec_opr;
+    m->lambda = config.arrival_rate;
+    m->p = config.general_purpose_ratio;
+    m->mean_spec_general = expected_truncated_normal_duration(spec->spec_min_duration_s, spec->spec_avg_duration_s,
+                                                              spec->spec_std_duration_s, spec->spec_max_duration_s);
+    m->mu_generic = 1.0 / expected_exponential_duration(gen->gen_min_duration_s, gen->gen_avg_duration_s,
+                                                        true, gen->gen_max_duration_s);
+    m->mu_spec_general = 1.0 / m->mean_spec_general;
+    m->mu_specific = 1.0 / expected_exponential_duration(config.area_spec_config->min_duration_s,
+                                                         config.area_spec_config->avg_duration_s, false, 0);
+
+    const int c = m->c, L = m->L;
+    const int max_gen = (c + 1) * (c + 2) / 2 + (c + 1) * L;
+    m->gen_id = ctmc_alloc((c + 1) * (c + 1) * (L + 1) * sizeof(int));
+    m->gi = ctmc_alloc(max_gen * sizeof(int));
+    m->gj = ctmc_alloc(max_gen * sizeof(int));
+    m->gq = ctmc_alloc(max_gen * sizeof(int));
+    for (int k = 0; k < (c + 1) * (c + 1) * (L + 1); k++) {
+        m->gen_id[k] = -1;
+    }
+
+    m->n_gen = 0;
+    for (int i = 0; i <= c; i++) {
+        for (int j = 0; i + j <= c; j++) {
+            for (int q = 0; q <= ((i + j == c) ? L : 0); q++) {
+                GEN_STATE(m, i, j, q) = m->n_gen;
+                m->gi[m->n_gen] = i;
+                m->gj[m->n_gen] = j;
+                m->gq[m->n_gen] = q;
+                m->n_gen++;
+            }
+        }
+    }
+}
+
+static void free_ctmc_model(ctmc_model *m) {
+    free(m->gen_id);
+    free(m->gi);
+    free(m->gj);
+    free(m->gq);
+}
+
+// Generator of the chain whose specific tier holds at most S calls. With S = 0
+// hand-overs are dropped and the chain reduces to the general tier alone.
+static void build_generator(const ctmc_model *m, int S, sparse_generator *q) {
+    const int c = m->c, L = m->L;
+    const double lambda = m->lambda, p = m->p;
+
+    q->n_states = m->n_gen * (S + 1);
+    q->out_rate = calloc(q->n_states, sizeof(double));
+    q->edge_capacity = 8 * q->n_states;
+    q->n_edges = 0;
+    q->from = ctmc_alloc(q->edge_capacity * sizeof(int));
+    q->to = ctmc_alloc(q->edge_capacity * sizeof(int));
+    q->rate = ctmc_alloc(q->edge_capacity * sizeof(double));
+    if (!q->out_rate) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int ns = 0; ns <= S; ns++) {
+        for (int g = 0; g < m->n_gen; g++) {
+            int i = m->gi[g], j = m->gj[g], qu = m->gq[g];
+            int from = STATE(m, g, ns);
+
+            // Arrival: seize an operator, queue, or be lost (self-loop)
+            if (i + j < c) {
+                add_transition(q, from, STATE(m, GEN_STATE(m, i + 1, j, 0), ns), lambda * p);
+                add_transition(q, from, STATE(m, GEN_STATE(m, i, j + 1, 0), ns), lambda * (1.0 - p));
+            } else if (qu < L) {
+                add_transition(q, from, STATE(m, GEN_STATE(m, i, j, qu + 1), ns), lambda);
+            }
+
+            // Generic-only departure; the head of the queue starts and its type is drawn now
+            if (i > 0) {
+                double r = i * m->mu_generic;
+                if (qu > 0) {
+                    add_transition(q, from, STATE(m, GEN_STATE(m, i, j, qu - 1), ns), r * p);
+                    add_transition(q, from, STATE(m, GEN_STATE(m, i - 1, j + 1, qu - 1), ns), r * (1.0 - p));
+                } else {
+                    add_transition(q, from, STATE(m, GEN_STATE(m, i - 1, j, 0), ns), r);
+                }
+            }
+
+            // Specific-type departure: hand over to the specific tier (dropped when full)
+            if (j > 0) {
+                double r = j * m->mu_spec_general;
+                int next_ns = (ns < S) ? ns + 1 : ns;
+                if (qu > 0) {
+                    add_transition(q, from, STATE(m, GEN_STATE(m, i + 1, j - 1, qu - 1), next_ns), r * p);
+                    add_transition(q, from, STATE(m, GEN_STATE(m, i, j, qu - 1), next_ns), r * (1.0 - p));
+                } else {
+                    add_transition(q, from, STATE(m, GEN_STATE(m, i, j - 1, 0), next_ns), r);
+                }
+            }
+
+            // Specific departure
+            if (ns > 0) {
+                add_transition(q, from, STATE(m, g, ns - 1), ((ns < m->s) ? ns : m->s) * m->mu_specific);
+            }
+        }
+    }
+    compress_generator(q);
+}
+
+// Initial guess for the full chain: the exact general-tier marginal times an M/M/s/S
+// specific tier fed at the general tier's hand-over rate. Only the correlation between
+// the tiers is left for Gauss-Seidel to resolve, which cuts the sweeps several-fold.
+static void product_form_guess(const ctmc_model *m, int S, double *pi) {
+    sparse_generator general;
+    build_generator(m, 0, &general);
+
+    double *pi_gen = ctmc_alloc(m->n_gen * sizeof(double));
+    for (int g = 0; g < m->n_gen; g++) {
+        pi_gen[g] = 1.0 / m->n_gen;
+    }
+    double residual;
+    gauss_seidel(&general, pi_gen, &residual);
+    free_generator(&general);
+
+    double handover_rate = 0.0;
+    for (int g = 0; g < m->n_gen; g++) {
+        handover_rate += pi_gen[g] * m->gj[g] * m->mu_spec_general;
+    }
+
+    double *pi_spec = ctmc_alloc((S + 1) * sizeof(double));
+    double sum = 0.0;
+    pi_spec[0] = 1.0;
+    for (int ns = 1; ns <= S; ns++) {
+        pi_spec[ns] = pi_spec[ns - 1] * handover_rate / (((ns < m->s) ? ns : m->s) * m->mu_specific);
+    }
+    for (int ns = 0; ns <= S; ns++) {
+        sum += pi_spec[ns];
+    }
+
+    for (int ns = 0; ns <= S; ns++) {
+        for (int g = 0; g < m->n_gen; g++) {
+            pi[STATE(m, g, ns)] = pi_gen[g] * pi_spec[ns] / sum;
+        }
+    }
+    free(pi_gen);
+    free(pi_spec);
+}
+
+int solve_call_center_ctmc(call_center_config config, ctmc_solution *solution) {
+    ctmc_model model;
+    const ctmc_model *m = &model;
+    init_ctmc_model(&model, config);
+
+    const int c = m->c, L = m->L, s = m->s;
+    const int S = s + CTMC_SPECIFIC_QUEUE_LIMIT;   // Most calls the specific tier holds
+    const double lambda = m->lambda;
+
+    sparse_generator q;
+    build_generator(m, S, &q);
+
+    double *pi = ctmc_alloc(q.n_states * sizeof(double));
+    product_form_guess(m, S, pi);
+    solution->sweeps = gauss_seidel(&q, pi, &solution->residual);
+    solution->n_states = q.n_states;
+
+    solution->gen_queue_distribution_size = L + 1;
+    solution->gen_queue_distribution = calloc(L + 1, sizeof(double));
+    solution->spec_queue_distribution_size = CTMC_SPECIFIC_QUEUE_LIMIT + 1;
+    solution->spec_queue_distribution = calloc(CTMC_SPECIFIC_QUEUE_LIMIT + 1, sizeof(double));
+    if (!solution->gen_queue_distribution || !solution->spec_queue_distribution) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    double p_delay = 0.0, p_loss = 0.0, gen_busy = 0.0, gen_queue = 0.0;
+    double spec_busy = 0.0, spec_queue = 0.0, handover_rate = 0.0, truncated = 0.0;
+    for (int ns = 0; ns <= S; ns++) {
+        for (int g = 0; g < m->n_gen; g++) {
+            double prob = pi[STATE(m, g, ns)];
+            int busy = m->gi[g] + m->gj[g];
+            int spec_busy_ops = (ns < s) ? ns : s;
+
+            if (busy == c) {
+                if (m->gq[g] < L) {
+                    p_delay += prob;
+                } else {
+                    p_loss += prob;
+                }
+            }
+            gen_busy += prob * busy;
+            gen_queue += prob * m->gq[g];
+            spec_busy += prob * spec_busy_ops;
+            spec_queue += prob * (ns - spec_busy_ops);
+            if (ns < S) {
+                handover_rate += prob * m->gj[g] * m->mu_spec_general;
+            } else {
+                truncated += prob;
+            }
+            solution->gen_queue_distribution[m->gq[g]] += prob;
+            solution->spec_queue_distribution[ns - spec_busy_ops] += prob;
+        }
+    }
+
+    // Little's law on each queue; arrivals see time averages (PASTA)
+    double admitted_rate = lambda * (1.0 - p_loss);
+    double wait_all_admitted = (admitted_rate > 0.0) ? gen_queue / admitted_rate : 0.0;
+    double spec_wait = (handover_rate > 0.0) ? spec_queue / handover_rate : 0.0;
+
+    solution->prob_call_delayed = p_delay;
+    solution->prob_call_lost = p_loss;
+    solution->avg_delay_of_calls = (p_delay > 0.0) ? gen_queue / (lambda * p_delay) : 0.0;
+    solution->avg_answ_time = wait_all_admitted + m->mean_spec_general + spec_wait;
+    solution->avg_gen_busy = gen_busy;
+    solution->avg_gen_queue_length = gen_queue;
+    solution->avg_spec_busy = spec_busy;
+    solution->avg_spec_queue_length = spec_queue;
+    solution->truncation_probability = truncated;
+
+    free(pi);
+    free_generator(&q);
+    free_ctmc_model(&model);
+
+    return (solution->residual <= CTMC_TOLERANCE) ? 0 : -1;
+}
+
+#undef STATE
+#undef GEN_STATE
+
+void free_ctmc_solution(ctmc_solution *solution) {
+    free(solution->gen_queue_distribution);
+    free(solution->spec_queue_distribution);
+    solution->gen_queue_distribution = solution->spec_queue_distribution = NULL;
+}
+
+call_center_stats start_call_center_ctmc(call_center_config config, int number_of_events) {
+    (void)number_of_events;
+    ctmc_solution sol;
+    if (solve_call_center_ctmc(config, &sol) != 0) {
+        fprintf(stderr, "Warning: CTMC solver stopped after %d sweeps (residual %.2e)\n", sol.sweeps, sol.residual);
+    }
+
+    call_center_stats result;
+    memset(&result, 0, sizeof(result));
+    init_delay_array(&result.general_p_stats.delays);
+    init_call_center_delay_histogram(&result.general_p_stats.delay_histogram);
+
+    result.general_p_stats.prob_call_delayed = sol.prob_call_delayed;
+    result.general_p_stats.prob_call_lost = sol.prob_call_lost;
+    result.general_p_stats.avg_delay_of_calls = sol.avg_delay_of_calls;
+    result.general_p_stats.avg_busy_operators = sol.avg_gen_busy;
+    result.general_p_stats.avg_queue_length = sol.avg_gen_queue_length;
+    result.general_p_stats.queue_length_distribution = sol.gen_queue_distribution;
+    result.general_p_stats.queue_length_distribution_size = sol.gen_queue_distribution_size;
+    // Analytic solution: the inputs sit exactly at their means
+    call_center_input_means(config, &result.general_p_stats.mean_interarrival_time,
+                            &result.general_p_stats.generic_only_fraction,
+                            &result.general_p_stats.mean_service_time);
+
+    // Mass at the truncation limit means the specific tier cannot keep up; its
+    // delay is then unbounded rather than whatever the truncated chain reports
+    result.area_spec_stats.avg_answ_time = (sol.truncation_probability > 1e-6) ? HUGE_VAL : sol.avg_answ_time;
+    result.area_spec_stats.avg_busy_operators = sol.avg_spec_busy;
+    result.area_spec_stats.avg_queue_length = sol.avg_spec_queue_length;
+    result.area_spec_stats.queue_length_distribution = sol.spec_queue_distribution;
+    result.area_spec_stats.queue_length_distribution_size = sol.spec_queue_distribution_size;
+
+    return result;
+}
@@ -0,0 +1,44 @@
+#ifndef CALL_CENTER_CTMC_H
+#define CALL_CENTER_CTMC_H
+
+#include "call_center.h"
+
+// Specific-tier waiting places kept in the state space; hand-overs that would
+// exceed it are dropped and reported as truncation_probability
+#define CTMC_SPECIFIC_QUEUE_LIMIT 60
+#define CTMC_TOLERANCE 1e-10
+// Over-relaxation factor of the Gauss-Seidel sweeps; about 1.5 and above diverges on this chain
+#define CTMC_RELAXATION 1.2
+#define CTMC_MAX_SWEEPS 20000
+
+// Steady state of the two-tier call center as a CTMC over (generic-only calls in
+// service, specific-type calls in service, general queue, specific calls). Every
+// duration is replaced by an exponential with the same mean as the sampler used
+// by the simulation, so the results are exact for exponential durations and a
+// reference otherwise.
+typedef struct {
+    double prob_call_delayed;
+    double prob_call_lost;
+    double avg_delay_of_calls;          // Mean general wait of delayed calls (s)
+    double avg_answ_time;               // Mean arrival-to-specific-answer time (s)
+    double avg_gen_busy;
+    double avg_gen_queue_length;
+    double avg_spec_busy;
+    double avg_spec_queue_length;
+    double *gen_queue_distribution;     // Steady-state P(general queue = k)
+    int gen_queue_distribution_size;
+    double *spec_queue_distribution;    // Steady-state P(specific queue = k)
+    int spec_queue_distribution_size;
+    double truncation_probability;      // P(specific tier at CTMC_SPECIFIC_QUEUE_LIMIT)
+    int n_states;
+    int sweeps;
+    double residual;                    // Last max relative change between sweeps
+} ctmc_solution;
+
+int solve_call_center_ctmc(call_center_config config, ctmc_solution *solution);
+void free_ctmc_solution(ctmc_solution *solution);
+
+// Adapter with the start_call_center() signature; number_of_events is unused
+call_center_stats start_call_center_ctmc(call_center_config config, int number_of_events);
+
+#endif // CALL_CENTER_CTMC_H
@@ -0,0 +1,100 @@
+#ifndef CALL_CENTER_DRAWS_H
+#define CALL_CENTER_DRAWS_H
+
+#include <math.h>
+#include <stdbool.h>
+#include "../poisson/poisson.h"
+#include "../models/service_dist.h"
+
+#ifndef M_PI
+#    define M_PI 3.14159265358979323846
+#endif
+
+// Sampling helpers shared by every call_center_engine.h instance. They are
+// static inline so that constant arguments (has_max, durations) fold away in
+// the compile-time specialized engines.
+
+static inline bool is_general_call(double gen_purpose_prob) {
+    double u = next_uniform();
+
+    return u <= gen_purpose_prob;
+}
+
+// Box-Muller. Mirroring its uniforms maps theta to 2 pi - theta, which leaves
+// cos(theta) unchanged, so an antithetic run undoes the mirror (exact on the
+// 2^-53 grid) and negates the normal instead: the pair draws z and -z.
+static inline double standard_normal(void) {
+    int antithetic = rng_get_antithetic();
+    double u1 = next_uniform();
+    double u2 = next_uniform();
+    if (antithetic) {
+        u1 = (1.0 - 0x1.0p-53) - u1;
+        u2 = (1.0 - 0x1.0p-53) - u2;
+    }
+
+    double theta = 2 * u1 * M_PI;
+    double r = sqrt(-2 * log(1.0 - u2));
+    double z = r * cos(theta);
+
+    return antithetic ? -z : z;
+}
+
+static inline double generate_truncated_normal_duration(double min, double avg, double std, double max) {
+    double duration = 0.0;
+
+    while (duration < min) {
+        double rv = standard_normal();
+        duration = rv * std + avg;
+    }
+
+    return (duration > max) ? max : duration;
+}
+
+static inline double generate_exponential_duration(double min, double avg, bool has_max, double max) {
+    double duration = min + next_poisson(avg);
+
+    if (has_max) {
+        return (duration > max) ? max : duration;
+    }
+
+    return duration;
+}
+
+// min plus a draw of mean avg from `law`; with an exponential law this is
+// generate_exponential_duration(min, avg, false, 0), draw for draw
+static inline double generate_service_duration(const service_dist *law, double min, double avg) {
+    return min + service_dist_draw(law, avg);
+}
+
+// Means of the samplers above, for analytic models and control variates
+
+static inline double expected_exponential_duration(double min, double avg, bool has_max, double max) {
+    if (!has_max) {
+        return min + avg;
+    }
+    if (max <= min) {
+        return max;
+    }
+    // E[min(X, m)] = avg * (1 - exp(-m / avg)) for X ~ Exp(avg)
+    return min + avg * (1.0 - exp(-(max - min) / avg));
+}
+
+static inline double expected_truncated_normal_duration(double min, double avg, double std, double max) {
+    if (std <= 0.0) {
+        return (avg > max) ? max : avg;
+    }
+    double a = (min - avg) / std;
+    double b = (max - avg) / std;
+    double cdf_a = 0.5 * erfc(-a / sqrt(2.0));
+    double cdf_b = 0.5 * erfc(-b / sqrt(2.0));
+    double pdf_a = exp(-0.5 * a * a) / sqrt(2.0 * M_PI);
+    double pdf_b = exp(-0.5 * b * b) / sqrt(2.0 * M_PI);
+    // Resampling below min conditions on X >= min; the cap at max keeps the upper tail at max
+    return (avg * (cdf_b - cdf_a) + std * (pdf_a - pdf_b) + max * (1.0 - cdf_b)) / (1.0 - cdf_a);
+}
+
+static inline double running_avg(int n, double old_avg, double sample) {
+    return (old_avg * ((n - 1.0) / n)) + (sample * (1.0 / n));
+}
+
+#endif // CALL_CENTER_DRAWS_H
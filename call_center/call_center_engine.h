@@ -0,0 +1,818 @@
+// Call center engine template (intentionally no include guard).
+//
+// Including this file defines
+//     static call_center_stats run_call_center_<CC_VARIANT>(call_center_config config, int number_of_events)
+// and its building blocks init_call_center_state_<CC_VARIANT>() and
+// advance_call_center_<CC_VARIANT>(), which work on a call_center_state so a run
+// can be paused, snapshotted and resumed, plus run_specific_tier_<CC_VARIANT>(),
+// the specialist tier of a parallel run, from the parameter macros below. Each macro may expand to a field of the
+// `config` argument (generic engine) or to a constant (specialized engines),
+// in which case the compiler folds every branch that depends on it.
+//
+//   CC_VARIANT                         suffix of the generated function names
+//   CC_HAS_SPECIFIC_TIER               0 when every call is generic-only
+//   CC_NUM_GEN_OPR, CC_NUM_SPEC_OPR, CC_LENGTH_GEN_QUEUE
+//   CC_ARRIVAL_RATE, CC_GENERAL_PURPOSE_RATIO
+//   CC_GEN_MIN_DURATION_S, CC_GEN_AVG_DURATION_S, CC_GEN_MAX_DURATION_S
+//   CC_SPEC_MIN_DURATION_S, CC_SPEC_AVG_DURATION_S, CC_SPEC_STD_DURATION_S, CC_SPEC_MAX_DURATION_S
+//   CC_AREA_SPEC_MIN_DURATION_S, CC_AREA_SPEC_AVG_DURATION_S
+//   CC_GEN_PATIENCE_AVG_S, CC_SPEC_PATIENCE_AVG_S   0 when queued callers never abandon
+//   CC_PRIORITY_CLASSES, CC_PRIORITY_SHARES        1 for a single FIFO per tier
+//   CC_PREEMPTIVE                      1 when higher classes interrupt lower ones in service
+//   CC_ARRIVAL_PROCESS                 1 when gaps come from config.arrival_config, 0 for Poisson
+//   CC_GENERAL_SERVICE                 1 when specialist service follows config.area_service
+//
+// Every parameter is #undef'd at the end so the template can be included again.
+
+#include <string.h>
+#include "call_center.h"
+#include "call_center_draws.h"
+#include "call_center_pdes.h"
+#include "../models/profiling.h"
+
+#define CC_CONCAT_(a, b) a##_##b
+#define CC_CONCAT(a, b) CC_CONCAT_(a, b)
+#define CC_FN(name) CC_CONCAT(name, CC_VARIANT)
+#define CC_HAS_PATIENCE (CC_GEN_PATIENCE_AVG_S > 0.0 || (CC_HAS_SPECIFIC_TIER && CC_SPEC_PATIENCE_AVG_S > 0.0))
+#define CC_HAS_PREEMPTION (CC_PREEMPTIVE && CC_PRIORITY_CLASSES > 1)
+
+static inline double CC_FN(generate_general_purpose_duration)(call_center_config config, bool is_generic_only) {
+    (void)config;
+    if (!CC_HAS_SPECIFIC_TIER || is_generic_only) {
+        return generate_exponential_duration(
+            CC_GEN_MIN_DURATION_S,
+            CC_GEN_AVG_DURATION_S,
+            true,
+            CC_GEN_MAX_DURATION_S);
+    }
+    return generate_truncated_normal_duration(
+        CC_SPEC_MIN_DURATION_S,
+        CC_SPEC_AVG_DURATION_S,
+        CC_SPEC_STD_DURATION_S,
+        CC_SPEC_MAX_DURATION_S);
+}
+
+static inline double CC_FN(generate_specific_duration)(call_center_config config) {
+    (void)config;
+    if (CC_GENERAL_SERVICE) {
+        return generate_service_duration(config.area_service, CC_AREA_SPEC_MIN_DURATION_S, CC_AREA_SPEC_AVG_DURATION_S);
+    }
+    return generate_exponential_duration(
+        CC_AREA_SPEC_MIN_DURATION_S,
+        CC_AREA_SPEC_AVG_DURATION_S,
+        false,
+        0);
+}
+
+static inline bool CC_FN(next_call_is_generic_only)(call_center_config config) {
+    (void)config;
+    return !CC_HAS_SPECIFIC_TIER || is_general_call(CC_GENERAL_PURPOSE_RATIO);
+}
+
+// Priority class of the next arrival, class 0 being served first
+static inline int CC_FN(next_priority_class)(call_center_config config) {
+    (void)config;
+    if (CC_PRIORITY_CLASSES <= 1) {
+        return 0;
+    }
+    double u = next_uniform();
+    int k = 0;
+    double share = CC_PRIORITY_SHARES[0];
+    while (k < CC_PRIORITY_CLASSES - 1 && u >= share) {
+        share += CC_PRIORITY_SHARES[++k];
+    }
+    return k;
+}
+
+// Gap to the next general arrival
+static inline double CC_FN(next_interarrival)(call_center_config config, arrival_process *arrivals) {
+    (void)config;
+    if (CC_ARRIVAL_PROCESS) {
+        return arrival_process_next(arrivals);
+    }
+    return next_poisson(1.0 / CC_ARRIVAL_RATE);
+}
+
+// Takes the next call to serve off a queue, freeing callers who hung up on the way
+static inline call_list *CC_FN(next_waiting_call)(call_center_config config, class_queue *queue) {
+    (void)config;
+    call_list *node = class_queue_pop(queue);
+    while (CC_HAS_PATIENCE && node != NULL && node->c.abandoned) {
+        free(node);
+        node = class_queue_pop(queue);
+    }
+    return node;
+}
+
+// Queues a call behind the others of its class; with a patience configured,
+// also schedules the moment it hangs up
+static inline void CC_FN(enqueue_call)(class_queue *queue, event_set *patience_timers, double patience_avg_s,
+                                       double current_time, call new_call) {
+    new_call.patience_timer = EVENT_HANDLE_NONE;
+    new_call.abandoned = false;
+    call_list *node = _node(ARRIVAL, current_time, new_call);
+    class_queue_push(queue, new_call.priority, node);
+    if (patience_avg_s > 0.0) {
+        node->c.patience_timer = event_set_schedule(patience_timers, current_time + next_poisson(patience_avg_s), node);
+    }
+}
+
+// Schedules the departure of a call entering service; preemptive runs also
+// index it by tier and class for preempt_call
+static inline void CC_FN(start_service)(call_center_config config, call_list **event_list,
+                                        call_center_in_service *in_service, double departure_time, call c) {
+    (void)config;
+    if (!CC_HAS_PREEMPTION) {
+        *event_list = _add(*event_list, DEPARTURE, departure_time, c);
+        return;
+    }
+    call_list *node = _node(DEPARTURE, departure_time, c);
+    node->c.patience_timer = event_set_schedule(&in_service->calls[c.type][c.priority], -departure_time, node);
+    *event_list = _insert(*event_list, node);
+}
+
+// The departure at the head of the event list leaves the in-service index
+static inline void CC_FN(end_service)(call_center_config config, call_center_in_service *in_service,
+                                      const call_list *departure) {
+    (void)config;
+    if (CC_HAS_PREEMPTION) {
+        event_set_cancel(&in_service->calls[departure->c.type][departure->c.priority], departure->c.patience_timer);
+    }
+}
+
+// Preemptive-resume: interrupts the call of `tier` in service with the lowest
+// class below `priority` (of those, the one with the most service left). Its
+// departure stays behind as a tombstone and it waits at the head of its class
+// with the rest of its service. False when every call in service has at least
+// that priority. O(classes + log n) through the in-service index.
+static inline bool CC_FN(preempt_call)(call_center_config config, call_center_in_service *in_service,
+                                       CALL_TYPE tier, int priority, double current_time, class_queue *queue) {
+    (void)config;
+    for (int k = CC_PRIORITY_CLASSES - 1; k > priority; k--) {
+        event_set *calls = &in_service->calls[tier][k];
+        if (event_set_empty(calls)) {
+            continue;
+        }
+        double key;
+        call_list *departure = event_set_pop(calls, &key);
+        departure->c.abandoned = true;
+
+        call c = departure->c;
+        c.remaining_service = departure->time - current_time;
+        c.patience_timer = EVENT_HANDLE_NONE;
+        c.abandoned = false;
+        class_queue_push_front(queue, k, _node(ARRIVAL, current_time, c));
+        return true;
+    }
+    return false;
+}
+
+// Frees the departures of preempted calls that reached the head of the list
+static inline call_list *CC_FN(drop_preempted)(call_center_config config, call_list *event_list) {
+    (void)config;
+    while (CC_HAS_PREEMPTION && event_list != NULL && event_list->c.abandoned) {
+        event_list = _remove(event_list);
+    }
+    return event_list;
+}
+
+static inline void CC_FN(handle_general_call_arrival)(
+    call_center_config config,
+    int *general_opr_busy,
+    int *in_queue_general_call,
+    int64_t *blocked_general_call,
+    int64_t *delayed_general_call,
+    int64_t *preempted_general_call,
+    call_center_class_counters *classes,
+    call_list **event_list,
+    call_center_in_service *in_service,
+    class_queue *general_waiting_queue,
+    event_set *patience_timers,
+    wait_predictor *predictor,
+    compensated_sum *general_service_total
+) {
+    bool serve = (*general_opr_busy) < CC_NUM_GEN_OPR;
+    if (serve) {
+        // I have capacity lets process it
+        (*general_opr_busy)++;
+    } else if (CC_HAS_PREEMPTION && (*in_queue_general_call) < CC_LENGTH_GEN_QUEUE &&
+               CC_FN(preempt_call)(config, in_service, GENERAL_PURPOSE, (*event_list)->c.priority, (*event_list)->time,
+                                   general_waiting_queue)) {
+        // A lower class gives up its operator and waits in the queue instead
+        (*in_queue_general_call)++;
+        (*preempted_general_call)++;
+        serve = true;
+    }
+
+    if (serve) {
+        wait_predictor_arrival(predictor);
+
+        // Generate duration based on call type
+        double duration = CC_FN(generate_general_purpose_duration)(config, (*event_list)->c.gen_call.is_generic_only);
+        compensated_add(general_service_total, duration);
+
+        call new_call = (*event_list)->c;
+
+        new_call.gen_call.answer_time = (*event_list)->time;
+        new_call.gen_call.service_start = (*event_list)->time;
+
+        CC_FN(start_service)(config, event_list, in_service, (*event_list)->time + duration, new_call);
+
+    } else {
+        // I dont have capacity to process now
+        if ((*in_queue_general_call) < CC_LENGTH_GEN_QUEUE) {
+            // Queue still has space
+            (*delayed_general_call)++;
+            classes[(*event_list)->c.priority].delayed++;
+
+            call new_call = (*event_list)->c;
+
+            new_call.gen_call.answer_time = 0.0;
+            new_call.gen_call.prediction_waiting = wait_predictor_predict(predictor);
+            new_call.gen_call.original_arrival_time = (*event_list)->time;
+            wait_predictor_arrival(predictor);
+
+            (*in_queue_general_call)++;
+            PROF_QUEUE_LENGTH(PROF_QUEUE_GENERAL, *in_queue_general_call);
+            CC_FN(enqueue_call)(general_waiting_queue, patience_timers, CC_GEN_PATIENCE_AVG_S,
+                                (*event_list)->time, new_call);
+        }
+        else {
+            // If queue is full, call is blocked
+            (*blocked_general_call)++;
+            classes[(*event_list)->c.priority].blocked++;
+        }
+    }
+}
+
+static inline void CC_FN(handle_specific_call_arrival)(
+    call_center_config config,
+    int *specific_opr_busy,
+    int *in_queue_specific_call,
+    int64_t *preempted_specific_call,
+    call_center_class_counters *classes,
+    call_list **event_list,
+    call_center_in_service *in_service,
+    class_queue *specific_waiting_queue,
+    event_set *patience_timers,
+    compensated_sum *total_elapsed_time_between_gen,
+    int64_t *total_specific,
+    call arriving_call,
+    double current_time
+) {
+    call new_call = {AREA_SPECIFIC, arriving_call.gen_call, arriving_call.priority, 0.0, EVENT_HANDLE_NONE, false};
+
+    bool serve = (*specific_opr_busy) < CC_NUM_SPEC_OPR;
+    if (serve) {
+        (*specific_opr_busy)++;
+    } else if (CC_HAS_PREEMPTION &&
+               CC_FN(preempt_call)(config, in_service, AREA_SPECIFIC, new_call.priority, current_time, specific_waiting_queue)) {
+        (*in_queue_specific_call)++;
+        (*preempted_specific_call)++;
+        serve = true;
+    }
+
+    if (serve) {
+        double duration = CC_FN(generate_specific_duration)(config);
+
+        // Calculate time from ORIGINAL arrival to general system until now (answered by area-specific)
+        double elapsed = current_time - arriving_call.gen_call.original_arrival_time;
+        compensated_add(total_elapsed_time_between_gen, elapsed);
+        (*total_specific)++;
+        classes[new_call.priority].specific_answered++;
+        compensated_add(&classes[new_call.priority].specific_elapsed_total, elapsed);
+
+        CC_FN(start_service)(config, event_list, in_service, current_time + duration, new_call);
+    } else {
+        // If I dont have capacity, put in infinite waiting queue
+        (*in_queue_specific_call)++;
+        PROF_QUEUE_LENGTH(PROF_QUEUE_SPECIFIC, *in_queue_specific_call);
+        CC_FN(enqueue_call)(specific_waiting_queue, patience_timers, CC_SPEC_PATIENCE_AVG_S, current_time, new_call);
+    }
+}
+
+// The specialist call at the head of the event list departs: its operator
+// takes the next queued call, if any
+static inline void CC_FN(handle_specific_call_departure)(
+    call_center_config config,
+    int *specific_opr_busy,
+    int *in_queue_specific_call,
+    call_center_class_counters *classes,
+    call_list **event_list,
+    call_center_in_service *in_service,
+    class_queue *specific_waiting_queue,
+    event_set *patience_timers,
+    compensated_sum *total_elapsed_time_between_gen,
+    int64_t *total_specific
+) {
+    (void)patience_timers;
+    CC_FN(end_service)(config, in_service, *event_list);
+    call_list *next = CC_FN(next_waiting_call)(config, specific_waiting_queue);
+    if (next == NULL) {
+        (*specific_opr_busy)--;
+        return;
+    }
+
+    double current_time = (*event_list)->time;
+    double duration;
+    if (CC_HAS_PREEMPTION && next->c.remaining_service > 0.0) {
+        // Resumes where it was interrupted
+        duration = next->c.remaining_service;
+        next->c.remaining_service = 0.0;
+    } else {
+        duration = CC_FN(generate_specific_duration)(config);
+
+        // Calculate time from ORIGINAL arrival to general system until now
+        double elapsed = current_time - next->c.gen_call.original_arrival_time;
+        compensated_add(total_elapsed_time_between_gen, elapsed);
+        (*total_specific)++;
+        classes[next->c.priority].specific_answered++;
+        compensated_add(&classes[next->c.priority].specific_elapsed_total, elapsed);
+    }
+    if (CC_HAS_PATIENCE && CC_SPEC_PATIENCE_AVG_S > 0.0) {
+        event_set_cancel(patience_timers, next->c.patience_timer);
+    }
+
+    CC_FN(start_service)(config, event_list, in_service, current_time + duration, next->c);
+
+    free(next);
+    (*in_queue_specific_call)--;
+}
+
+// A queued specialist caller runs out of patience
+static inline void CC_FN(hang_up_specific_call)(call_list *node, int *in_queue_specific_call,
+                                                int64_t *abandoned_specific_call, call_center_class_counters *classes) {
+    // The call stays in its queue as a tombstone, freed once it reaches the head
+    node->c.abandoned = true;
+    node->c.patience_timer = EVENT_HANDLE_NONE;
+    (*in_queue_specific_call)--;
+    (*abandoned_specific_call)++;
+    classes[node->c.priority].specific_abandoned++;
+}
+
+// Empty system with the first arrival scheduled at time 0
+static inline void CC_FN(init_call_center_state)(call_center_config config, call_center_state *state) {
+    memset(&state->counters, 0, sizeof(state->counters));
+    if (config.tier_streams) {
+        // A stream 2^128 draws ahead of the caller's, taken before the first draw
+        rng_get_state(&state->counters.specific_stream);
+        rng_jump(&state->counters.specific_stream);
+    }
+    state->event_list = NULL;
+    init_class_queue(&state->general_waiting_queue, CC_PRIORITY_CLASSES, CC_LENGTH_GEN_QUEUE + 1);
+    init_class_queue(&state->specific_waiting_queue, CC_PRIORITY_CLASSES, 64);
+    init_event_set(&state->patience_timers, CC_LENGTH_GEN_QUEUE + 16);
+    init_call_center_in_service(&state->in_service, config);
+    memset(&state->arrivals, 0, sizeof(state->arrivals));
+    if (CC_ARRIVAL_PROCESS) {
+        init_arrival_process(&state->arrivals, config.arrival_config, CC_ARRIVAL_RATE);
+    }
+    init_delay_array(&state->delays);
+    init_call_center_delay_histogram(&state->delay_histogram);
+
+    // Time-weighted occupancy, charged at every event in O(1)
+    init_time_average(&state->gen_busy_avg, CC_NUM_GEN_OPR + 1);
+    init_time_average(&state->gen_queue_avg, CC_LENGTH_GEN_QUEUE + 1);
+    init_time_average(&state->spec_busy_avg, CC_NUM_SPEC_OPR + 1);
+    init_time_average(&state->spec_queue_avg, 16);
+
+    double mean_interarrival_time, generic_only_fraction, mean_service_time;
+    call_center_input_means(config, &mean_interarrival_time, &generic_only_fraction, &mean_service_time);
+    init_wait_predictor(&state->counters.predictor, config.wait_predictor, CC_NUM_GEN_OPR,
+                        mean_service_time, WAIT_PREDICTOR_DEFAULT_SMOOTHING);
+
+    struct general_call gen_call = {CC_FN(next_call_is_generic_only)(config), 0.0, 0.0, 0.0, 0.0};
+    struct call c = {GENERAL_PURPOSE, gen_call, CC_FN(next_priority_class)(config), 0.0, EVENT_HANDLE_NONE, false};
+
+    state->event_list = _add(state->event_list, ARRIVAL, 0.0, c);
+}
+
+// Processes events until number_of_events general arrivals have been counted.
+// The counters live in locals for the duration of the loop.
+static inline void CC_FN(advance_call_center)(call_center_config config, call_center_state *state,
+                                              int64_t number_of_events) {
+    int general_opr_busy = state->counters.general_opr_busy;
+    int specific_opr_busy = state->counters.specific_opr_busy;
+    int in_queue_general_call = state->counters.in_queue_general_call;
+    int in_queue_specific_call = state->counters.in_queue_specific_call;
+    int64_t blocked_general_call = state->counters.blocked_general_call;
+    int64_t delayed_general_call = state->counters.delayed_general_call;
+    int64_t abandoned_general_call = state->counters.abandoned_general_call;
+    int64_t abandoned_specific_call = state->counters.abandoned_specific_call;
+    int64_t preempted_general_call = state->counters.preempted_general_call;
+    int64_t preempted_specific_call = state->counters.preempted_specific_call;
+    int64_t general_arrivals = state->counters.general_arrivals;
+    int64_t epochs = state->counters.epochs;
+    wait_predictor predictor = state->counters.predictor;
+    call_center_class_counters *classes = state->counters.classes;
+
+    int64_t waits = state->counters.waits;
+    compensated_sum wait_total = state->counters.wait_total;
+    compensated_sum abs_prediction_error_total = state->counters.abs_prediction_error_total;
+    compensated_sum rel_prediction_error_total = state->counters.rel_prediction_error_total;
+    compensated_sum total_elapsed_time_between_gen = state->counters.total_elapsed_time_between_gen;
+    int64_t total_specific = state->counters.total_specific;
+
+    // Input sums for the control variates
+    compensated_sum interarrival_total = state->counters.interarrival_total;
+    compensated_sum general_service_total = state->counters.general_service_total;
+    int64_t generic_only_calls = state->counters.generic_only_calls;
+    rng_state specific_stream = state->counters.specific_stream;
+
+    call_list *event_list = state->event_list;
+    class_queue general_waiting_queue = state->general_waiting_queue;
+    class_queue specific_waiting_queue = state->specific_waiting_queue;
+    event_set patience_timers = state->patience_timers;
+    arrival_process arrivals = state->arrivals;
+
+    delay_array delays = state->delays;
+    hdr_histogram delay_histogram = state->delay_histogram;
+    time_average gen_busy_avg = state->gen_busy_avg;
+    time_average gen_queue_avg = state->gen_queue_avg;
+    time_average spec_busy_avg = state->spec_busy_avg;
+    time_average spec_queue_avg = state->spec_queue_avg;
+
+    bool is_generic_only;
+    struct call c = {GENERAL_PURPOSE, {false, 0.0, 0.0, 0.0, 0.0}, 0, 0.0, EVENT_HANDLE_NONE, false};
+
+    while (general_arrivals < number_of_events) {
+        // A queued caller whose patience runs out before the next scheduled event hangs up first
+        double now = event_list->time;
+        call_list *hanging_up = NULL;
+        if (CC_HAS_PATIENCE && !event_set_empty(&patience_timers) && event_set_next_time(&patience_timers) < now) {
+            hanging_up = event_set_pop(&patience_timers, &now);
+        }
+
+        PROF_EVENT_BEGIN(prof_start);
+#ifdef TELESIM_PROFILE
+        prof_event_type prof_type = (hanging_up != NULL) ? PROF_EVENT_ABANDONMENT
+                                  : (event_list->type == ARRIVAL) ? PROF_EVENT_ARRIVAL
+                                  : (event_list->c.type == AREA_SPECIFIC) ? PROF_EVENT_DEPARTURE_SPECIFIC
+                                  : PROF_EVENT_DEPARTURE_GENERAL;
+#endif
+
+        // Each tier's occupancy is charged at its own events only, so it does
+        // not depend on how the tiers' events interleave (see run_specific_tier)
+        bool specific_event = (CC_HAS_PATIENCE && hanging_up != NULL)
+                                  ? hanging_up->c.type == AREA_SPECIFIC
+                                  : CC_HAS_SPECIFIC_TIER && event_list->type == DEPARTURE &&
+                                        event_list->c.type == AREA_SPECIFIC;
+        if (specific_event) {
+            time_average_advance(&spec_busy_avg, now, specific_opr_busy);
+            time_average_advance(&spec_queue_avg, now, in_queue_specific_call);
+        } else {
+            time_average_advance(&gen_busy_avg, now, general_opr_busy);
+            time_average_advance(&gen_queue_avg, now, in_queue_general_call);
+        }
+
+        if (CC_HAS_PATIENCE && hanging_up != NULL) {
+            if (hanging_up->c.type == GENERAL_PURPOSE) {
+                // The call stays in its queue as a tombstone, freed once it reaches the head
+                hanging_up->c.abandoned = true;
+                hanging_up->c.patience_timer = EVENT_HANDLE_NONE;
+                in_queue_general_call--;
+                abandoned_general_call++;
+                classes[hanging_up->c.priority].abandoned++;
+                wait_predictor_abandon(&predictor);
+            } else {
+                CC_FN(hang_up_specific_call)(hanging_up, &in_queue_specific_call, &abandoned_specific_call, classes);
+            }
+            PROF_EVENT_END(prof_start, prof_type);
+            continue;
+        }
+
+        // Arrival or Departure?
+        if (event_list->type == ARRIVAL) {
+            // Only General Calls Arrive via the event list
+            general_arrivals++;
+            generic_only_calls += event_list->c.gen_call.is_generic_only;
+            classes[event_list->c.priority].arrivals++;
+            CC_FN(handle_general_call_arrival)(
+                config,
+                &general_opr_busy,
+                &in_queue_general_call,
+                &blocked_general_call,
+                &delayed_general_call,
+                &preempted_general_call,
+                classes,
+                &event_list,
+                &state->in_service,
+                &general_waiting_queue,
+                &patience_timers,
+                &predictor,
+                &general_service_total
+            );
+
+            is_generic_only = CC_FN(next_call_is_generic_only)(config);
+
+            double tmp = CC_FN(next_interarrival)(config, &arrivals);
+            compensated_add(&interarrival_total, tmp);
+
+            c.type = GENERAL_PURPOSE; // Generate new general purpose call
+            struct general_call gen_call = {is_generic_only, 0.0, 0.0, event_list->time + tmp, 0.0};
+            c.gen_call = gen_call;
+            c.priority = CC_FN(next_priority_class)(config);
+
+            event_list = _add(event_list, ARRIVAL, event_list->time + tmp, c);
+        } else if (event_list->type == DEPARTURE) {
+            if (CC_HAS_SPECIFIC_TIER && event_list->c.type == AREA_SPECIFIC) {
+                if (config.tier_streams) {
+                    rng_swap_state(&specific_stream);
+                }
+                CC_FN(handle_specific_call_departure)(
+                    config,
+                    &specific_opr_busy,
+                    &in_queue_specific_call,
+                    classes,
+                    &event_list,
+                    &state->in_service,
+                    &specific_waiting_queue,
+                    &patience_timers,
+                    &total_elapsed_time_between_gen,
+                    &total_specific
+                );
+                if (config.tier_streams) {
+                    rng_swap_state(&specific_stream);
+                }
+            } else if (event_list->c.type == GENERAL_PURPOSE) {
+                // Process next call in queue if any
+                bool departing_call_needs_specific = CC_HAS_SPECIFIC_TIER && !event_list->c.gen_call.is_generic_only;
+                call departing_call = event_list->c;
+                double current_time = event_list->time;
+                CC_FN(end_service)(config, &state->in_service, event_list);
+                wait_predictor_departure(&predictor, current_time - departing_call.gen_call.service_start);
+
+                call_list *next = CC_FN(next_waiting_call)(config, &general_waiting_queue);
+                if (next != NULL)
+                {
+                    double duration;
+                    if (CC_HAS_PREEMPTION && next->c.remaining_service > 0.0) {
+                        // Resumes where it was interrupted; its wait was counted when first answered
+                        duration = next->c.remaining_service;
+                        next->c.remaining_service = 0.0;
+                        next->c.gen_call.service_start += current_time - next->time;
+                        wait_predictor_resume(&predictor);
+                    } else {
+                        if (CC_HAS_PATIENCE && CC_GEN_PATIENCE_AVG_S > 0.0) {
+                            event_set_cancel(&patience_timers, next->c.patience_timer);
+                        }
+                        duration = CC_FN(generate_general_purpose_duration)(config, next->c.gen_call.is_generic_only);
+                        compensated_add(&general_service_total, duration);
+
+                        // Calculate actual waiting time
+                        double waiting_time = event_list->time - next->time;
+
+                        wait_predictor_answer(&predictor, waiting_time);
+
+                        // Store prediction vs actual for statistics
+                        delay d = {next->c.gen_call.prediction_waiting, waiting_time};
+                        double prediction_error = fabs(d.predicted - d.actual);
+                        waits++;
+                        compensated_add(&wait_total, waiting_time);
+                        compensated_add(&abs_prediction_error_total, prediction_error);
+                        compensated_add(&rel_prediction_error_total, prediction_error / fabs(waiting_time));
+                        if (!config.long_run) {
+                            add_delay(&delays, d);
+                        }
+                        hdr_histogram_record(&delay_histogram, waiting_time);
+                        call_center_trace_delay(d);
+                        classes[next->c.priority].waits++;
+                        compensated_add(&classes[next->c.priority].wait_total, waiting_time);
+
+                        // Mark when this call was answered by general operator
+                        next->c.gen_call.answer_time = event_list->time;
+                        next->c.gen_call.service_start = event_list->time;
+                    }
+
+                    CC_FN(start_service)(config, &event_list, &state->in_service, event_list->time + duration, next->c);
+                    free(next);
+                    in_queue_general_call--;
+                }
+                else
+                {
+                    general_opr_busy--;
+                }
+                if (departing_call_needs_specific && call_center_handoffs != NULL) {
+                    // Parallel run: the specialist tier is another logical process
+                    call_center_pdes_send(call_center_handoffs, CALL_CENTER_PDES_HANDOFF, current_time, epochs,
+                                          &departing_call);
+                } else if (departing_call_needs_specific) {
+                    time_average_advance(&spec_busy_avg, current_time, specific_opr_busy);
+                    time_average_advance(&spec_queue_avg, current_time, in_queue_specific_call);
+                    if (config.tier_streams) {
+                        rng_swap_state(&specific_stream);
+                    }
+                    CC_FN(handle_specific_call_arrival)(
+                        config,
+                        &specific_opr_busy,
+                        &in_queue_specific_call,
+                        &preempted_specific_call,
+                        classes,
+                        &event_list,
+                        &state->in_service,
+                        &specific_waiting_queue,
+                        &patience_timers,
+                        &total_elapsed_time_between_gen,
+                        &total_specific,
+                        departing_call,
+                        current_time
+                    );
+                    if (config.tier_streams) {
+                        rng_swap_state(&specific_stream);
+                    }
+                }
+            }
+        }
+        event_list = CC_FN(drop_preempted)(config, _remove(event_list));
+        if (event_list->time >= CALL_CENTER_EPOCH_S) {
+            time_average *averages[4] = {&gen_busy_avg, &gen_queue_avg, &spec_busy_avg, &spec_queue_avg};
+            rebase_call_center_time(event_list, &general_waiting_queue, &specific_waiting_queue, &patience_timers,
+                                    &state->in_service, averages);
+            epochs++;
+        }
+        PROF_EVENT_END(prof_start, prof_type);
+    }
+    PROF_FLUSH();
+
+    state->counters.general_opr_busy = general_opr_busy;
+    state->counters.specific_opr_busy = specific_opr_busy;
+    state->counters.in_queue_general_call = in_queue_general_call;
+    state->counters.in_queue_specific_call = in_queue_specific_call;
+    state->counters.blocked_general_call = blocked_general_call;
+    state->counters.delayed_general_call = delayed_general_call;
+    state->counters.abandoned_general_call = abandoned_general_call;
+    state->counters.abandoned_specific_call = abandoned_specific_call;
+    state->counters.preempted_general_call = preempted_general_call;
+    state->counters.preempted_specific_call = preempted_specific_call;
+    state->counters.general_arrivals = general_arrivals;
+    state->counters.epochs = epochs;
+    state->counters.predictor = predictor;
+    state->counters.waits = waits;
+    state->counters.wait_total = wait_total;
+    state->counters.abs_prediction_error_total = abs_prediction_error_total;
+    state->counters.rel_prediction_error_total = rel_prediction_error_total;
+    state->counters.total_elapsed_time_between_gen = total_elapsed_time_between_gen;
+    state->counters.total_specific = total_specific;
+    state->counters.interarrival_total = interarrival_total;
+    state->counters.general_service_total = general_service_total;
+    state->counters.generic_only_calls = generic_only_calls;
+    state->counters.specific_stream = specific_stream;
+    state->event_list = event_list;
+    state->general_waiting_queue = general_waiting_queue;
+    state->specific_waiting_queue = specific_waiting_queue;
+    state->patience_timers = patience_timers;
+    state->arrivals = arrivals;
+    state->delays = delays;
+    state->delay_histogram = delay_histogram;
+    state->gen_busy_avg = gen_busy_avg;
+    state->gen_queue_avg = gen_queue_avg;
+    state->spec_busy_avg = spec_busy_avg;
+    state->spec_queue_avg = spec_queue_avg;
+}
+
+// The specialist tier as a logical process of a parallel run (call_center_pdes.h).
+// Its only input is the general tier's hand-offs, read from `channel` in
+// timestamp order. Every own departure or hang-up before the next hand-off is
+// processed first, and no later hand-off can be earlier, so it never rolls
+// back. Each tier is charged at its own events and rebased before its first
+// event past the epoch, as in advance_call_center, so results match a
+// sequential run with config.tier_streams draw for draw. Returns on the end
+// message, charged up to its time and in the sender's epoch.
+static inline void CC_FN(run_specific_tier)(call_center_config config, call_center_state *state,
+                                            call_center_channel *channel) {
+    call_center_counters *k = &state->counters;
+    double messages[CALL_CENTER_PDES_BATCH * CALL_CENTER_PDES_WIDTH];
+
+    for (;;) {
+        size_t n = call_center_pdes_receive(channel, messages, CALL_CENTER_PDES_BATCH);
+        for (size_t i = 0; i < n; i++) {
+            const double *m = messages + i * CALL_CENTER_PDES_WIDTH;
+            bool end = m[CALL_CENTER_PDES_KIND] == CALL_CENTER_PDES_END;
+            int64_t epoch = (int64_t)m[CALL_CENTER_PDES_EPOCH];
+
+            for (;;) {
+                // Hand-offs are profiled with the general departure that sends them
+                PROF_EVENT_BEGIN(prof_start);
+                // The message in this process's epoch; both clocks were rebased exactly
+                double offset = (double)(epoch - k->epochs) * CALL_CENTER_EPOCH_S;
+                double target = m[CALL_CENTER_PDES_TIME] + offset;
+                state->event_list = CC_FN(drop_preempted)(config, state->event_list);
+                bool own = state->event_list != NULL && state->event_list->time < target;
+                double now = own ? state->event_list->time : target;
+
+                if (CC_HAS_PATIENCE && !event_set_empty(&state->patience_timers) &&
+                    event_set_next_time(&state->patience_timers) < now) {
+                    call_list *hanging_up = event_set_pop(&state->patience_timers, &now);
+                    time_average_advance(&state->spec_busy_avg, now, k->specific_opr_busy);
+                    time_average_advance(&state->spec_queue_avg, now, k->in_queue_specific_call);
+                    CC_FN(hang_up_specific_call)(hanging_up, &k->in_queue_specific_call,
+                                                 &k->abandoned_specific_call, k->classes);
+                    PROF_EVENT_END(prof_start, PROF_EVENT_ABANDONMENT);
+                    continue;
+                }
+                if (!own && end) {
+                    time_average_advance(&state->spec_busy_avg, target, k->specific_opr_busy);
+                    time_average_advance(&state->spec_queue_avg, target, k->in_queue_specific_call);
+                    break;
+                }
+                if (now >= CALL_CENTER_EPOCH_S) {
+                    time_average *averages[4] = {&state->gen_busy_avg, &state->gen_queue_avg,
+                                                 &state->spec_busy_avg, &state->spec_queue_avg};
+                    rebase_call_center_time(state->event_list, &state->general_waiting_queue,
+                                            &state->specific_waiting_queue, &state->patience_timers,
+                                            &state->in_service, averages);
+                    k->epochs++;
+                    continue;
+                }
+
+                time_average_advance(&state->spec_busy_avg, now, k->specific_opr_busy);
+                time_average_advance(&state->spec_queue_avg, now, k->in_queue_specific_call);
+                if (own) {
+                    CC_FN(handle_specific_call_departure)(
+                        config,
+                        &k->specific_opr_busy,
+                        &k->in_queue_specific_call,
+                        k->classes,
+                        &state->event_list,
+                        &state->in_service,
+                        &state->specific_waiting_queue,
+                        &state->patience_timers,
+                        &k->total_elapsed_time_between_gen,
+                        &k->total_specific
+                    );
+                    state->event_list = _remove(state->event_list);
+                    PROF_EVENT_END(prof_start, PROF_EVENT_DEPARTURE_SPECIFIC);
+                    continue;
+                }
+
+                CC_FN(handle_specific_call_arrival)(
+                    config,
+                    &k->specific_opr_busy,
+                    &k->in_queue_specific_call,
+                    &k->preempted_specific_call,
+                    k->classes,
+                    &state->event_list,
+                    &state->in_service,
+                    &state->specific_waiting_queue,
+                    &state->patience_timers,
+                    &k->total_elapsed_time_between_gen,
+                    &k->total_specific,
+                    call_center_pdes_call(m, offset),
+                    now
+                );
+                break;
+            }
+
+            if (end) {
+                // Into the sender's epoch, so both tiers' averages share one clock
+                while (k->epochs < epoch) {
+                    time_average *averages[4] = {&state->gen_busy_avg, &state->gen_queue_avg,
+                                                 &state->spec_busy_avg, &state->spec_queue_avg};
+                    rebase_call_center_time(state->event_list, &state->general_waiting_queue,
+                                            &state->specific_waiting_queue, &state->patience_timers,
+                                            &state->in_service, averages);
+                    k->epochs++;
+                }
+                PROF_FLUSH();
+                return;
+            }
+        }
+    }
+}
+
+static call_center_stats CC_FN(run_call_center)(call_center_config config, int number_of_events) {
+    call_center_state state;
+    CC_FN(init_call_center_state)(config, &state);
+    CC_FN(advance_call_center)(config, &state, number_of_events);
+    return finish_call_center(&state);
+}
+
+#undef CC_HAS_PREEMPTION
+#undef CC_HAS_PATIENCE
+#undef CC_FN
+#undef CC_CONCAT
+#undef CC_CONCAT_
+
+#undef CC_VARIANT
+#undef CC_HAS_SPECIFIC_TIER
+#undef CC_NUM_GEN_OPR
+#undef CC_NUM_SPEC_OPR
+#undef CC_LENGTH_GEN_QUEUE
+#undef CC_ARRIVAL_RATE
+#undef CC_GENERAL_PURPOSE_RATIO
+#undef CC_GEN_MIN_DURATION_S
+#undef CC_GEN_AVG_DURATION_S
+#undef CC_GEN_MAX_DURATION_S
+#undef CC_SPEC_MIN_DURATION_S
+#undef CC_SPEC_AVG_DURATION_S
+#undef CC_SPEC_STD_DURATION_S
+#undef CC_SPEC_MAX_DURATION_S
+#undef CC_AREA_SPEC_MIN_DURATION_S
+#undef CC_AREA_SPEC_AVG_DURATION_S
+#undef CC_GEN_PATIENCE_AVG_S
+#undef CC_SPEC_PATIENCE_AVG_S
+#undef CC_PRIORITY_CLASSES
+#undef CC_PRIORITY_SHARES
+#undef CC_PREEMPTIVE
+#undef CC_ARRIVAL_PROCESS
+#undef CC_GENERAL_SERVICE
@@ -0,0 +1,227 @@
+#include "call_center_kw.h"
+#include "call_center_draws.h"
+#include "../system/kiefer_wolfowitz.h"
+#include "../models/profiling.h"
+
+static inline double kw_general_duration(call_center_config config, bool is_generic_only) {
+    if (is_generic_only) {
+        const generic_call_gen_only_config *gen = config.general_p_config->gen_call_gen_only_config;
+        return generate_exponential_duration(gen->gen_min_duration_s, gen->gen_avg_duration_s, true, gen->gen_max_duration_s);
+    }
+    const generic_call_specific_config *spec = config.general_p_config->gen_call_specific_config;
+    return generate_truncated_normal_duration(spec->spec_min_duration_s, spec->spec_avg_duration_s,
+                                              spec->spec_std_duration_s, spec->spec_max_duration_s);
+}
+
+static inline double kw_specific_duration(call_center_config config) {
+    if (call_center_has_general_service(config)) {
+        return generate_service_duration(config.area_service, config.area_spec_config->min_duration_s,
+                                         config.area_spec_config->avg_duration_s);
+    }
+    return generate_exponential_duration(config.area_spec_config->min_duration_s,
+                                         config.area_spec_config->avg_duration_s, false, 0);
+}
+
+// Busy time the servers of `st` still owe after `horizon`. Every call offered
+// arrived by the horizon, so a call starting later had waited and starts the
+// moment its server frees up: each server is busy without a gap from the
+// horizon to its free time.
+static double kw_busy_after(const kw_station *st, double horizon) {
+    double excess = 0.0;
+    for (int i = 0; i < st->free_at.size; i++) {
+        if (st->free_at.nodes[i].key > horizon) {
+            excess += st->free_at.nodes[i].key - horizon;
+        }
+    }
+    return excess;
+}
+
+typedef struct {
+    kw_station station;
+    time_average queue_avg;
+    double busy_time;
+    double total_elapsed_time_between_gen;
+    double total_specific;
+    const double *original_arrival;     // Indexed by the call's general arrival number
+} kw_specific_tier;
+
+// Charges every specific call that has left the queue by `now`
+static void kw_specific_advance(kw_specific_tier *tier, double now) {
+    kw_call started;
+    int level = kw_queue_length(&tier->station);
+    while (kw_pop_started(&tier->station, now, &started)) {
+        time_average_advance(&tier->queue_avg, started.start, level--);
+        tier->total_elapsed_time_between_gen += started.start - started.tag;
+        tier->total_specific++;
+    }
+    time_average_advance(&tier->queue_avg, now, level);
+}
+
+static void kw_specific_arrival(kw_specific_tier *tier, call_center_config config, double handover, int call_id) {
+    kw_specific_advance(tier, handover);
+
+    double original_arrival = tier->original_arrival[call_id];
+    double duration = kw_specific_duration(config);
+    double start = kw_admit(&tier->station, handover, duration, original_arrival);
+    tier->busy_time += duration;
+
+    // Calls that wait are counted when they leave the queue
+    if (start <= handover) {
+        tier->total_elapsed_time_between_gen += handover - original_arrival;
+        tier->total_specific++;
+    }
+}
+
+call_center_stats start_call_center_kw(call_center_config config, int number_of_events) {
+    int blocked_general_call = 0;
+    int delayed_general_call = 0;
+    double avg_gen_waiting_time = 0.0;
+    int current_gen_waiting_calls = 0;
+    double gen_busy_time = 0.0;
+    int generic_only_calls = 0;
+
+    delay_array delays;
+    init_delay_array(&delays);
+    hdr_histogram delay_histogram;
+    init_call_center_delay_histogram(&delay_histogram);
+
+    kw_station general;
+    init_kw_station(&general, config.number_of_gen_opr);
+    time_average gen_queue_avg;
+    init_time_average(&gen_queue_avg, config.length_gen_queue + 1);
+
+    double *original_arrival = malloc(number_of_events * sizeof(double));
+    if (!original_arrival) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    kw_specific_tier specific;
+    init_kw_station(&specific.station, config.number_of_spec_opr);
+    init_time_average(&specific.queue_avg, 16);
+    specific.busy_time = 0.0;
+    specific.total_elapsed_time_between_gen = 0.0;
+    specific.total_specific = 0.0;
+    specific.original_arrival = original_arrival;
+
+    // General departures that continue to the specific tier, keyed by hand-over time.
+    // A hand-over always follows the arrival that caused it, so by the time arrival t
+    // is processed every hand-over before t is known and can be fed in time order.
+    min_heap handovers;
+    init_min_heap(&handovers, config.number_of_gen_opr + 1);
+
+    double now = 0.0;
+    for (int i = 0; i < number_of_events; i++) {
+        PROF_EVENT_BEGIN(prof_start);
+        if (i > 0) {
+            now += next_poisson(1.0 / config.arrival_rate);
+        }
+        original_arrival[i] = now;
+
+        while (!min_heap_empty(&handovers) && min_heap_top(&handovers).key <= now) {
+            heap_node h = min_heap_pop(&handovers);
+            kw_specific_arrival(&specific, config, h.key, h.value);
+        }
+
+        // Waits become known, in FIFO order, once the waiting call has been answered
+        kw_call started;
+        int level = kw_queue_length(&general);
+        while (kw_pop_started(&general, now, &started)) {
+            time_average_advance(&gen_queue_avg, started.start, level--);
+            double waiting_time = started.start - started.arrival;
+            avg_gen_waiting_time = running_avg(++current_gen_waiting_calls, avg_gen_waiting_time, waiting_time);
+            delay d = {started.tag, waiting_time};
+            add_delay(&delays, d);
+            hdr_histogram_record(&delay_histogram, waiting_time);
+            call_center_trace_delay(d);
+        }
+        time_average_advance(&gen_queue_avg, now, level);
+
+        bool is_generic_only = is_general_call(config.general_purpose_ratio);
+        generic_only_calls += is_generic_only;
+        double prediction = 0.0;
+
+        if (kw_next_free(&general) > now) {
+            if (level >= config.length_gen_queue) {
+                blocked_general_call++;
+                PROF_EVENT_END(prof_start, PROF_EVENT_ARRIVAL);
+                continue;
+            }
+            delayed_general_call++;
+            prediction = level * avg_gen_waiting_time;
+            PROF_QUEUE_LENGTH(PROF_QUEUE_GENERAL, level + 1);
+        }
+
+        double duration = kw_general_duration(config, is_generic_only);
+        double start = kw_admit(&general, now, duration, prediction);
+        gen_busy_time += duration;
+
+        if (!is_generic_only) {
+            min_heap_push(&handovers, start + duration, i);
+        }
+        PROF_EVENT_END(prof_start, PROF_EVENT_ARRIVAL);
+    }
+    PROF_FLUSH();
+
+    // The run ends at the last arrival, like the event-driven engine
+    double horizon = now;
+    kw_specific_advance(&specific, horizon);
+
+    compensated_sum total_actual_delay = {0.0, 0.0};
+    compensated_sum total_abs_pred_error = {0.0, 0.0};
+    compensated_sum total_rel_pred_error = {0.0, 0.0};
+
+    for (size_t i = 0; i < delays.size; i++) {
+        double error = fabs(delays.data[i].predicted - delays.data[i].actual);
+        compensated_add(&total_actual_delay, delays.data[i].actual);
+        compensated_add(&total_abs_pred_error, error);
+        compensated_add(&total_rel_pred_error, error / fabs(delays.data[i].actual));
+    }
+
+    call_center_stats result;
+    general_purpose_stats general_result;
+    general_result.prob_call_delayed = (double)delayed_general_call / (double)number_of_events;
+    general_result.prob_call_lost = (double)blocked_general_call / (double)number_of_events;
+    general_result.prob_call_abandoned = 0.0;
+    general_result.prob_call_preempted = 0.0;
+    general_result.avg_delay_of_calls = (delays.size > 0) ? compensated_value(&total_actual_delay) / delays.size : 0.0;
+    general_result.avg_abs_prediction_error =
+        (delays.size > 0) ? compensated_value(&total_abs_pred_error) / delays.size : 0.0;
+    general_result.avg_rel_prediction_error =
+        (delays.size > 0) ? compensated_value(&total_rel_pred_error) / delays.size : 0.0;
+    general_result.delays = delays;
+    general_result.delay_histogram = delay_histogram;
+    general_result.avg_busy_operators = (horizon > 0.0) ? (gen_busy_time - kw_busy_after(&general, horizon)) / horizon : 0.0;
+    general_result.avg_queue_length = time_average_mean(&gen_queue_avg);
+    general_result.queue_length_distribution =
+        time_average_distribution(&gen_queue_avg, &general_result.queue_length_distribution_size);
+    // The first call arrives at time 0, so the horizon spans number_of_events - 1 gaps
+    general_result.mean_interarrival_time = (number_of_events > 1) ? horizon / (number_of_events - 1) : 0.0;
+    general_result.generic_only_fraction = (double)generic_only_calls / number_of_events;
+    // Every admitted call draws its duration on admission
+    general_result.mean_service_time =
+        (number_of_events > blocked_general_call) ? gen_busy_time / (number_of_events - blocked_general_call) : 0.0;
+
+    area_specific_stats specific_result;
+    specific_result.avg_answ_time = (specific.total_specific > 0) ? (specific.total_elapsed_time_between_gen / specific.total_specific) : 0.0;
+    specific_result.prob_call_abandoned = 0.0;
+    specific_result.prob_call_preempted = 0.0;
+    specific_result.avg_busy_operators =
+        (horizon > 0.0) ? (specific.busy_time - kw_busy_after(&specific.station, horizon)) / horizon : 0.0;
+    specific_result.avg_queue_length = time_average_mean(&specific.queue_avg);
+    specific_result.queue_length_distribution =
+        time_average_distribution(&specific.queue_avg, &specific_result.queue_length_distribution_size);
+
+    free_min_heap(&handovers);
+    free_time_average(&gen_queue_avg);
+    free_time_average(&specific.queue_avg);
+    free_kw_station(&general);
+    free_kw_station(&specific.station);
+    free(original_arrival);
+
+    result.general_p_stats = general_result;
+    result.area_spec_stats = specific_result;
+    result.n_priority_classes = 0;
+
+    return result;
+}
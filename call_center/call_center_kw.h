@@ -0,0 +1,11 @@
+#ifndef CALL_CENTER_KW_H
+#define CALL_CENTER_KW_H
+
+#include "call_center.h"
+
+// Alternative engine that runs both FIFO tiers through the Kiefer-Wolfowitz
+// recursion instead of an event list. Same inputs and statistics as
+// start_call_center(); results agree statistically, not draw for draw.
+call_center_stats start_call_center_kw(call_center_config config, int number_of_events);
+
+#endif // CALL_CENTER_KW_H
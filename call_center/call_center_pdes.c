@@ -0,0 +1,147 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "call_center_pdes.h"
+
+__thread call_center_channel *call_center_handoffs = NULL;
+
+void init_call_center_channel(call_center_channel *channel) {
+    init_spsc_ring(&channel->ring, CALL_CENTER_PDES_RING_ROWS, CALL_CENTER_PDES_WIDTH);
+    channel->n_pending = 0;
+}
+
+void free_call_center_channel(call_center_channel *channel) {
+    free_spsc_ring(&channel->ring);
+}
+
+static void flush_channel(call_center_channel *channel) {
+    while (!spsc_ring_try_push_rows(&channel->ring, channel->pending, channel->n_pending)) {
+        sched_yield();
+    }
+    channel->n_pending = 0;
+}
+
+void call_center_pdes_send(call_center_channel *channel, double kind, double time, int64_t epoch, const call *c) {
+    double *m = channel->pending + channel->n_pending * CALL_CENTER_PDES_WIDTH;
+    m[CALL_CENTER_PDES_KIND] = kind;
+    m[CALL_CENTER_PDES_TIME] = time;
+    m[CALL_CENTER_PDES_EPOCH] = (double)epoch;
+    m[CALL_CENTER_PDES_PRIORITY] = c->priority;
+    m[CALL_CENTER_PDES_GENERIC_ONLY] = c->gen_call.is_generic_only;
+    m[CALL_CENTER_PDES_ANSWER_TIME] = c->gen_call.answer_time;
+    m[CALL_CENTER_PDES_PREDICTION] = c->gen_call.prediction_waiting;
+    m[CALL_CENTER_PDES_ORIGINAL_ARRIVAL] = c->gen_call.original_arrival_time;
+    if (++channel->n_pending == CALL_CENTER_PDES_BATCH || kind == CALL_CENTER_PDES_END) {
+        flush_channel(channel);
+    }
+}
+
+size_t call_center_pdes_receive(call_center_channel *channel, double *rows, size_t max_rows) {
+    size_t n;
+    while ((n = spsc_ring_pop(&channel->ring, rows, max_rows)) == 0) {
+        sched_yield();
+    }
+    return n;
+}
+
+// The specialist tier's logical process: its own state and stream
+typedef struct {
+    call_center_config config;
+    call_center_state state;
+    call_center_channel *channel;
+    rng_state stream;
+    int antithetic;
+} specific_tier_process;
+
+// Empty state holding only the specialist tier; the general fields stay unused
+static void init_specific_tier(call_center_config config, call_center_state *state) {
+    memset(state, 0, sizeof(*state));
+    init_class_queue(&state->general_waiting_queue, config.priority_classes, 1);
+    init_class_queue(&state->specific_waiting_queue, config.priority_classes, 64);
+    init_event_set(&state->patience_timers, 16);
+    init_call_center_in_service(&state->in_service, config);
+    init_delay_array(&state->delays);
+    init_call_center_delay_histogram(&state->delay_histogram);
+    init_time_average(&state->gen_busy_avg, 1);
+    init_time_average(&state->gen_queue_avg, 1);
+    init_time_average(&state->spec_busy_avg, config.number_of_spec_opr + 1);
+    init_time_average(&state->spec_queue_avg, 16);
+}
+
+static void *specific_tier_main(void *arg) {
+    specific_tier_process *p = arg;
+    rng_set_state(&p->stream);
+    rng_set_antithetic(p->antithetic);
+    run_specific_tier(p->config, &p->state, p->channel);
+    rng_get_state(&p->stream);
+    return NULL;
+}
+
+// Moves the specialist tier's counters, queue and averages into the general
+// tier's state, whose own copies were never touched
+static void merge_specific_tier(call_center_state *state, specific_tier_process *p) {
+    call_center_counters *k = &state->counters;
+    const call_center_counters *s = &p->state.counters;
+    k->specific_opr_busy = s->specific_opr_busy;
+    k->in_queue_specific_call = s->in_queue_specific_call;
+    k->abandoned_specific_call = s->abandoned_specific_call;
+    k->preempted_specific_call = s->preempted_specific_call;
+    k->total_elapsed_time_between_gen = s->total_elapsed_time_between_gen;
+    k->total_specific = s->total_specific;
+    for (int i = 0; i < CALL_CENTER_MAX_PRIORITY_CLASSES; i++) {
+        k->classes[i].specific_answered = s->classes[i].specific_answered;
+        k->classes[i].specific_abandoned = s->classes[i].specific_abandoned;
+        k->classes[i].specific_elapsed_total = s->classes[i].specific_elapsed_total;
+    }
+    k->specific_stream = p->stream;
+
+    class_queue queue = state->specific_waiting_queue;
+    state->specific_waiting_queue = p->state.specific_waiting_queue;
+    p->state.specific_waiting_queue = queue;
+    time_average busy = state->spec_busy_avg, length = state->spec_queue_avg;
+    state->spec_busy_avg = p->state.spec_busy_avg;
+    state->spec_queue_avg = p->state.spec_queue_avg;
+    p->state.spec_busy_avg = busy;
+    p->state.spec_queue_avg = length;
+}
+
+call_center_stats start_call_center_pdes(call_center_config config, int number_of_events) {
+    config.tier_streams = true;
+    call_center_state state;
+    init_call_center_state(config, &state);
+
+    call_center_channel *channel = malloc(sizeof(call_center_channel));
+    if (!channel) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    init_call_center_channel(channel);
+
+    specific_tier_process specific;
+    specific.config = config;
+    specific.channel = channel;
+    specific.stream = state.counters.specific_stream;
+    specific.antithetic = rng_get_antithetic();
+    init_specific_tier(config, &specific.state);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, specific_tier_main, &specific) != 0) {
+        perror("pthread_create failed");
+        exit(EXIT_FAILURE);
+    }
+
+    call_center_handoffs = channel;
+    advance_call_center(config, &state, number_of_events);
+    call_center_handoffs = NULL;
+    const call no_call = {GENERAL_PURPOSE, {false, 0.0, 0.0, 0.0, 0.0}, 0, 0.0, EVENT_HANDLE_NONE, false};
+    call_center_pdes_send(channel, CALL_CENTER_PDES_END, state.gen_busy_avg.last_time, state.counters.epochs,
+                          &no_call);
+    pthread_join(thread, NULL);
+
+    merge_specific_tier(&state, &specific);
+    free_call_center_state(&specific.state);
+    free_call_center_channel(channel);
+    free(channel);
+    return finish_call_center(&state);
+}
@@ -0,0 +1,77 @@
+#ifndef CALL_CENTER_PDES_H
+#define CALL_CENTER_PDES_H
+
+#include "call_center.h"
+#include "../models/spsc_ring.h"
+
+// Conservative parallel discrete-event simulation of the two tiers. The
+// general tier runs on the calling thread and the specialist tier on a thread
+// of its own, each a logical process with its own event list and patience
+// timers. The tiers only meet where a general call is handed to the
+// specialists, always at the general tier's current time, so the hand-offs
+// leave in timestamp order and each one promises that no earlier one follows.
+// That is the lookahead: the specialist tier processes its own events up to
+// the next hand-off and waits only when none is queued. No null messages are
+// needed since nothing flows back.
+//
+// Messages are rows of doubles on a lock-free single-producer/single-consumer
+// ring, sent in batches of CALL_CENTER_PDES_BATCH. A run uses
+// config.tier_streams, so the specialists draw from their own stream, and
+// matches start_call_center with tier_streams set draw for draw. The only
+// exception is a hand-off at exactly the time of a specialist departure
+// (probability 0 with continuous laws), which the parallel run takes first.
+
+#define CALL_CENTER_PDES_RING_ROWS 16384
+#define CALL_CENTER_PDES_BATCH 64
+
+// Columns of a message
+enum {
+    CALL_CENTER_PDES_KIND,              // CALL_CENTER_PDES_HANDOFF or CALL_CENTER_PDES_END
+    CALL_CENTER_PDES_TIME,              // In the sender's epoch
+    CALL_CENTER_PDES_EPOCH,             // Times the sender's clock was rebased
+    CALL_CENTER_PDES_PRIORITY,
+    CALL_CENTER_PDES_GENERIC_ONLY,
+    CALL_CENTER_PDES_ANSWER_TIME,
+    CALL_CENTER_PDES_PREDICTION,
+    CALL_CENTER_PDES_ORIGINAL_ARRIVAL,
+    CALL_CENTER_PDES_WIDTH
+};
+
+#define CALL_CENTER_PDES_HANDOFF 0.0
+#define CALL_CENTER_PDES_END 1.0        // Clock of the general tier when it stopped
+
+// One direction of traffic: the ring plus the sender's partly filled batch
+typedef struct {
+    spsc_ring ring;
+    double pending[CALL_CENTER_PDES_BATCH * CALL_CENTER_PDES_WIDTH];
+    int n_pending;
+} call_center_channel;
+
+// While set, general calls handed to the specialist tier are sent to this
+// channel instead of being handled in place (per thread; NULL disables)
+extern __thread call_center_channel *call_center_handoffs;
+
+void init_call_center_channel(call_center_channel *channel);
+void free_call_center_channel(call_center_channel *channel);
+// Queues a message; the batch goes out when full or with CALL_CENTER_PDES_END
+void call_center_pdes_send(call_center_channel *channel, double kind, double time, int64_t epoch, const call *c);
+// Waits for at least one message and pops up to max_rows of them
+size_t call_center_pdes_receive(call_center_channel *channel, double *rows, size_t max_rows);
+
+// The handed-off call of a message, its times moved by `offset`
+static inline call call_center_pdes_call(const double *m, double offset) {
+    struct general_call gen_call = {m[CALL_CENTER_PDES_GENERIC_ONLY] != 0.0,
+                                    m[CALL_CENTER_PDES_ANSWER_TIME] + offset,
+                                    m[CALL_CENTER_PDES_PREDICTION],
+                                    m[CALL_CENTER_PDES_ORIGINAL_ARRIVAL] + offset, 0.0};
+    call c = {GENERAL_PURPOSE, gen_call, (int)m[CALL_CENTER_PDES_PRIORITY], 0.0, EVENT_HANDLE_NONE, false};
+    return c;
+}
+
+// Specialist tier of a parallel run, on the calling thread (call_center.c)
+void run_specific_tier(call_center_config config, call_center_state *state, call_center_channel *channel);
+
+// start_call_center with the tiers on two threads; sets config.tier_streams
+call_center_stats start_call_center_pdes(call_center_config config, int number_of_events);
+
+#endif // CALL_CENTER_PDES_H
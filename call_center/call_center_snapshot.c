@@ -0,0 +1,369 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "call_center_snapshot.h"
+
+typedef struct {
+    char magic[8];
+    uint32_t results_version;       // CALL_CENTER_RESULTS_VERSION of the writer
+    uint32_t counters_size;         // sizeof(call_center_counters), guards layout changes
+    int32_t number_of_gen_opr;      // Configuration the state was produced with
+    int32_t number_of_spec_opr;
+    int32_t length_gen_queue;
+    int32_t antithetic;
+    int32_t priority_classes;
+    int32_t arrival_kind;
+    double arrival_rate;
+    rng_state rng;
+    call_center_counters counters;
+} snapshot_header;
+
+// One call_list node without its pointer
+typedef struct {
+    double time;
+    double answer_time;
+    double prediction_waiting;
+    double original_arrival_time;
+    double service_start;
+    double patience_deadline;       // Abandonment time of a queued call, 0 when none is pending
+    double remaining_service;
+    int32_t type;
+    int32_t call_type;
+    int32_t is_generic_only;
+    int32_t abandoned;
+    int32_t priority;
+    int32_t reserved;
+} snapshot_event;
+
+// Queued calls pass their patience timers, which are saved as the call's deadline
+static int write_event(FILE *file, const call_list *p, const event_set *timers) {
+    bool queued = timers != NULL && !p->c.abandoned;
+    double deadline = (queued && p->c.patience_timer != EVENT_HANDLE_NONE)
+                          ? event_set_time(timers, p->c.patience_timer) : 0.0;
+    snapshot_event e = {p->time, p->c.gen_call.answer_time, p->c.gen_call.prediction_waiting,
+                        p->c.gen_call.original_arrival_time, p->c.gen_call.service_start, deadline, p->c.remaining_service, p->type,
+                        (int32_t)p->c.type, p->c.gen_call.is_generic_only, timers != NULL && p->c.abandoned,
+                        p->c.priority, 0};
+    return (fwrite(&e, sizeof(e), 1, file) == 1) ? 0 : -1;
+}
+
+// Reads one node, rescheduling its patience timer in *timers (NULL outside queues)
+static call_list *read_event(FILE *file, event_set *timers) {
+    snapshot_event e;
+    if (fread(&e, sizeof(e), 1, file) != 1) {
+        return NULL;
+    }
+    struct general_call gen_call = {e.is_generic_only != 0, e.answer_time, e.prediction_waiting, e.original_arrival_time,
+                                    e.service_start};
+    call c = {(CALL_TYPE)e.call_type, gen_call, e.priority, e.remaining_service, EVENT_HANDLE_NONE, e.abandoned != 0};
+    call_list *node = _node(e.type, e.time, c);
+    if (timers != NULL && e.patience_deadline > 0.0) {
+        node->c.patience_timer = event_set_schedule(timers, e.patience_deadline, node);
+    }
+    return node;
+}
+
+// Departures of preempted calls are left out
+static int write_list(FILE *file, const call_list *list) {
+    uint64_t count = 0;
+    for (const call_list *p = list; p != NULL; p = p->next) {
+        count += !p->c.abandoned;
+    }
+    if (fwrite(&count, sizeof(count), 1, file) != 1) {
+        return -1;
+    }
+    for (const call_list *p = list; p != NULL; p = p->next) {
+        if (!p->c.abandoned && write_event(file, p, NULL) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Rebuilds a list in saved (time) order by appending at the tail
+static int read_list(FILE *file, call_list **list) {
+    uint64_t count;
+    call_list **tail = list;
+
+    *list = NULL;
+    if (fread(&count, sizeof(count), 1, file) != 1) {
+        return -1;
+    }
+    for (uint64_t i = 0; i < count; i++) {
+        call_list *node = read_event(file, NULL);
+        if (node == NULL) {
+            return -1;
+        }
+        *tail = node;
+        tail = &node->next;
+    }
+    return 0;
+}
+
+// Queued calls class by class, each class in service order
+static int write_queue(FILE *file, const class_queue *queue, const event_set *timers) {
+    uint64_t count = (uint64_t)queue->size;
+    if (fwrite(&count, sizeof(count), 1, file) != 1) {
+        return -1;
+    }
+    for (int k = 0; k < queue->n_classes; k++) {
+        for (uint32_t i = 0; i < class_queue_class_size(queue, k); i++) {
+            if (write_event(file, class_queue_at(queue, k, i), timers) != 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int read_queue(FILE *file, class_queue *queue, event_set *timers) {
+    uint64_t count;
+    if (fread(&count, sizeof(count), 1, file) != 1) {
+        return -1;
+    }
+    for (uint64_t i = 0; i < count; i++) {
+        call_list *node = read_event(file, timers);
+        if (node == NULL) {
+            return -1;
+        }
+        if (node->c.priority < 0 || node->c.priority >= queue->n_classes) {
+            event_set_cancel(timers, node->c.patience_timer);
+            free(node);
+            return -1;
+        }
+        class_queue_push(queue, node->c.priority, node);
+    }
+    return 0;
+}
+
+// Position of a non-Poisson arrival process, followed by its unread gaps
+typedef struct {
+    double phase_left;
+    int32_t phase;
+    int32_t batch_left;
+    uint32_t buffered;
+    uint32_t reserved;
+} snapshot_arrivals;
+
+static int write_arrivals(FILE *file, const arrival_process *p) {
+    snapshot_arrivals a = {p->phase_left, p->phase, p->batch_left, p->count - p->head, 0};
+    return (fwrite(&a, sizeof(a), 1, file) == 1 &&
+            fwrite(p->gaps + p->head, sizeof(double), a.buffered, file) == a.buffered) ? 0 : -1;
+}
+
+// *p is already initialized for the configuration
+static int read_arrivals(FILE *file, arrival_process *p) {
+    snapshot_arrivals a;
+    if (fread(&a, sizeof(a), 1, file) != 1 || a.buffered > ARRIVAL_BLOCK ||
+        a.phase < 0 || a.phase >= ARRIVAL_MAX_PHASES ||
+        (p->config->kind == ARRIVAL_MMPP && a.phase >= p->config->n_phases)) {
+        return -1;
+    }
+    p->phase_left = a.phase_left;
+    p->phase = a.phase;
+    p->batch_left = a.batch_left;
+    p->head = 0;
+    p->count = a.buffered;
+    return (fread(p->gaps, sizeof(double), a.buffered, file) == a.buffered) ? 0 : -1;
+}
+
+// The histogram is saved whole: in long-run mode there are no delays to rebuild it from
+static int write_histogram(FILE *file, const hdr_histogram *h) {
+    int32_t n_buckets = h->n_buckets;
+    double stats[3] = {h->min, h->max, h->sum};
+    return (fwrite(&n_buckets, sizeof(n_buckets), 1, file) == 1 &&
+            fwrite(h->counts, sizeof(uint64_t), n_buckets, file) == (size_t)n_buckets &&
+            fwrite(&h->total, sizeof(h->total), 1, file) == 1 &&
+            fwrite(stats, sizeof(double), 3, file) == 3) ? 0 : -1;
+}
+
+// h must be initialized with the layout it was saved with
+static int read_histogram(FILE *file, hdr_histogram *h) {
+    int32_t n_buckets;
+    double stats[3];
+    if (fread(&n_buckets, sizeof(n_buckets), 1, file) != 1 || n_buckets != h->n_buckets ||
+        fread(h->counts, sizeof(uint64_t), n_buckets, file) != (size_t)n_buckets ||
+        fread(&h->total, sizeof(h->total), 1, file) != 1 || fread(stats, sizeof(double), 3, file) != 3) {
+        return -1;
+    }
+    h->min = stats[0];
+    h->max = stats[1];
+    h->sum = stats[2];
+    return 0;
+}
+
+static int write_time_average(FILE *file, const time_average *ta) {
+    double times[3] = {ta->start_time, ta->last_time, ta->area};
+    int32_t size = ta->size;
+    if (fwrite(times, sizeof(double), 3, file) != 3 || fwrite(&size, sizeof(size), 1, file) != 1 ||
+        fwrite(ta->time_at, sizeof(double), size, file) != (size_t)size) {
+        return -1;
+    }
+    return 0;
+}
+
+// ta must be initialized; it grows to the saved number of levels
+static int read_time_average(FILE *file, time_average *ta) {
+    double times[3];
+    int32_t size;
+    if (fread(times, sizeof(double), 3, file) != 3 || fread(&size, sizeof(size), 1, file) != 1 || size < 0) {
+        return -1;
+    }
+    if (size > 0 && size - 1 >= ta->capacity) {
+        grow_time_average(ta, size - 1);
+    }
+    if (fread(ta->time_at, sizeof(double), size, file) != (size_t)size) {
+        return -1;
+    }
+    ta->start_time = times[0];
+    ta->last_time = times[1];
+    ta->area = times[2];
+    ta->size = size;
+    return 0;
+}
+
+int save_call_center_snapshot(const char *path, call_center_config config, const call_center_state *state) {
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE *file = fopen(tmp_path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+
+    snapshot_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CALL_CENTER_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.results_version = CALL_CENTER_RESULTS_VERSION;
+    header.counters_size = sizeof(call_center_counters);
+    header.number_of_gen_opr = config.number_of_gen_opr;
+    header.number_of_spec_opr = config.number_of_spec_opr;
+    header.length_gen_queue = config.length_gen_queue;
+    header.antithetic = rng_get_antithetic();
+    header.priority_classes = state->general_waiting_queue.n_classes;
+    header.arrival_kind = call_center_has_arrival_process(config) ? (int32_t)config.arrival_config->kind : ARRIVAL_POISSON;
+    header.arrival_rate = config.arrival_rate;
+    rng_get_state(&header.rng);
+    header.counters = state->counters;
+
+    uint64_t n_delays = state->delays.size;
+    int failed = fwrite(&header, sizeof(header), 1, file) != 1 ||
+                 write_list(file, state->event_list) != 0 ||
+                 write_queue(file, &state->general_waiting_queue, &state->patience_timers) != 0 ||
+                 write_queue(file, &state->specific_waiting_queue, &state->patience_timers) != 0 ||
+                 (header.arrival_kind != ARRIVAL_POISSON && write_arrivals(file, &state->arrivals) != 0) ||
+                 fwrite(&n_delays, sizeof(n_delays), 1, file) != 1 ||
+                 fwrite(state->delays.data, sizeof(delay), n_delays, file) != n_delays ||
+                 write_histogram(file, &state->delay_histogram) != 0 ||
+                 write_time_average(file, &state->gen_busy_avg) != 0 ||
+                 write_time_average(file, &state->gen_queue_avg) != 0 ||
+                 write_time_average(file, &state->spec_busy_avg) != 0 ||
+                 write_time_average(file, &state->spec_queue_avg) != 0;
+    if (fclose(file) != 0) {
+        failed = 1;
+    }
+    if (failed || rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+int load_call_center_snapshot(const char *path, call_center_config config, call_center_state *state) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return -1;
+    }
+
+    snapshot_header header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, CALL_CENTER_SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.results_version != CALL_CENTER_RESULTS_VERSION ||
+        header.counters_size != sizeof(call_center_counters)) {
+        fprintf(stderr, "Error: %s is not a snapshot of this engine version\n", path);
+        fclose(file);
+        return -1;
+    }
+    if (header.counters.general_opr_busy > config.number_of_gen_opr ||
+        header.counters.specific_opr_busy > config.number_of_spec_opr ||
+        header.counters.in_queue_general_call > config.length_gen_queue ||
+        header.priority_classes > ((config.priority_classes > 1) ? config.priority_classes : 1)) {
+        fprintf(stderr, "Error: %s holds %d general / %d specific busy operators, %d queued calls and "
+                "%d priority classes, more than the configuration allows\n", path, header.counters.general_opr_busy,
+                header.counters.specific_opr_busy, header.counters.in_queue_general_call, header.priority_classes);
+        fclose(file);
+        return -1;
+    }
+    int32_t kind = call_center_has_arrival_process(config) ? (int32_t)config.arrival_config->kind : ARRIVAL_POISSON;
+    if (header.arrival_kind != kind) {
+        fprintf(stderr, "Error: %s was saved with %s arrivals, the configuration has %s arrivals\n", path,
+                (header.arrival_kind >= ARRIVAL_POISSON && header.arrival_kind <= ARRIVAL_RENEWAL)
+                    ? arrival_kind_name((arrival_kind)header.arrival_kind) : "unknown",
+                arrival_kind_name((arrival_kind)kind));
+        fclose(file);
+        return -1;
+    }
+
+    // Sized for the new configuration, then filled from the file
+    call_center_state restored;
+    restored.counters = header.counters;
+    // Both estimates are kept up to date, so the run may switch predictors here
+    restored.counters.predictor.kind = config.wait_predictor;
+    init_event_set(&restored.patience_timers, config.length_gen_queue + 16);
+    init_call_center_in_service(&restored.in_service, config);
+    init_delay_array(&restored.delays);
+    init_call_center_delay_histogram(&restored.delay_histogram);
+    init_time_average(&restored.gen_busy_avg, config.number_of_gen_opr + 1);
+    init_time_average(&restored.gen_queue_avg, config.length_gen_queue + 1);
+    init_time_average(&restored.spec_busy_avg, config.number_of_spec_opr + 1);
+    init_time_average(&restored.spec_queue_avg, 16);
+    restored.event_list = NULL;
+    init_class_queue(&restored.general_waiting_queue, config.priority_classes, config.length_gen_queue + 1);
+    init_class_queue(&restored.specific_waiting_queue, config.priority_classes, 64);
+    memset(&restored.arrivals, 0, sizeof(restored.arrivals));
+    if (kind != ARRIVAL_POISSON) {
+        init_arrival_process(&restored.arrivals, config.arrival_config, config.arrival_rate);
+    }
+
+    uint64_t n_delays = 0;
+    int failed = read_list(file, &restored.event_list) != 0 ||
+                 read_queue(file, &restored.general_waiting_queue, &restored.patience_timers) != 0 ||
+                 read_queue(file, &restored.specific_waiting_queue, &restored.patience_timers) != 0 ||
+                 (kind != ARRIVAL_POISSON && read_arrivals(file, &restored.arrivals) != 0) ||
+                 fread(&n_delays, sizeof(n_delays), 1, file) != 1;
+    if (!failed && n_delays > restored.delays.capacity) {
+        delay *data = realloc(restored.delays.data, n_delays * sizeof(delay));
+        if (!data) {
+            perror("realloc failed");
+            exit(EXIT_FAILURE);
+        }
+        restored.delays.data = data;
+        restored.delays.capacity = n_delays;
+    }
+    if (!failed) {
+        failed = fread(restored.delays.data, sizeof(delay), n_delays, file) != n_delays;
+        restored.delays.size = n_delays;
+    }
+    failed = failed ||
+             read_histogram(file, &restored.delay_histogram) != 0 ||
+             read_time_average(file, &restored.gen_busy_avg) != 0 ||
+             read_time_average(file, &restored.gen_queue_avg) != 0 ||
+             read_time_average(file, &restored.spec_busy_avg) != 0 ||
+             read_time_average(file, &restored.spec_queue_avg) != 0;
+    fclose(file);
+
+    if (!failed && call_center_has_preemption(config)) {
+        index_call_center_in_service(&restored.in_service, restored.event_list);
+    }
+    if (failed || restored.event_list == NULL) {
+        fprintf(stderr, "Error: %s is truncated or corrupt\n", path);
+        free_call_center_state(&restored);
+        return -1;
+    }
+
+    *state = restored;
+    rng_set_state(&header.rng);
+    rng_set_antithetic(header.antithetic);
+    return 0;
+}
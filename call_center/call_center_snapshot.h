@@ -0,0 +1,24 @@
+#ifndef CALL_CENTER_SNAPSHOT_H
+#define CALL_CENTER_SNAPSHOT_H
+
+#include "call_center.h"
+
+// Binary snapshot of a paused event-list engine run: the call_center_state
+// (event list, queues with their patience deadlines, buffered arrival gaps,
+// occupancy, counters, delays and their histogram, time averages, the clock's
+// epoch) plus the calling thread's RNG
+// stream, so a restored run continues exactly where the saved one stopped.
+// Snapshots are host-endian and tied to the engine version.
+
+#define CALL_CENTER_SNAPSHOT_MAGIC "TSSNAP06"
+
+// Writes atomically (temporary file + rename). Returns 0 on success.
+int save_call_center_snapshot(const char *path, call_center_config config, const call_center_state *state);
+
+// Restores a snapshot into *state and the thread's RNG stream. The config must
+// hold everything in the snapshot: as many operators as are busy, room for
+// every queued call and its priority classes, and the same kind of arrival
+// process. Returns 0 on success; *state is untouched on failure.
+int load_call_center_snapshot(const char *path, call_center_config config, call_center_state *state);
+
+#endif // CALL_CENTER_SNAPSHOT_H
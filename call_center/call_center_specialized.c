@@ -0,0 +1,83 @@
+#include "call_center_specialized.h"
+#include "../constants.h"
+
+// The scenario is frozen at build time. Override on the compiler command line,
+// e.g. make specialized SPEC_GEN_OPR=4 SPEC_SPEC_OPR=5 SPEC_QUEUE_LEN=8
+#ifndef CC_SPEC_GEN_OPR
+#    define CC_SPEC_GEN_OPR 3
+#endif
+#ifndef CC_SPEC_SPEC_OPR
+#    define CC_SPEC_SPEC_OPR 4
+#endif
+#ifndef CC_SPEC_QUEUE_LEN
+#    define CC_SPEC_QUEUE_LEN 5
+#endif
+#ifndef CC_SPEC_TIERS
+#    define CC_SPEC_TIERS 2
+#endif
+
+#if CC_SPEC_TIERS != 1 && CC_SPEC_TIERS != 2
+#    error "CC_SPEC_TIERS must be 1 (general tier only) or 2"
+#endif
+
+#define CC_STRINGIFY_(x) #x
+#define CC_STRINGIFY(x) CC_STRINGIFY_(x)
+
+#define CC_VARIANT specialized
+#define CC_HAS_SPECIFIC_TIER (CC_SPEC_TIERS == 2)
+#define CC_NUM_GEN_OPR CC_SPEC_GEN_OPR
+#define CC_NUM_SPEC_OPR CC_SPEC_SPEC_OPR
+#define CC_LENGTH_GEN_QUEUE CC_SPEC_QUEUE_LEN
+#define CC_ARRIVAL_RATE ARRIVAL_RATE
+#define CC_GENERAL_PURPOSE_RATIO GENERAL_PURPOSE_RATIO
+#define CC_GEN_MIN_DURATION_S GEN_CALL_MIN_DURATION_S
+#define CC_GEN_AVG_DURATION_S GEN_CALL_AVG_DURATION_S
+#define CC_GEN_MAX_DURATION_S GEN_CALL_MAX_DURATION_S
+#define CC_SPEC_MIN_DURATION_S SPEC_MIN_DURATION_S
+#define CC_SPEC_AVG_DURATION_S SPEC_AVG_DURATION_S
+#define CC_SPEC_STD_DURATION_S SPEC_STD_DURATION_S
+#define CC_SPEC_MAX_DURATION_S SPEC_MAX_DURATION_S
+#define CC_AREA_SPEC_MIN_DURATION_S AREA_SPEC_MIN_DURATION_S
+#define CC_AREA_SPEC_AVG_DURATION_S AREA_SPEC_AVG_DURATION_S
+#define CC_GEN_PATIENCE_AVG_S 0.0
+#define CC_SPEC_PATIENCE_AVG_S 0.0
+#define CC_PRIORITY_CLASSES 1
+#define CC_PRIORITY_SHARES (config.priority_shares)
+#define CC_PREEMPTIVE 0
+#define CC_ARRIVAL_PROCESS 0
+#define CC_GENERAL_SERVICE 0
+#include "call_center_engine.h"
+
+call_center_stats start_call_center_specialized(call_center_config config, int number_of_events) {
+    return run_call_center_specialized(config, number_of_events);
+}
+
+// True when the runtime config describes exactly the frozen scenario, i.e. the
+// specialized engine produces the same results as start_call_center
+bool call_center_specialized_matches(call_center_config config) {
+    return CC_SPEC_TIERS == 2 &&
+           config.number_of_gen_opr == CC_SPEC_GEN_OPR &&
+           config.number_of_spec_opr == CC_SPEC_SPEC_OPR &&
+           config.length_gen_queue == CC_SPEC_QUEUE_LEN &&
+           config.arrival_rate == ARRIVAL_RATE &&
+           config.general_purpose_ratio == GENERAL_PURPOSE_RATIO &&
+           config.general_p_config->gen_call_gen_only_config->gen_min_duration_s == GEN_CALL_MIN_DURATION_S &&
+           config.general_p_config->gen_call_gen_only_config->gen_avg_duration_s == GEN_CALL_AVG_DURATION_S &&
+           config.general_p_config->gen_call_gen_only_config->gen_max_duration_s == GEN_CALL_MAX_DURATION_S &&
+           config.general_p_config->gen_call_specific_config->spec_min_duration_s == SPEC_MIN_DURATION_S &&
+           config.general_p_config->gen_call_specific_config->spec_avg_duration_s == SPEC_AVG_DURATION_S &&
+           config.general_p_config->gen_call_specific_config->spec_std_duration_s == SPEC_STD_DURATION_S &&
+           config.general_p_config->gen_call_specific_config->spec_max_duration_s == SPEC_MAX_DURATION_S &&
+           config.area_spec_config->min_duration_s == AREA_SPEC_MIN_DURATION_S &&
+           config.area_spec_config->avg_duration_s == AREA_SPEC_AVG_DURATION_S &&
+           config.gen_patience_avg_s == 0.0 && config.spec_patience_avg_s == 0.0 &&
+           config.priority_classes <= 1 && !call_center_has_arrival_process(config) &&
+           !call_center_has_general_service(config);
+}
+
+const char *call_center_specialized_name(void) {
+    return "gen=" CC_STRINGIFY(CC_SPEC_GEN_OPR)
+           " spec=" CC_STRINGIFY(CC_SPEC_SPEC_OPR)
+           " queue=" CC_STRINGIFY(CC_SPEC_QUEUE_LEN)
+           " tiers=" CC_STRINGIFY(CC_SPEC_TIERS);
+}
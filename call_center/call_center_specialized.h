@@ -0,0 +1,13 @@
+#ifndef CALL_CENTER_SPECIALIZED_H
+#define CALL_CENTER_SPECIALIZED_H
+
+#include "call_center.h"
+
+// Engine compiled for one frozen scenario (see `make specialized`). Operator
+// counts, queue length, tiers and duration parameters are compile-time
+// constants, so only the config argument's layout is used.
+call_center_stats start_call_center_specialized(call_center_config config, int number_of_events);
+bool call_center_specialized_matches(call_center_config config);
+const char *call_center_specialized_name(void);
+
+#endif // CALL_CENTER_SPECIALIZED_H
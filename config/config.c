@@ -0,0 +1,490 @@
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stddef.h>
+#include <string.h>
+#include "config.h"
+#include "../constants.h"
+#include "../optimize_param.h"
+
+#define CONFIG_LINE_LEN 512
+#define CONFIG_MAX_LIST_LEN CALL_CENTER_MAX_PRIORITY_CLASSES  // Longest list value
+
+typedef enum {
+    CFG_DOUBLE,
+    CFG_INT,
+    CFG_CLASS_LIST,         // Comma-separated doubles, one per priority class
+    CFG_PHASE_LIST,         // Comma-separated doubles, one per MMPP phase
+    CFG_ARRIVAL_KIND,       // Name of an arrival process
+    CFG_RENEWAL_FILE,       // Path of an inter-arrival sample, loaded into the arrival_config
+    CFG_SERVICE_KIND,       // Name of a service-time law
+    CFG_SERVICE_FILE,       // Path of a holding-time sample, fitted into the service_dist
+} config_value_type;
+
+typedef struct {
+    const char *key;
+    config_value_type type;
+    size_t offset;
+} config_key;
+
+// Every key accepted in config and batch files. Keys are unique across
+// sections, so sections only group related keys for readability.
+static const config_key config_keys[] = {
+    // [call_center]
+    {"arrival_rate_per_hour", CFG_DOUBLE, offsetof(scenario_config, arrival_rate_per_hour)},
+    {"general_purpose_ratio", CFG_DOUBLE, offsetof(scenario_config, call_center.general_purpose_ratio)},
+    {"gen_call_min_duration_s", CFG_DOUBLE, offsetof(scenario_config, gen_call_only.gen_min_duration_s)},
+    {"gen_call_avg_duration_s", CFG_DOUBLE, offsetof(scenario_config, gen_call_only.gen_avg_duration_s)},
+    {"gen_call_max_duration_s", CFG_DOUBLE, offsetof(scenario_config, gen_call_only.gen_max_duration_s)},
+    {"spec_min_duration_s", CFG_DOUBLE, offsetof(scenario_config, gen_call_specific.spec_min_duration_s)},
+    {"spec_avg_duration_s", CFG_DOUBLE, offsetof(scenario_config, gen_call_specific.spec_avg_duration_s)},
+    {"spec_std_duration_s", CFG_DOUBLE, offsetof(scenario_config, gen_call_specific.spec_std_duration_s)},
+    {"spec_max_duration_s", CFG_DOUBLE, offsetof(scenario_config, gen_call_specific.spec_max_duration_s)},
+    {"area_spec_min_duration_s", CFG_DOUBLE, offsetof(scenario_config, area_spec.min_duration_s)},
+    {"area_spec_avg_duration_s", CFG_DOUBLE, offsetof(scenario_config, area_spec.avg_duration_s)},
+    {"number_of_gen_opr", CFG_INT, offsetof(scenario_config, call_center.number_of_gen_opr)},
+    {"number_of_spec_opr", CFG_INT, offsetof(scenario_config, call_center.number_of_spec_opr)},
+    {"length_gen_queue", CFG_INT, offsetof(scenario_config, call_center.length_gen_queue)},
+    {"gen_patience_avg_s", CFG_DOUBLE, offsetof(scenario_config, call_center.gen_patience_avg_s)},
+    {"spec_patience_avg_s", CFG_DOUBLE, offsetof(scenario_config, call_center.spec_patience_avg_s)},
+    {"priority_shares", CFG_CLASS_LIST, offsetof(scenario_config, call_center.priority_shares)},
+    {"priority_preemptive", CFG_INT, offsetof(scenario_config, call_center.priority_preemptive)},
+    {"arrival_process", CFG_ARRIVAL_KIND, offsetof(scenario_config, arrivals.kind)},
+    {"mmpp_rate_levels", CFG_PHASE_LIST, offsetof(scenario_config, arrivals.mmpp_levels)},
+    {"mmpp_sojourn_s", CFG_PHASE_LIST, offsetof(scenario_config, arrivals.mmpp_sojourn_s)},
+    {"batch_mean_size", CFG_DOUBLE, offsetof(scenario_config, arrivals.batch_mean_size)},
+    {"renewal_gaps_file", CFG_RENEWAL_FILE, offsetof(scenario_config, arrivals)},
+    {"area_spec_distribution", CFG_SERVICE_KIND, offsetof(scenario_config, area_service.kind)},
+    {"area_spec_cv", CFG_DOUBLE, offsetof(scenario_config, area_service.cv)},
+    {"area_spec_samples_file", CFG_SERVICE_FILE, offsetof(scenario_config, area_service)},
+    {"erlang_service_distribution", CFG_SERVICE_KIND, offsetof(scenario_config, erlang_service.kind)},
+    {"erlang_service_cv", CFG_DOUBLE, offsetof(scenario_config, erlang_service.cv)},
+    {"erlang_service_samples_file", CFG_SERVICE_FILE, offsetof(scenario_config, erlang_service)},
+    // [simulation]
+    {"number_of_events", CFG_INT, offsetof(scenario_config, simulation.number_of_events)},
+    {"random_seed", CFG_INT, offsetof(scenario_config, simulation.random_seed)},
+    {"warmup_events", CFG_INT, offsetof(scenario_config, simulation.warmup_events)},
+    {"checkpoint_events", CFG_INT, offsetof(scenario_config, simulation.checkpoint_events)},
+    {"num_replications", CFG_INT, offsetof(scenario_config, simulation.num_replications)},
+    {"min_arrival_rate", CFG_DOUBLE, offsetof(scenario_config, simulation.min_arrival_rate)},
+    {"max_arrival_rate", CFG_DOUBLE, offsetof(scenario_config, simulation.max_arrival_rate)},
+    {"arrival_rate_step", CFG_DOUBLE, offsetof(scenario_config, simulation.arrival_rate_step)},
+    // [optimization]
+    {"target_prob_delayed", CFG_DOUBLE, offsetof(scenario_config, optimization.target_prob_delayed)},
+    {"target_prob_lost", CFG_DOUBLE, offsetof(scenario_config, optimization.target_prob_lost)},
+    {"target_avg_delay_s", CFG_DOUBLE, offsetof(scenario_config, optimization.target_avg_delay_s)},
+    {"target_total_delay_s", CFG_DOUBLE, offsetof(scenario_config, optimization.target_total_delay_s)},
+    {"min_gen_opr", CFG_INT, offsetof(scenario_config, optimization.min_gen_opr)},
+    {"max_gen_opr", CFG_INT, offsetof(scenario_config, optimization.max_gen_opr)},
+    {"min_spec_opr", CFG_INT, offsetof(scenario_config, optimization.min_spec_opr)},
+    {"max_spec_opr", CFG_INT, offsetof(scenario_config, optimization.max_spec_opr)},
+    {"min_queue_len", CFG_INT, offsetof(scenario_config, optimization.min_queue_len)},
+    {"max_queue_len", CFG_INT, offsetof(scenario_config, optimization.max_queue_len)},
+    {"surrogate_budget", CFG_INT, offsetof(scenario_config, optimization.surrogate_budget)},
+    {"surrogate_initial_points", CFG_INT, offsetof(scenario_config, optimization.surrogate_initial_points)},
+};
+
+#define NUM_CONFIG_KEYS (sizeof(config_keys) / sizeof(config_keys[0]))
+
+void default_scenario_config(scenario_config *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    strcpy(cfg->name, "default");
+
+    cfg->arrival_rate_per_hour = ARRIVAL_RATE_PER_HOUR;
+    cfg->call_center.general_purpose_ratio = GENERAL_PURPOSE_RATIO;
+
+    cfg->gen_call_only.gen_min_duration_s = GEN_CALL_MIN_DURATION_S;
+    cfg->gen_call_only.gen_avg_duration_s = GEN_CALL_AVG_DURATION_S;
+    cfg->gen_call_only.gen_max_duration_s = GEN_CALL_MAX_DURATION_S;
+
+    cfg->gen_call_specific.spec_min_duration_s = SPEC_MIN_DURATION_S;
+    cfg->gen_call_specific.spec_avg_duration_s = SPEC_AVG_DURATION_S;
+    cfg->gen_call_specific.spec_std_duration_s = SPEC_STD_DURATION_S;
+    cfg->gen_call_specific.spec_max_duration_s = SPEC_MAX_DURATION_S;
+
+    cfg->area_spec.min_duration_s = AREA_SPEC_MIN_DURATION_S;
+    cfg->area_spec.avg_duration_s = AREA_SPEC_AVG_DURATION_S;
+    cfg->call_center.gen_patience_avg_s = GEN_PATIENCE_AVG_S;
+    cfg->call_center.spec_patience_avg_s = SPEC_PATIENCE_AVG_S;
+    cfg->call_center.priority_shares[0] = 1.0;
+    cfg->call_center.priority_preemptive = PRIORITY_PREEMPTIVE;
+
+    cfg->arrivals.kind = ARRIVAL_POISSON;
+    cfg->arrivals.mmpp_levels[0] = MMPP_LOW_LEVEL;
+    cfg->arrivals.mmpp_levels[1] = MMPP_HIGH_LEVEL;
+    cfg->arrivals.mmpp_sojourn_s[0] = MMPP_LOW_SOJOURN_S;
+    cfg->arrivals.mmpp_sojourn_s[1] = MMPP_HIGH_SOJOURN_S;
+    cfg->arrivals.batch_mean_size = BATCH_MEAN_SIZE;
+    cfg->area_service.kind = SERVICE_EXPONENTIAL;
+    cfg->area_service.cv = AREA_SPEC_SERVICE_CV;
+    cfg->erlang_service.kind = SERVICE_EXPONENTIAL;
+    cfg->erlang_service.cv = ERLANG_SERVICE_CV;
+
+    cfg->simulation.number_of_events = NUMBER_OF_EVENTS;
+    cfg->simulation.random_seed = RANDOM_SEED;
+    cfg->simulation.warmup_events = WARMUP_EVENTS;
+    cfg->simulation.checkpoint_events = CHECKPOINT_EVENTS;
+    cfg->simulation.num_replications = NUM_REPLICATIONS;
+    cfg->simulation.min_arrival_rate = MIN_ARRIVAL_RATE;
+    cfg->simulation.max_arrival_rate = MAX_ARRIVAL_RATE;
+    cfg->simulation.arrival_rate_step = ARRIVAL_RATE_STEP;
+
+    cfg->optimization.target_prob_delayed = TARGET_PROB_DELAYED;
+    cfg->optimization.target_prob_lost = TARGET_PROB_LOST;
+    cfg->optimization.target_avg_delay_s = TARGET_AVG_DELAY_S;
+    cfg->optimization.target_total_delay_s = TARGET_TOTAL_DELAY_S;
+    cfg->optimization.min_gen_opr = MIN_GEN_OPR;
+    cfg->optimization.max_gen_opr = MAX_GEN_OPR;
+    cfg->optimization.min_spec_opr = MIN_SPEC_OPR;
+    cfg->optimization.max_spec_opr = MAX_SPEC_OPR;
+    cfg->optimization.min_queue_len = MIN_QUEUE_LEN;
+    cfg->optimization.max_queue_len = MAX_QUEUE_LEN;
+    cfg->optimization.surrogate_budget = SURROGATE_BUDGET;
+    cfg->optimization.surrogate_initial_points = SURROGATE_INITIAL_POINTS;
+
+    link_scenario_config(cfg);
+}
+
+void link_scenario_config(scenario_config *cfg) {
+    cfg->general_p.gen_call_gen_only_config = &cfg->gen_call_only;
+    cfg->general_p.gen_call_specific_config = &cfg->gen_call_specific;
+    cfg->call_center.general_p_config = &cfg->general_p;
+    cfg->call_center.area_spec_config = &cfg->area_spec;
+    cfg->call_center.arrival_config = &cfg->arrivals;
+    cfg->call_center.area_service = &cfg->area_service;
+    cfg->call_center.arrival_rate = cfg->arrival_rate_per_hour / 3600.0;  // Convert to calls per second
+
+    // Classes run up to the last positive share; shares are rescaled to sum to 1
+    double *shares = cfg->call_center.priority_shares;
+    double total = 0.0;
+    cfg->call_center.priority_classes = 1;
+    for (int k = 0; k < CALL_CENTER_MAX_PRIORITY_CLASSES; k++) {
+        if (shares[k] > 0.0) {
+            total += shares[k];
+            cfg->call_center.priority_classes = k + 1;
+        }
+    }
+    if (total > 0.0) {
+        for (int k = 0; k < cfg->call_center.priority_classes; k++) {
+            shares[k] /= total;
+        }
+    }
+
+    // MMPP phases run up to the first level that is not positive
+    cfg->arrivals.n_phases = 0;
+    while (cfg->arrivals.n_phases < ARRIVAL_MAX_PHASES && cfg->arrivals.mmpp_levels[cfg->arrivals.n_phases] > 0.0) {
+        cfg->arrivals.n_phases++;
+    }
+
+    // Quantile tables follow kind and cv; invalid parameters are reported by validate_config()
+    prepare_service_dist(&cfg->area_service);
+    prepare_service_dist(&cfg->erlang_service);
+}
+
+static char *trim(char *s) {
+    while (isspace((unsigned char)*s)) {
+        s++;
+    }
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) {
+        end--;
+    }
+    *end = '\0';
+    return s;
+}
+
+static int set_config_value(scenario_config *cfg, const char *key, const char *value) {
+    for (size_t i = 0; i < NUM_CONFIG_KEYS; i++) {
+        if (strcmp(config_keys[i].key, key) != 0) {
+            continue;
+        }
+
+        char *end;
+        char *field = (char *)cfg + config_keys[i].offset;
+
+        if (config_keys[i].type == CFG_CLASS_LIST || config_keys[i].type == CFG_PHASE_LIST) {
+            int length = (config_keys[i].type == CFG_CLASS_LIST) ? CALL_CENTER_MAX_PRIORITY_CLASSES : ARRIVAL_MAX_PHASES;
+            double list[CONFIG_MAX_LIST_LEN] = {0.0};
+            const char *p = value;
+            for (int k = 0;; k++) {
+                if (k == length) {
+                    return -1;
+                }
+                list[k] = strtod(p, &end);
+                while (isspace((unsigned char)*end)) {
+                    end++;
+                }
+                if (end == p || (*end != ',' && *end != '\0')) {
+                    return -1;
+                }
+                if (*end == '\0') {
+                    break;
+                }
+                p = end + 1;
+            }
+            memcpy(field, list, length * sizeof(double));
+        } else if (config_keys[i].type == CFG_ARRIVAL_KIND) {
+            int kind = arrival_kind_from_name(value);
+            if (kind < 0) {
+                return -1;
+            }
+            *(arrival_kind *)field = (arrival_kind)kind;
+        } else if (config_keys[i].type == CFG_RENEWAL_FILE) {
+            if (load_renewal_gaps(value, (arrival_config *)field) != 0) {
+                return -1;
+            }
+        } else if (config_keys[i].type == CFG_SERVICE_KIND) {
+            int kind = service_kind_from_name(value);
+            if (kind < 0) {
+                return -1;
+            }
+            *(service_kind *)field = (service_kind)kind;
+        } else if (config_keys[i].type == CFG_SERVICE_FILE) {
+            if (load_service_samples(value, (service_dist *)field) != 0) {
+                return -1;
+            }
+        } else if (config_keys[i].type == CFG_DOUBLE) {
+            double v = strtod(value, &end);
+            if (end == value || *end != '\0') {
+                return -1;
+            }
+            *(double *)field = v;
+        } else {
+            errno = 0;
+            long v = strtol(value, &end, 10);
+            if (end == value || *end != '\0' || errno == ERANGE || v < INT_MIN || v > INT_MAX) {
+                return -1;
+            }
+            *(int *)field = (int)v;
+        }
+        return 0;
+    }
+    return -2;
+}
+
+static int validate_config(const char *path, const scenario_config *cfg) {
+    const optimization_config *opt = &cfg->optimization;
+    const simulation_config *sim = &cfg->simulation;
+
+    if (cfg->arrival_rate_per_hour <= 0.0 || sim->number_of_events <= 0 || sim->num_replications <= 0) {
+        fprintf(stderr, "Error: %s [%s]: arrival rate, number of events and replications must be positive\n", path, cfg->name);
+        return -1;
+    }
+    if (cfg->call_center.general_purpose_ratio < 0.0 || cfg->call_center.general_purpose_ratio > 1.0) {
+        fprintf(stderr, "Error: %s [%s]: general_purpose_ratio must be in [0, 1]\n", path, cfg->name);
+        return -1;
+    }
+    if (cfg->call_center.gen_patience_avg_s < 0.0 || cfg->call_center.spec_patience_avg_s < 0.0) {
+        fprintf(stderr, "Error: %s [%s]: gen_patience_avg_s and spec_patience_avg_s must be >= 0\n", path, cfg->name);
+        return -1;
+    }
+    double share_total = 0.0;
+    for (int k = 0; k < CALL_CENTER_MAX_PRIORITY_CLASSES; k++) {
+        if (cfg->call_center.priority_shares[k] < 0.0) {
+            share_total = -1.0;
+            break;
+        }
+        share_total += cfg->call_center.priority_shares[k];
+    }
+    if (share_total <= 0.0) {
+        fprintf(stderr, "Error: %s [%s]: priority_shares must be >= 0 with a positive sum\n", path, cfg->name);
+        return -1;
+    }
+    const arrival_config *arrivals = &cfg->arrivals;
+    int n_phases = arrivals->n_phases;
+    for (int k = 0; arrivals->kind == ARRIVAL_MMPP && k < n_phases; k++) {
+        if (arrivals->mmpp_sojourn_s[k] <= 0.0) {
+            n_phases = 0;
+        }
+    }
+    if (arrivals->kind == ARRIVAL_MMPP && n_phases < 2) {
+        fprintf(stderr, "Error: %s [%s]: mmpp arrivals need at least 2 positive mmpp_rate_levels, "
+                "each with a positive mmpp_sojourn_s\n", path, cfg->name);
+        return -1;
+    }
+    if (arrivals->kind == ARRIVAL_BATCH && arrivals->batch_mean_size < 1.0) {
+        fprintf(stderr, "Error: %s [%s]: batch_mean_size must be >= 1\n", path, cfg->name);
+        return -1;
+    }
+    if (arrivals->kind == ARRIVAL_RENEWAL && arrivals->n_renewal_gaps == 0) {
+        fprintf(stderr, "Error: %s [%s]: renewal arrivals need a renewal_gaps_file\n", path, cfg->name);
+        return -1;
+    }
+    const service_dist *laws[2] = {&cfg->area_service, &cfg->erlang_service};
+    const char *law_keys[2] = {"area_spec", "erlang_service"};
+    for (int k = 0; k < 2; k++) {
+        if (laws[k]->kind == SERVICE_EMPIRICAL && laws[k]->n_bins == 0) {
+            fprintf(stderr, "Error: %s [%s]: empirical %s_distribution needs a %s_samples_file\n",
+                    path, cfg->name, law_keys[k], law_keys[k]);
+            return -1;
+        }
+        if ((laws[k]->kind == SERVICE_LOGNORMAL && laws[k]->cv <= 0.0) ||
+            (laws[k]->kind == SERVICE_HYPEREXPONENTIAL && laws[k]->cv < 1.0)) {
+            fprintf(stderr, "Error: %s [%s]: %s_cv must be positive (>= 1 for hyperexponential)\n",
+                    path, cfg->name, law_keys[k]);
+            return -1;
+        }
+    }
+    if (opt->min_gen_opr > opt->max_gen_opr || opt->min_spec_opr > opt->max_spec_opr || opt->min_queue_len > opt->max_queue_len) {
+        fprintf(stderr, "Error: %s [%s]: optimization lower bounds exceed upper bounds\n", path, cfg->name);
+        return -1;
+    }
+    if (opt->surrogate_initial_points < 2 || opt->surrogate_budget < opt->surrogate_initial_points) {
+        fprintf(stderr, "Error: %s [%s]: surrogate_initial_points must be >= 2 and <= surrogate_budget\n", path, cfg->name);
+        return -1;
+    }
+    if (sim->warmup_events < 0 || sim->checkpoint_events <= 0) {
+        fprintf(stderr, "Error: %s [%s]: warmup_events must be >= 0 and checkpoint_events positive\n", path, cfg->name);
+        return -1;
+    }
+    if (sim->arrival_rate_step <= 0.0 || sim->min_arrival_rate > sim->max_arrival_rate) {
+        fprintf(stderr, "Error: %s [%s]: invalid sensitivity arrival rate range\n", path, cfg->name);
+        return -1;
+    }
+    return 0;
+}
+
+// Reads an INI file. In config files (scenarios == NULL) every key updates
+// *current. In batch files, keys before the first "[scenario <name>]" update
+// the shared defaults and each scenario section starts from those defaults.
+static int parse_ini(const char *path, scenario_config *current, scenario_config **scenarios, int *count) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Error: Could not open config file %s\n", path);
+        return -1;
+    }
+
+    scenario_config *target = current;
+    int capacity = 0;
+    char line[CONFIG_LINE_LEN];
+    int line_no = 0;
+    int status = 0;
+
+    while (status == 0 && fgets(line, sizeof(line), f) != NULL) {
+        line_no++;
+
+        char *comment = strpbrk(line, "#;");
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        char *s = trim(line);
+        if (*s == '\0') {
+            continue;
+        }
+
+        if (*s == '[') {
+            char *close = strchr(s, ']');
+            if (close == NULL) {
+                fprintf(stderr, "Error: %s:%d: unterminated section header\n", path, line_no);
+                status = -1;
+                break;
+            }
+            *close = '\0';
+            char *section = trim(s + 1);
+            bool is_scenario = strncmp(section, "scenario", 8) == 0 &&
+                               (section[8] == '\0' || isspace((unsigned char)section[8]));
+
+            if (scenarios == NULL) {
+                if (is_scenario) {
+                    fprintf(stderr, "Error: %s:%d: scenario sections are only allowed in batch files\n", path, line_no);
+                    status = -1;
+                }
+            } else if (is_scenario) {
+                if (target != current) {
+                    link_scenario_config(target);
+                    if (validate_config(path, target) != 0) {
+                        status = -1;
+                        break;
+                    }
+                }
+                if (*count == capacity) {
+                    capacity = (capacity == 0) ? 8 : capacity * 2;
+                    scenario_config *tmp = realloc(*scenarios, capacity * sizeof(scenario_config));
+                    if (!tmp) {
+                        perror("realloc failed");
+                        exit(EXIT_FAILURE);
+                    }
+                    *scenarios = tmp;
+                }
+                target = &(*scenarios)[(*count)++];
+                *target = *current;
+                copy_renewal_gaps(&target->arrivals);
+
+                char *name = trim(section + 8);
+                if (*name == '\0') {
+                    snprintf(target->name, SCENARIO_NAME_LEN, "scenario_%d", *count);
+                } else {
+                    snprintf(target->name, SCENARIO_NAME_LEN, "%s", name);
+                }
+            } else if (target != current) {
+                fprintf(stderr, "Error: %s:%d: section [%s] after the first scenario\n", path, line_no, section);
+                status = -1;
+            }
+            continue;
+        }
+
+        char *eq = strchr(s, '=');
+        if (eq == NULL) {
+            fprintf(stderr, "Error: %s:%d: expected key = value\n", path, line_no);
+            status = -1;
+            break;
+        }
+        *eq = '\0';
+        char *key = trim(s);
+        char *value = trim(eq + 1);
+
+        int rc = set_config_value(target, key, value);
+        if (rc == -2) {
+            fprintf(stderr, "Error: %s:%d: unknown key '%s'\n", path, line_no, key);
+            status = -1;
+        } else if (rc == -1) {
+            fprintf(stderr, "Error: %s:%d: invalid value '%s' for '%s'\n", path, line_no, value, key);
+            status = -1;
+        }
+    }
+    fclose(f);
+
+    if (status == 0) {
+        link_scenario_config(target);
+        status = validate_config(path, target);
+    }
+    return status;
+}
+
+int load_config_file(const char *path, scenario_config *cfg) {
+    return parse_ini(path, cfg, NULL, NULL);
+}
+
+// Loads every [scenario <name>] of a batch file on top of *base. Keys placed
+// before the first scenario act as shared defaults for all scenarios.
+int load_batch_file(const char *path, const scenario_config *base, scenario_config **scenarios, int *count) {
+    scenario_config current = *base;
+    copy_renewal_gaps(&current.arrivals);
+    *scenarios = NULL;
+    *count = 0;
+
+    int status = parse_ini(path, &current, scenarios, count);
+    free_renewal_gaps(&current.arrivals);
+    for (int i = 0; status == 0 && i < *count; i++) {
+        scenario_config *sc = &(*scenarios)[i];
+        link_scenario_config(sc);
+        if (sc->call_center.number_of_gen_opr <= 0 || sc->call_center.number_of_spec_opr <= 0 || sc->call_center.length_gen_queue <= 0) {
+            fprintf(stderr, "Error: %s [%s]: number_of_gen_opr, number_of_spec_opr and length_gen_queue must be positive\n", path, sc->name);
+            status = -1;
+        }
+    }
+    if (status != 0) {
+        free_scenario_configs(*scenarios, *count);
+        *scenarios = NULL;
+        *count = 0;
+        return -1;
+    }
+    return 0;
+}
+
+void free_scenario_configs(scenario_config *scenarios, int count) {
+    for (int i = 0; i < count; i++) {
+        free_renewal_gaps(&scenarios[i].arrivals);
+    }
+    free(scenarios);
+}
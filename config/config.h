@@ -0,0 +1,60 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include "../call_center/call_center.h"
+
+#define SCENARIO_NAME_LEN 64
+
+// Optimization targets and search space (runtime version of optimize_param.h)
+typedef struct {
+    double target_prob_delayed;
+    double target_prob_lost;
+    double target_avg_delay_s;
+    double target_total_delay_s;
+    int min_gen_opr;
+    int max_gen_opr;
+    int min_spec_opr;
+    int max_spec_opr;
+    int min_queue_len;
+    int max_queue_len;
+    int surrogate_budget;              // Simulations of optimize_surrogate
+    int surrogate_initial_points;      // Of which the space-filling initial design
+} optimization_config;
+
+// Simulation and sensitivity analysis parameters (runtime version of constants.h)
+typedef struct {
+    int number_of_events;
+    int random_seed;
+    int warmup_events;
+    int checkpoint_events;
+    int num_replications;
+    double min_arrival_rate;
+    double max_arrival_rate;
+    double arrival_rate_step;
+} simulation_config;
+
+// Owns every nested config struct so a scenario can be copied as a unit.
+// After copying, call link_scenario_config() to re-point the nested pointers.
+typedef struct {
+    char name[SCENARIO_NAME_LEN];
+    double arrival_rate_per_hour;
+    generic_call_gen_only_config gen_call_only;
+    generic_call_specific_config gen_call_specific;
+    general_purpose_config general_p;
+    area_specific_config area_spec;
+    arrival_config arrivals;            // The renewal sample is loaded once and shared by copies
+    service_dist area_service;          // Area-specific holding times beyond area_spec_min_duration_s
+    service_dist erlang_service;        // Service law of the M/G/c sweeps (erlang_c, erlang_vr)
+    call_center_config call_center;
+    simulation_config simulation;
+    optimization_config optimization;
+} scenario_config;
+
+void default_scenario_config(scenario_config *cfg);
+void link_scenario_config(scenario_config *cfg);
+int load_config_file(const char *path, scenario_config *cfg);
+int load_batch_file(const char *path, const scenario_config *base, scenario_config **scenarios, int *count);
+// Frees the scenarios of load_batch_file, each of which owns its renewal gaps
+void free_scenario_configs(scenario_config *scenarios, int count);
+
+#endif // CONFIG_H
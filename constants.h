@@ -21,9 +21,34 @@
 #define AREA_SPEC_MIN_DURATION_S 60.0
 #define AREA_SPEC_AVG_DURATION_S 150.0
 
+// Mean patience of a queued caller before hanging up (exponential; 0 means callers never abandon)
+#define GEN_PATIENCE_AVG_S 0.0
+#define SPEC_PATIENCE_AVG_S 0.0
+
+// Priority classes come from the priority_shares key (default: one class);
+// 1 lets higher classes interrupt lower ones in service
+#define PRIORITY_PREEMPTIVE 0
+
+// Non-Poisson arrivals (arrival_process key), all at the mean arrival rate above.
+// MMPP: two phases alternating at these relative levels and mean durations
+#define MMPP_LOW_LEVEL 0.5
+#define MMPP_HIGH_LEVEL 1.5
+#define MMPP_LOW_SOJOURN_S 1800.0
+#define MMPP_HIGH_SOJOURN_S 1800.0
+// Batch Poisson: mean number of calls per batch (geometric sizes)
+#define BATCH_MEAN_SIZE 2.0
+
+// Service-time laws (area_spec_distribution, erlang_service_distribution keys):
+// exponential by default; coefficient of variation of the lognormal and
+// hyperexponential laws
+#define AREA_SPEC_SERVICE_CV 1.0
+#define ERLANG_SERVICE_CV 1.0
+
 // Simulation parameters
 #define NUMBER_OF_EVENTS 100000
 #define RANDOM_SEED 42  // Fixed seed for reproducibility (use 0 for time-based random seed)
+#define WARMUP_EVENTS 10000  // Arrivals discarded before a warm-up snapshot is taken
+#define CHECKPOINT_EVENTS 100000  // Arrivals between two snapshots of a checkpointed run
 
 // Sensitivity analysis parameters
 #define NUM_REPLICATIONS 30  // Number of independent replications for confidence interval
@@ -31,4 +56,10 @@
 #define MAX_ARRIVAL_RATE 120.0  // Maximum arrival rate for sensitivity analysis (calls/hour)
 #define ARRIVAL_RATE_STEP 5.0  // Step size for arrival rate variation (calls/hour)
 
+// Erlang-B blocking curve and Erlang-C delay threshold sweeps (outputs/erlang_b, outputs/erlang_c)
+#define ERLANG_LAMBDA 200
+#define ERLANG_AVG_DURATION_S 0.008
+#define ERLANG_NUMBER_OF_EVENTS 100000
+#define ERLANG_MAX_CHANNELS 10
+
 #endif // CONSTANTS_H
@@ -31,6 +31,8 @@ Result poisson_event_driven_simulation(int lambda, int number_of_events)
     int n = round(v_max / delta);
 
     int *histogram = calloc(n, sizeof(int));
+    hdr_histogram log_histogram;
+    init_sample_histogram(&log_histogram);
 
     for (int i = 0; i < number_of_events; i++)
     {
@@ -45,6 +47,7 @@ Result poisson_event_driven_simulation(int lambda, int number_of_events)
         }
 
         histogram[bin_index]++;
+        hdr_histogram_record(&log_histogram, c);
 
         double next_time = event_list->time + c;
         event_list = __add(event_list, ARRIVAL, next_time);
@@ -57,6 +60,7 @@ Result poisson_event_driven_simulation(int lambda, int number_of_events)
     res.theoretical_average = 1.0 / lambda;
     res.histogram = histogram;
     res.histogram_size = n;
+    res.log_histogram = log_histogram;
 
     return res;
 }
\ No newline at end of file
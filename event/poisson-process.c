@@ -38,16 +38,19 @@ Result poisson_process(int lambda, int number_of_events)
     int generated_events = 0;
 
     int *histogram = calloc(n, sizeof(int));
+    hdr_histogram log_histogram;
+    init_sample_histogram(&log_histogram);
 
     double last_event = 0.0;
 
     while (generated_events < number_of_events)
     {
-        double u = (double)rand() / (double)RAND_MAX;
+        double u = next_uniform();
 
         if (u <= lambda * delta)
         {
             sum += current_time - last_event;
+            hdr_histogram_record(&log_histogram, current_time - last_event);
 
             // Event Arrived
             int bin_index = (int)((current_time - last_event) / delta_histogram);
@@ -74,6 +77,7 @@ Result poisson_process(int lambda, int number_of_events)
     res.theoretical_average = 1.0 / lambda;
     res.histogram = histogram;
     res.histogram_size = n;
+    res.log_histogram = log_histogram;
 
     return res;
 }
\ No newline at end of file
@@ -1,12 +1,260 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
 #include <time.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <sys/stat.h>
 #include "call_center/call_center.h"
+#include "call_center/call_center_kw.h"
+#include "call_center/call_center_ctmc.h"
+#include "call_center/call_center_snapshot.h"
+#include "call_center/call_center_pdes.h"
 #include "models/delay_array.h"
+#include "models/thread_pool.h"
+#include "models/profiling.h"
+#include "models/variance_reduction.h"
+#include "models/result_store.h"
+#include "models/sweep.h"
+#include "models/surrogate.h"
+#include "system/system.h"
 #include "constants.h"
-#include "optimize_param.h"
+#include "config/config.h"
+
+// Defaults come from constants.h / optimize_param.h and can be overridden at
+// startup with --config <file>
+static scenario_config app_config;
+
+// Call center engine used by every mode, selected with --engine
+typedef call_center_stats (*call_center_engine)(call_center_config config, int number_of_events);
+static call_center_engine simulate = start_call_center;
+static const char *engine_name = "event";
+
+// Results of seeded runs are kept in an append-only store (disabled with --no-cache)
+#define RESULT_CACHE_DIR "outputs/cache"
+#define RESULT_CACHE_PATH RESULT_CACHE_DIR "/results.bin"
+#define RESULT_KEY_LEN 1024
+static result_store result_cache;
+
+// run_simulation writes per-call delays as a columnar binary trace unless --trace csv
+#define DELAY_TRACE_PATH "outputs/call_center/delay_distribution.trc"
+#define DELAY_CSV_PATH "outputs/call_center/delay_distribution.csv"
+
+// Work items and result rows of sweep mode, shared by its worker processes
+#define SWEEP_TABLE_PATH "outputs/call_center/sweep_results.tbl"
+static bool delay_trace_csv = false;
+static bool result_cache_enabled = true;
+static bool result_cache_opened = false;
+
+void seed_random(int seed) {
+    if (seed == 0) {
+        rng_seed((unsigned long long)time(NULL));
+    } else {
+        rng_seed((unsigned long long)seed);
+    }
+}
+
+// Seed shared by a whole run; a time-based seed is drawn once so every configuration
+// (or replication, as base + rep) sees a reproducible stream
+static unsigned long long replication_base_seed(void) {
+    int seed = app_config.simulation.random_seed;
+    return (seed == 0) ? (unsigned long long)time(NULL) : (unsigned long long)seed;
+}
+
+static void close_result_cache(void) {
+    fprintf(stderr, "Result store: %ld runs served from %s, %ld simulated\n",
+            result_cache.hits, RESULT_CACHE_PATH, result_cache.misses);
+    result_store_close(&result_cache);
+}
+
+// Opens the store on first use; false when caching is off or the file is unavailable
+static bool use_result_cache(void) {
+    if (!result_cache_enabled) {
+        return false;
+    }
+    if (!result_cache_opened) {
+        if (mkdir(RESULT_CACHE_DIR, 0755) != 0 && errno != EEXIST) {
+            perror("mkdir " RESULT_CACHE_DIR);
+            result_cache_enabled = false;
+            return false;
+        }
+        if (result_store_open(&result_cache, RESULT_CACHE_PATH) != 0) {
+            perror("open " RESULT_CACHE_PATH);
+            result_cache_enabled = false;
+            return false;
+        }
+        result_cache_opened = true;
+        atexit(close_result_cache);
+    }
+    return true;
+}
+
+// Scalar part of call_center_stats; per-call delays and distributions are not stored
+typedef struct {
+    double prob_call_delayed;
+    double prob_call_lost;
+    double avg_delay_of_calls;
+    double avg_abs_prediction_error;
+    double avg_rel_prediction_error;
+    double gen_avg_busy_operators;
+    double gen_avg_queue_length;
+    double mean_interarrival_time;
+    double generic_only_fraction;
+    double mean_service_time;
+    double avg_answ_time;
+    double spec_avg_busy_operators;
+    double spec_avg_queue_length;
+    double gen_prob_abandoned;
+    double spec_prob_abandoned;
+    double gen_prob_preempted;
+    double spec_prob_preempted;
+} stored_call_center_result;
+
+static stored_call_center_result stored_result_from_stats(const call_center_stats *stats) {
+    stored_call_center_result r = {
+        stats->general_p_stats.prob_call_delayed, stats->general_p_stats.prob_call_lost,
+        stats->general_p_stats.avg_delay_of_calls, stats->general_p_stats.avg_abs_prediction_error,
+        stats->general_p_stats.avg_rel_prediction_error, stats->general_p_stats.avg_busy_operators,
+        stats->general_p_stats.avg_queue_length, stats->general_p_stats.mean_interarrival_time,
+        stats->general_p_stats.generic_only_fraction, stats->general_p_stats.mean_service_time,
+        stats->area_spec_stats.avg_answ_time, stats->area_spec_stats.avg_busy_operators,
+        stats->area_spec_stats.avg_queue_length, stats->general_p_stats.prob_call_abandoned,
+        stats->area_spec_stats.prob_call_abandoned, stats->general_p_stats.prob_call_preempted,
+        stats->area_spec_stats.prob_call_preempted
+    };
+    return r;
+}
+
+static call_center_stats stats_from_stored_result(const stored_call_center_result *r) {
+    call_center_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.general_p_stats.prob_call_delayed = r->prob_call_delayed;
+    stats.general_p_stats.prob_call_lost = r->prob_call_lost;
+    stats.general_p_stats.prob_call_abandoned = r->gen_prob_abandoned;
+    stats.general_p_stats.avg_delay_of_calls = r->avg_delay_of_calls;
+    stats.general_p_stats.avg_abs_prediction_error = r->avg_abs_prediction_error;
+    stats.general_p_stats.avg_rel_prediction_error = r->avg_rel_prediction_error;
+    stats.general_p_stats.avg_busy_operators = r->gen_avg_busy_operators;
+    stats.general_p_stats.avg_queue_length = r->gen_avg_queue_length;
+    stats.general_p_stats.mean_interarrival_time = r->mean_interarrival_time;
+    stats.general_p_stats.generic_only_fraction = r->generic_only_fraction;
+    stats.general_p_stats.mean_service_time = r->mean_service_time;
+    stats.area_spec_stats.avg_answ_time = r->avg_answ_time;
+    stats.area_spec_stats.avg_busy_operators = r->spec_avg_busy_operators;
+    stats.area_spec_stats.avg_queue_length = r->spec_avg_queue_length;
+    stats.area_spec_stats.prob_call_abandoned = r->spec_prob_abandoned;
+    stats.general_p_stats.prob_call_preempted = r->gen_prob_preempted;
+    stats.area_spec_stats.prob_call_preempted = r->spec_prob_preempted;
+    return stats;
+}
+
+// Appends to a result key of RESULT_KEY_LEN bytes holding len of them. Returns
+// the new length, or -1 once the key no longer fits (and for every later call),
+// so that a truncated key is never stored or looked up.
+static int append_key(char *key, int len, const char *format, ...) {
+    if (len < 0) {
+        return -1;
+    }
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(key + len, RESULT_KEY_LEN - len, format, args);
+    va_end(args);
+    return (n < 0 || n >= RESULT_KEY_LEN - len) ? -1 : len + n;
+}
+
+// Appends a service law to a result key: kind, then its cv or a fingerprint of
+// its histogram
+static int append_service_key(char *key, int len, const char *label, const service_dist *d) {
+    len = append_key(key, len, "%s%s", label, service_kind_name(d->kind));
+    if (d->kind == SERVICE_LOGNORMAL || d->kind == SERVICE_HYPEREXPONENTIAL) {
+        len = append_key(key, len, ",%a", d->cv);
+    } else if (d->kind == SERVICE_EMPIRICAL) {
+        len = append_key(key, len, ",%d,%016llx", d->n_bins,
+                         (unsigned long long)result_store_hash(d->bin_edges, (d->n_bins + 1) * sizeof(double)));
+    }
+    return len;
+}
+
+// Service law of the M/G/c sweeps; NULL keeps exponential draws
+static const service_dist *erlang_service(void) {
+    return service_dist_is_general(&app_config.erlang_service) ? &app_config.erlang_service : NULL;
+}
+
+// Canonical text of everything a call center run depends on; 0 when it does
+// not fit in RESULT_KEY_LEN bytes
+static size_t call_center_result_key(char *key, call_center_config config, int number_of_events,
+                                     unsigned long long seed) {
+    const generic_call_gen_only_config *g = config.general_p_config->gen_call_gen_only_config;
+    const generic_call_specific_config *sp = config.general_p_config->gen_call_specific_config;
+    const area_specific_config *a = config.area_spec_config;
+    int len = append_key(key, 0,
+                       "call_center v%d engine=%s gen=%d spec=%d queue=%d rate=%a ratio=%a "
+                       "gen_only=%a,%a,%a specific=%a,%a,%a,%a area=%a,%a predictor=%s patience=%a,%a "
+                       "events=%d seed=%llu",
+                       CALL_CENTER_RESULTS_VERSION, engine_name, config.number_of_gen_opr,
+                       config.number_of_spec_opr, config.length_gen_queue, config.arrival_rate,
+                       config.general_purpose_ratio, g->gen_min_duration_s, g->gen_avg_duration_s,
+                       g->gen_max_duration_s, sp->spec_min_duration_s, sp->spec_avg_duration_s,
+                       sp->spec_std_duration_s, sp->spec_max_duration_s, a->min_duration_s,
+                       a->avg_duration_s, wait_predictor_name(config.wait_predictor), config.gen_patience_avg_s,
+                       config.spec_patience_avg_s, number_of_events, seed);
+    if (call_center_has_priorities(config)) {
+        len = append_key(key, len, " preemptive=%d shares=", config.priority_preemptive);
+        for (int k = 0; k < config.priority_classes; k++) {
+            len = append_key(key, len, (k == 0) ? "%a" : ",%a", config.priority_shares[k]);
+        }
+    }
+    if (call_center_has_arrival_process(config)) {
+        const arrival_config *ac = config.arrival_config;
+        len = append_key(key, len, " arrivals=%s", arrival_kind_name(ac->kind));
+        if (ac->kind == ARRIVAL_MMPP) {
+            for (int k = 0; k < ac->n_phases; k++) {
+                len = append_key(key, len, ",%a/%a", ac->mmpp_levels[k], ac->mmpp_sojourn_s[k]);
+            }
+        } else if (ac->kind == ARRIVAL_BATCH) {
+            len = append_key(key, len, ",%a", ac->batch_mean_size);
+        } else {
+            len = append_key(key, len, ",%d,%016llx", ac->n_renewal_gaps,
+                             (unsigned long long)result_store_hash(ac->renewal_gaps, ac->n_renewal_gaps * sizeof(double)));
+        }
+    }
+    if (call_center_has_general_service(config)) {
+        len = append_service_key(key, len, " area_service=", config.area_service);
+    }
+    return (len < 0) ? 0 : (size_t)len;
+}
+
+// simulate() from rng_seed(seed), or the stored result of an identical earlier run.
+// Stats from the store carry no per-call delays, queue length distributions or per-class figures.
+static call_center_stats simulate_cached(call_center_config config, int number_of_events, unsigned long long seed) {
+    char key[RESULT_KEY_LEN];
+    size_t key_len = 0;
+    call_center_stats stats;
+
+    if (use_result_cache()) {
+        size_t value_len;
+        key_len = call_center_result_key(key, config, number_of_events, seed);
+        stored_call_center_result *r = (key_len > 0) ? result_store_get(&result_cache, key, key_len, &value_len) : NULL;
+        if (r != NULL && value_len == sizeof(*r)) {
+            stats = stats_from_stored_result(r);
+            free(r);
+            return stats;
+        }
+        free(r);
+    }
+
+    rng_seed(seed);
+    stats = simulate(config, number_of_events);
+
+    if (key_len > 0) {
+        stored_call_center_result r = stored_result_from_stats(&stats);
+        result_store_put(&result_cache, key, key_len, &r, sizeof(r));
+    }
+    return stats;
+}
 
 bool is_valid_result(call_center_stats stats, double target_delayed, double target_lost, double target_avg_delay, double target_total_delay) {
     return stats.general_p_stats.prob_call_delayed <= target_delayed &&
@@ -15,82 +263,70 @@ bool is_valid_result(call_center_stats stats, double target_delayed, double targ
             stats.area_spec_stats.avg_answ_time <= target_total_delay;
 }
 
-void initialize_config(call_center_config *config, 
-                       generic_call_gen_only_config *gen_call_only,
-                       generic_call_specific_config *gen_call_specific_config,
-                       general_purpose_config *general_p_cfg,
-                       area_specific_config *area_spec_config) {
-    config->arrival_rate = ARRIVAL_RATE;
-    config->general_purpose_ratio = GENERAL_PURPOSE_RATIO;
-    
-    gen_call_only->gen_min_duration_s = GEN_CALL_MIN_DURATION_S;
-    gen_call_only->gen_avg_duration_s = GEN_CALL_AVG_DURATION_S;
-    gen_call_only->gen_max_duration_s = GEN_CALL_MAX_DURATION_S;
-    
-    gen_call_specific_config->spec_min_duration_s = SPEC_MIN_DURATION_S;
-    gen_call_specific_config->spec_avg_duration_s = SPEC_AVG_DURATION_S;
-    gen_call_specific_config->spec_std_duration_s = SPEC_STD_DURATION_S;
-    gen_call_specific_config->spec_max_duration_s = SPEC_MAX_DURATION_S;
-    
-    general_p_cfg->gen_call_gen_only_config = gen_call_only;
-    general_p_cfg->gen_call_specific_config = gen_call_specific_config;
-    
-    config->general_p_config = general_p_cfg;
-    
-    area_spec_config->min_duration_s = AREA_SPEC_MIN_DURATION_S;
-    area_spec_config->avg_duration_s = AREA_SPEC_AVG_DURATION_S;
-    config->area_spec_config = area_spec_config;
+// Copies the runtime configuration into *scenario and returns its call center config
+call_center_config initialize_config(scenario_config *scenario) {
+    *scenario = app_config;
+    link_scenario_config(scenario);
+    return scenario->call_center;
+}
+
+// Sum of the squared relative errors of the four target metrics
+static double optimization_mse(const call_center_stats *stats, const optimization_config *opt) {
+    return pow((stats->general_p_stats.prob_call_delayed - opt->target_prob_delayed) / opt->target_prob_delayed, 2) +
+           pow((stats->general_p_stats.prob_call_lost - opt->target_prob_lost) / opt->target_prob_lost, 2) +
+           pow((stats->general_p_stats.avg_delay_of_calls - opt->target_avg_delay_s) / opt->target_avg_delay_s, 2) +
+           pow((stats->area_spec_stats.avg_answ_time - opt->target_total_delay_s) / opt->target_total_delay_s, 2);
+}
+
+static void print_optimization_step(const call_center_stats *stats, const optimization_config *opt) {
+    printf("  Delayed: %.4f (target: %.2f)\n", stats->general_p_stats.prob_call_delayed, opt->target_prob_delayed);
+    printf("  Lost: %.4f (target: %.2f)\n", stats->general_p_stats.prob_call_lost, opt->target_prob_lost);
+    printf("  Avg delay in General System: %.2f (target: %.2f)\n", stats->general_p_stats.avg_delay_of_calls, opt->target_avg_delay_s);
+    printf("  Avg time between General Arrival and Specific Handling: %.2f (target: %.2f)\n\n", stats->area_spec_stats.avg_answ_time, opt->target_total_delay_s);
+}
+
+static void print_optimization_performance(const call_center_stats *stats, const optimization_config *opt) {
+    printf("Performance:\n");
+    printf("  Prob. delayed: %.4f (target: %.2f)\n", stats->general_p_stats.prob_call_delayed, opt->target_prob_delayed);
+    printf("  Prob. lost: %.4f (target: %.2f)\n", stats->general_p_stats.prob_call_lost, opt->target_prob_lost);
+    printf("  Avg delay in General System: %.2f s (target: %.2f s)\n", stats->general_p_stats.avg_delay_of_calls, opt->target_avg_delay_s);
+    printf("  Avg time between General Arrival and Specific Handling: %.2f s (target: %.2f s)\n", stats->area_spec_stats.avg_answ_time, opt->target_total_delay_s);
 }
 
 void run_optimization() {
     printf("Starting MSE-based optimization...\n");
-    printf("Using fixed random seed: %d (reset before each configuration)\n", RANDOM_SEED);
+    printf("Using fixed random seed: %d (reset before each configuration)\n", app_config.simulation.random_seed);
     
-    call_center_config config;
-    generic_call_gen_only_config gen_call_only;
-    generic_call_specific_config gen_call_specific_config;
-    general_purpose_config general_p_cfg;
-    area_specific_config area_spec_config;
-    
-    initialize_config(&config, &gen_call_only, &gen_call_specific_config, 
-                     &general_p_cfg, &area_spec_config);
+    scenario_config scenario;
+    call_center_config config = initialize_config(&scenario);
+    const optimization_config *opt = &scenario.optimization;
+    unsigned long long seed = replication_base_seed();
     
     double best_mse = 1e9;
     int best_gen = 0, best_spec = 0, best_queue = 0;
     call_center_stats best_stats;
     
     int count = 0;
-    int total = (MAX_GEN_OPR - MIN_GEN_OPR + 1) * (MAX_SPEC_OPR - MIN_SPEC_OPR + 1) * (MAX_QUEUE_LEN - MIN_QUEUE_LEN + 1);
+    int total = (opt->max_gen_opr - opt->min_gen_opr + 1) * (opt->max_spec_opr - opt->min_spec_opr + 1) * (opt->max_queue_len - opt->min_queue_len + 1);
     
-    for (int gen_opr = MIN_GEN_OPR; gen_opr <= MAX_GEN_OPR; gen_opr++) {
-        for (int spec_opr = MIN_SPEC_OPR; spec_opr <= MAX_SPEC_OPR; spec_opr++) {
-            for (int queue_len = MIN_QUEUE_LEN; queue_len <= MAX_QUEUE_LEN; queue_len++) {
+    for (int gen_opr = opt->min_gen_opr; gen_opr <= opt->max_gen_opr; gen_opr++) {
+        for (int spec_opr = opt->min_spec_opr; spec_opr <= opt->max_spec_opr; spec_opr++) {
+            for (int queue_len = opt->min_queue_len; queue_len <= opt->max_queue_len; queue_len++) {
                 count++;
                 
-                if (RANDOM_SEED == 0) {
-                    srand(time(NULL));
-                } else {
-                    srand(RANDOM_SEED);
-                }
-                
                 config.number_of_gen_opr = gen_opr;
                 config.number_of_spec_opr = spec_opr;
                 config.length_gen_queue = queue_len;
                 
-                call_center_stats stats = start_call_center(config, NUMBER_OF_EVENTS);
+                call_center_stats stats = simulate_cached(config, scenario.simulation.number_of_events, seed);
 
-                if (is_valid_result(stats, TARGET_PROB_DELAYED, TARGET_PROB_LOST, TARGET_AVG_DELAY_S, TARGET_TOTAL_DELAY_S)) {
-                    double normalized_mse_delayed = pow((stats.general_p_stats.prob_call_delayed - TARGET_PROB_DELAYED) / TARGET_PROB_DELAYED, 2);
-                    double normalized_mse_lost = pow((stats.general_p_stats.prob_call_lost - TARGET_PROB_LOST) / TARGET_PROB_LOST, 2);
-                    double normalized_mse_avg_delay = pow((stats.general_p_stats.avg_delay_of_calls - TARGET_AVG_DELAY_S) / TARGET_AVG_DELAY_S, 2);
-                    double normalized_mse_total_delay = pow((stats.area_spec_stats.avg_answ_time - TARGET_TOTAL_DELAY_S) / TARGET_TOTAL_DELAY_S, 2);
-                    
-                    double total_mse = normalized_mse_delayed + normalized_mse_lost + normalized_mse_avg_delay + normalized_mse_total_delay;
+                if (is_valid_result(stats, opt->target_prob_delayed, opt->target_prob_lost, opt->target_avg_delay_s, opt->target_total_delay_s)) {
+                    double total_mse = optimization_mse(&stats, opt);
                     
                     if (total_mse < best_mse) {
                         // Free old best_stats delay array if it exists
                         if (best_mse < 1e9) {
-                            free_delay_array(&best_stats.general_p_stats.delays);
+                            free_call_center_stats(&best_stats);
                         }
                         
                         best_mse = total_mse;
@@ -101,14 +337,13 @@ void run_optimization() {
                         
                         printf("[%d/%d] NEW BEST: gen=%d, spec=%d, queue=%d | MSE=%.6f\n",
                             count, total, gen_opr, spec_opr, queue_len, total_mse);
-                        printf("  Delayed: %.4f (target: %.2f)\n", stats.general_p_stats.prob_call_delayed, TARGET_PROB_DELAYED);
-                        printf("  Lost: %.4f (target: %.2f)\n", stats.general_p_stats.prob_call_lost, TARGET_PROB_LOST);
-                        printf("  Avg delay in General System: %.2f (target: %.2f)\n", stats.general_p_stats.avg_delay_of_calls, TARGET_AVG_DELAY_S);
-                        printf("  Avg time between General Arrival and Specific Handling: %.2f (target: %.2f)\n\n", stats.area_spec_stats.avg_answ_time, TARGET_TOTAL_DELAY_S);
+                        print_optimization_step(&stats, opt);
                     } else {
                         // Free delay array for non-best stats
-                        free_delay_array(&stats.general_p_stats.delays);
+                        free_call_center_stats(&stats);
                     }
+                } else {
+                    free_call_center_stats(&stats);
                 }
                 
                 if (count % 10 == 0 || count == total) {
@@ -131,84 +366,715 @@ void run_optimization() {
     printf("  Queue length: %d\n", best_queue);
     printf("  Total MSE: %.6f\n\n", best_mse);
     
-    printf("Performance:\n");
-    printf("  Prob. delayed: %.4f (target: %.2f)\n", best_stats.general_p_stats.prob_call_delayed, TARGET_PROB_DELAYED);
-    printf("  Prob. lost: %.4f (target: %.2f)\n", best_stats.general_p_stats.prob_call_lost, TARGET_PROB_LOST);
-    printf("  Avg delay in General System: %.2f s (target: %.2f s)\n", best_stats.general_p_stats.avg_delay_of_calls, TARGET_AVG_DELAY_S);
-    printf("  Avg time between General Arrival and Specific Handling: %.2f s (target: %.2f s)\n", best_stats.area_spec_stats.avg_answ_time, TARGET_TOTAL_DELAY_S);
+    print_optimization_performance(&best_stats, opt);
+}
+
+static double *alloc_doubles(int n) {
+    double *p = malloc(n * sizeof(double));
+    if (p == NULL) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// Surrogate-guided optimization: grids of up to SURROGATE_EXHAUSTIVE_GRID
+// configurations are scored whole at every step, larger ones through random
+// candidates over the whole space plus a neighbourhood of the incumbent
+#define SURROGATE_DIMS 3
+#define SURROGATE_CONSTRAINTS 4
+#define SURROGATE_EXHAUSTIVE_GRID 4096
+#define SURROGATE_GLOBAL_CANDIDATES 1024
+#define SURROGATE_LOCAL_CANDIDATES 256
+#define SURROGATE_MSE_FLOOR 1e-6        // The objective model fits log(MSE + floor)
+#define SURROGATE_CONSTRAINT_CLAMP 5.0  // Constraint outputs are clamped to +-this
+#define SURROGATE_MIN_ACQUISITION 1e-4  // Expected improvement of log(MSE) that stops the search
+#define SURROGATE_RETUNE_GROWTH 1.2     // Hyperparameters are re-tuned when the points grew by this factor
+
+typedef struct {
+    call_center_config config;
+    int number_of_events;
+    unsigned long long seed;
+    const optimization_config *opt;
+    int lo[SURROGATE_DIMS];
+    int hi[SURROGATE_DIMS];
+    long long grid_size;
+    int budget;
+    rng_state stream;                               // Candidate draws, apart from the simulations' seeds
+    gp_model objective;                             // log(MSE + SURROGATE_MSE_FLOOR)
+    gp_model constraints[SURROGATE_CONSTRAINTS];    // log(metric / target), feasible at <= 0
+    int tuned_n;                                    // Points at the last hyperparameter tuning
+    int (*points)[SURROGATE_DIMS];                  // Simulated configurations
+    double *mse;
+    int n;
+    int best;                                       // Best configuration meeting the targets, -1 if none
+    call_center_stats best_stats;
+    int (*candidates)[SURROGATE_DIMS];
+    double *work;
+} surrogate_search;
+
+// next_uniform from the search's own stream, which simulate_cached's reseeding leaves alone
+static double search_uniform(surrogate_search *s) {
+    rng_swap_state(&s->stream);
+    double u = next_uniform();
+    rng_swap_state(&s->stream);
+    return u;
+}
+
+// Model coordinates in [0, 1]: staffing and queue effects are sharpest at small
+// values and flatten out, so each axis is log-scaled, which keeps length scales
+// meaningful on a grid of any size
+static void surrogate_unit_point(const surrogate_search *s, const int *v, double *x) {
+    for (int d = 0; d < SURROGATE_DIMS; d++) {
+        int span = s->hi[d] - s->lo[d];
+        x[d] = (span > 0) ? log1p(v[d] - s->lo[d]) / log1p(span) : 0.5;
+    }
+}
+
+// Grid value of dimension d nearest to model coordinate u
+static int surrogate_grid_value(const surrogate_search *s, int d, double u) {
+    int span = s->hi[d] - s->lo[d];
+    u = (u < 0.0) ? 0.0 : (u > 1.0) ? 1.0 : u;
+    long v = lround(expm1(u * log1p(span)));
+    return s->lo[d] + ((v > span) ? span : (int)v);
+}
+
+static bool surrogate_evaluated(const surrogate_search *s, const int *v) {
+    for (int i = 0; i < s->n; i++) {
+        if (s->points[i][0] == v[0] && s->points[i][1] == v[1] && s->points[i][2] == v[2]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void surrogate_simulate(surrogate_search *s, const int *v) {
+    const optimization_config *opt = s->opt;
+    s->config.number_of_gen_opr = v[0];
+    s->config.number_of_spec_opr = v[1];
+    s->config.length_gen_queue = v[2];
+    call_center_stats stats = simulate_cached(s->config, s->number_of_events, s->seed);
+
+    double metric[SURROGATE_CONSTRAINTS] = {stats.general_p_stats.prob_call_delayed, stats.general_p_stats.prob_call_lost,
+                                            stats.general_p_stats.avg_delay_of_calls, stats.area_spec_stats.avg_answ_time};
+    double target[SURROGATE_CONSTRAINTS] = {opt->target_prob_delayed, opt->target_prob_lost,
+                                            opt->target_avg_delay_s, opt->target_total_delay_s};
+    double x[SURROGATE_DIMS];
+    surrogate_unit_point(s, v, x);
+    for (int k = 0; k < SURROGATE_CONSTRAINTS; k++) {
+        double c = fmin(log(metric[k] / target[k]), SURROGATE_CONSTRAINT_CLAMP);
+        gp_add_point(&s->constraints[k], x, fmax(c, -SURROGATE_CONSTRAINT_CLAMP));
+    }
+    double mse = fmin(optimization_mse(&stats, opt), 1e12);
+    gp_add_point(&s->objective, x, log(mse + SURROGATE_MSE_FLOOR));
+
+    int i = s->n++;
+    memcpy(s->points[i], v, sizeof(s->points[i]));
+    s->mse[i] = mse;
+    if (is_valid_result(stats, opt->target_prob_delayed, opt->target_prob_lost, opt->target_avg_delay_s, opt->target_total_delay_s) &&
+        (s->best < 0 || mse < s->mse[s->best])) {
+        if (s->best >= 0) {
+            free_call_center_stats(&s->best_stats);
+        }
+        s->best = i;
+        s->best_stats = stats;
+        printf("[%d/%d] NEW BEST: gen=%d, spec=%d, queue=%d | MSE=%.6f\n", s->n, s->budget, v[0], v[1], v[2], mse);
+        print_optimization_step(&stats, opt);
+    } else {
+        free_call_center_stats(&stats);
+    }
+}
+
+// Candidates of the next step: the whole grid when small, otherwise random
+// points plus a neighbourhood of the incumbent (the best feasible point, or the
+// lowest MSE while none is feasible) and its immediate neighbours
+static int surrogate_candidates(surrogate_search *s) {
+    int n = 0;
+    if (s->grid_size <= SURROGATE_EXHAUSTIVE_GRID) {
+        for (int g = s->lo[0]; g <= s->hi[0]; g++) {
+            for (int p = s->lo[1]; p <= s->hi[1]; p++) {
+                for (int q = s->lo[2]; q <= s->hi[2]; q++) {
+                    s->candidates[n][0] = g;
+                    s->candidates[n][1] = p;
+                    s->candidates[n][2] = q;
+                    n++;
+                }
+            }
+        }
+        return n;
+    }
+
+    for (int i = 0; i < SURROGATE_GLOBAL_CANDIDATES; i++, n++) {
+        for (int d = 0; d < SURROGATE_DIMS; d++) {
+            s->candidates[n][d] = surrogate_grid_value(s, d, search_uniform(s));
+        }
+    }
+    int incumbent = s->best;
+    for (int i = 0; incumbent < 0 && i < s->n; i++) {
+        if (i == 0 || s->mse[i] < s->mse[incumbent]) {
+            incumbent = i;
+        }
+    }
+    const int *centre = s->points[incumbent];
+    double x[SURROGATE_DIMS];
+    surrogate_unit_point(s, centre, x);
+    for (int i = 0; i < SURROGATE_LOCAL_CANDIDATES; i++, n++) {
+        double radius = (i % 2 == 0) ? 0.1 : 0.02;
+        for (int d = 0; d < SURROGATE_DIMS; d++) {
+            s->candidates[n][d] = surrogate_grid_value(s, d, x[d] + radius * (2.0 * search_uniform(s) - 1.0));
+        }
+    }
+    for (int d = 0; d < SURROGATE_DIMS; d++) {
+        for (int step = -1; step <= 1; step += 2, n++) {
+            memcpy(s->candidates[n], centre, sizeof(s->candidates[n]));
+            int v = centre[d] + step;
+            s->candidates[n][d] = (v < s->lo[d]) ? s->lo[d] : (v > s->hi[d]) ? s->hi[d] : v;
+        }
+    }
+    return n;
+}
+
+// Refits the models and picks the unevaluated candidate of highest expected
+// improvement times probability of meeting every target (that probability
+// alone while no simulated point meets them). Returns the acquisition value,
+// or -1 when every candidate was already simulated.
+static double surrogate_next_point(surrogate_search *s, int *v) {
+    bool tune = s->n >= SURROGATE_RETUNE_GROWTH * s->tuned_n;
+    if (tune) {
+        s->tuned_n = s->n;
+    }
+    gp_fit(&s->objective, tune);
+    for (int k = 0; k < SURROGATE_CONSTRAINTS; k++) {
+        gp_fit(&s->constraints[k], tune);
+    }
+
+    int n_candidates = surrogate_candidates(s);
+    double best_value = (s->best >= 0) ? log(s->mse[s->best] + SURROGATE_MSE_FLOOR) : 0.0;
+    double best_score = -1.0;
+    for (int i = 0; i < n_candidates; i++) {
+        const int *c = s->candidates[i];
+        if (surrogate_evaluated(s, c)) {
+            continue;
+        }
+        double x[SURROGATE_DIMS], mean, sd;
+        surrogate_unit_point(s, c, x);
+        double score = 1.0;
+        if (s->best >= 0) {
+            gp_predict(&s->objective, x, &mean, &sd, s->work);
+            score = expected_improvement(best_value, mean, sd);
+        }
+        // Each factor is at most 1, so a candidate already beaten is dropped early
+        for (int k = 0; k < SURROGATE_CONSTRAINTS && score > best_score; k++) {
+            gp_predict(&s->constraints[k], x, &mean, &sd, s->work);
+            score *= probability_below(0.0, mean, sd);
+        }
+        if (score > best_score) {
+            best_score = score;
+            memcpy(v, c, SURROGATE_DIMS * sizeof(int));
+        }
+    }
+    return best_score;
+}
+
+void run_surrogate_optimization() {
+    scenario_config scenario;
+    surrogate_search s;
+    s.config = initialize_config(&scenario);
+    s.opt = &scenario.optimization;
+    s.number_of_events = scenario.simulation.number_of_events;
+    s.seed = replication_base_seed();
+    const optimization_config *opt = s.opt;
+    int lo[SURROGATE_DIMS] = {opt->min_gen_opr, opt->min_spec_opr, opt->min_queue_len};
+    int hi[SURROGATE_DIMS] = {opt->max_gen_opr, opt->max_spec_opr, opt->max_queue_len};
+    s.grid_size = 1;
+    for (int d = 0; d < SURROGATE_DIMS; d++) {
+        s.lo[d] = lo[d];
+        s.hi[d] = hi[d];
+        s.grid_size *= hi[d] - lo[d] + 1;
+    }
+    s.budget = (opt->surrogate_budget < s.grid_size) ? opt->surrogate_budget : (int)s.grid_size;
+
+    printf("Starting surrogate-guided optimization...\n");
+    printf("Search space: %lld configurations, budget: %d simulations\n", s.grid_size, s.budget);
+    printf("Using fixed random seed: %d (reset before each configuration)\n", app_config.simulation.random_seed);
+
+    rng_seed(s.seed);
+    rng_get_state(&s.stream);
+    rng_jump(&s.stream);
+    init_gp_model(&s.objective, SURROGATE_DIMS);
+    for (int k = 0; k < SURROGATE_CONSTRAINTS; k++) {
+        init_gp_model(&s.constraints[k], SURROGATE_DIMS);
+    }
+    s.tuned_n = 0;
+    s.n = 0;
+    s.best = -1;
+    int max_candidates = (s.grid_size <= SURROGATE_EXHAUSTIVE_GRID)
+                             ? (int)s.grid_size
+                             : SURROGATE_GLOBAL_CANDIDATES + SURROGATE_LOCAL_CANDIDATES + 2 * SURROGATE_DIMS;
+    s.points = malloc(s.budget * sizeof(*s.points));
+    s.mse = alloc_doubles(s.budget);
+    s.work = alloc_doubles(s.budget);
+    s.candidates = malloc(max_candidates * sizeof(*s.candidates));
+    if (!s.points || !s.candidates) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Latin hypercube initial design: one point per stratum of every dimension
+    int initial = (opt->surrogate_initial_points < s.budget) ? opt->surrogate_initial_points : s.budget;
+    int *strata = malloc(SURROGATE_DIMS * initial * sizeof(int));
+    if (!strata) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int d = 0; d < SURROGATE_DIMS; d++) {
+        int *perm = strata + d * initial;
+        for (int i = 0; i < initial; i++) {
+            perm[i] = i;
+        }
+        for (int i = initial - 1; i > 0; i--) {
+            int j = (int)(search_uniform(&s) * (i + 1));
+            int t = perm[i];
+            perm[i] = perm[j];
+            perm[j] = t;
+        }
+    }
+    for (int i = 0; i < initial; i++) {
+        int v[SURROGATE_DIMS];
+        for (int d = 0; d < SURROGATE_DIMS; d++) {
+            v[d] = surrogate_grid_value(&s, d, (strata[d * initial + i] + search_uniform(&s)) / initial);
+        }
+        if (!surrogate_evaluated(&s, v)) {
+            surrogate_simulate(&s, v);
+        }
+    }
+    free(strata);
+
+    const char *stopped = "simulation budget used";
+    while (s.n < s.budget) {
+        int v[SURROGATE_DIMS];
+        double acquisition = surrogate_next_point(&s, v);
+        if (acquisition < 0.0) {
+            stopped = "every candidate simulated";
+            break;
+        }
+        if (s.best >= 0 && acquisition < SURROGATE_MIN_ACQUISITION) {
+            stopped = "expected improvement negligible";
+            break;
+        }
+        surrogate_simulate(&s, v);
+        if (s.n % 10 == 0) {
+            printf("\rSimulations: %d/%d    ", s.n, s.budget);
+            fflush(stdout);
+        }
+    }
+
+    printf("\n");
+
+    printf("\n========================================\n");
+    printf("SURROGATE OPTIMIZATION COMPLETE\n");
+    printf("========================================\n\n");
+    printf("Simulations: %d of %lld configurations (%.2f%%), stopped: %s\n\n",
+           s.n, s.grid_size, 100.0 * s.n / s.grid_size, stopped);
+    if (s.best < 0) {
+        printf("No simulated configuration met every target\n");
+    } else {
+        const int *b = s.points[s.best];
+        printf("Best configuration found:\n");
+        printf("  General operators: %d\n", b[0]);
+        printf("  Specialist operators: %d\n", b[1]);
+        printf("  Queue length: %d\n", b[2]);
+        printf("  Total MSE: %.6f\n\n", s.mse[s.best]);
+        print_optimization_performance(&s.best_stats, opt);
+        free_call_center_stats(&s.best_stats);
+    }
+
+    free_gp_model(&s.objective);
+    for (int k = 0; k < SURROGATE_CONSTRAINTS; k++) {
+        free_gp_model(&s.constraints[k]);
+    }
+    free(s.points);
+    free(s.mse);
+    free(s.work);
+    free(s.candidates);
+}
+
+static void print_simulation_results(call_center_config config, const call_center_stats *stats) {
+    printf("========================================\n");
+    printf("SIMULATION RESULTS\n");
+    printf("========================================\n\n");
+    
+    printf("General Purpose System:\n");
+    printf("  Prob. General call delayed: %.4f\n", stats->general_p_stats.prob_call_delayed);
+    printf("  Prob. General call lost: %.4f\n", stats->general_p_stats.prob_call_lost);
+    if (config.gen_patience_avg_s > 0.0) {
+        printf("  Prob. General call abandoned: %.4f\n", stats->general_p_stats.prob_call_abandoned);
+    }
+    printf("  Avg delay in General System: %.2f s\n", stats->general_p_stats.avg_delay_of_calls);
+    const hdr_histogram *delays = &stats->general_p_stats.delay_histogram;
+    if (delays->total > 0) {
+        printf("  Delay percentiles p50/p90/p99/p99.9: %.2f / %.2f / %.2f / %.2f s (max %.2f s)\n",
+               hdr_histogram_percentile(delays, 50.0), hdr_histogram_percentile(delays, 90.0),
+               hdr_histogram_percentile(delays, 99.0), hdr_histogram_percentile(delays, 99.9), delays->max);
+    }
+    printf("  Avg absolute prediction error: %.2f s\n", stats->general_p_stats.avg_abs_prediction_error);
+    printf("  Avg relative prediction error: %.4f\n", stats->general_p_stats.avg_rel_prediction_error);
+    printf("  Avg busy operators: %.3f of %d\n", stats->general_p_stats.avg_busy_operators, config.number_of_gen_opr);
+    printf("  Avg queue length: %.3f\n", stats->general_p_stats.avg_queue_length);
+    // Little's law: L_q = lambda * P(delay) * W, with W averaged over delayed calls
+    printf("  Little's law check (lambda * P(delay) * W): %.3f\n\n",
+           config.arrival_rate * stats->general_p_stats.prob_call_delayed * stats->general_p_stats.avg_delay_of_calls);
+    
+    printf("Area-Specific System:\n");
+    printf("  Avg time between General Arrival and Specific Handling: %.2f s\n", stats->area_spec_stats.avg_answ_time);
+    printf("  Avg busy operators: %.3f of %d\n", stats->area_spec_stats.avg_busy_operators, config.number_of_spec_opr);
+    printf("  Avg queue length: %.3f\n", stats->area_spec_stats.avg_queue_length);
+    if (config.spec_patience_avg_s > 0.0) {
+        printf("  Prob. Specific call abandoned: %.4f\n", stats->area_spec_stats.prob_call_abandoned);
+    }
+    if (call_center_has_priorities(config) && config.priority_preemptive) {
+        printf("  Prob. call preempted (general / specific): %.4f / %.4f\n",
+               stats->general_p_stats.prob_call_preempted, stats->area_spec_stats.prob_call_preempted);
+    }
+
+    if (stats->n_priority_classes > 1) {
+        printf("\nPriority classes (0 served first):\n");
+        printf("  %5s %8s %9s %8s %10s %12s %12s\n", "class", "share", "delayed", "lost", "abandoned",
+               "avg delay", "avg answ");
+        for (int k = 0; k < stats->n_priority_classes; k++) {
+            const call_center_class_stats *c = &stats->priority_classes[k];
+            printf("  %5d %8.4f %9.4f %8.4f %10.4f %10.2f s %10.2f s\n", k, c->share_of_arrivals,
+                   c->prob_call_delayed, c->prob_call_lost, c->prob_call_abandoned, c->avg_delay_of_calls,
+                   c->avg_answ_time);
+        }
+    }
 }
 
 void run_simulation(int gen_opr, int spec_opr, int queue_len) {
     // Set random seed
-    if (RANDOM_SEED == 0) {
-        srand(time(NULL));
+    seed_random(app_config.simulation.random_seed);
+    if (app_config.simulation.random_seed == 0) {
         printf("Using time-based random seed\n\n");
     } else {
-        srand(RANDOM_SEED);
-        printf("Using fixed random seed: %d\n\n", RANDOM_SEED);
+        printf("Using fixed random seed: %d\n\n", app_config.simulation.random_seed);
     }
     
     printf("Running simulation with configuration:\n");
     printf("  General operators: %d\n", gen_opr);
     printf("  Specialist operators: %d\n", spec_opr);
     printf("  Queue length: %d\n", queue_len);
-    printf("  Arrival rate: %.2f calls/hour\n", ARRIVAL_RATE_PER_HOUR);
-    printf("  General purpose ratio: %.2f\n\n", GENERAL_PURPOSE_RATIO);
-    
-    call_center_config config;
-    generic_call_gen_only_config gen_call_only;
-    generic_call_specific_config gen_call_specific_config;
-    general_purpose_config general_p_cfg;
-    area_specific_config area_spec_config;
+    printf("  Arrival rate: %.2f calls/hour (%s)\n", app_config.arrival_rate_per_hour,
+           arrival_kind_name(app_config.arrivals.kind));
+    printf("  General purpose ratio: %.2f\n\n", app_config.call_center.general_purpose_ratio);
     
-    initialize_config(&config, &gen_call_only, &gen_call_specific_config, 
-                     &general_p_cfg, &area_spec_config);
+    scenario_config scenario;
+    call_center_config config = initialize_config(&scenario);
     
     config.number_of_gen_opr = gen_opr;
     config.number_of_spec_opr = spec_opr;
     config.length_gen_queue = queue_len;
     
-    call_center_stats stats = start_call_center(config, NUMBER_OF_EVENTS);
+    // Delays are streamed to the trace writer thread while the simulation runs
+    static const char *const trace_columns[] = {"actual_delay", "predicted_delay"};
+    trace_writer *trace = NULL;
+    if (!delay_trace_csv) {
+        trace = trace_writer_open(DELAY_TRACE_PATH, trace_columns, 2);
+        if (trace == NULL) {
+            fprintf(stderr, "Error: Could not open %s\n", DELAY_TRACE_PATH);
+        }
+        call_center_trace = trace;
+    }
+
+    call_center_stats stats = simulate(config, scenario.simulation.number_of_events);
     
-    printf("========================================\n");
-    printf("SIMULATION RESULTS\n");
-    printf("========================================\n\n");
+    call_center_trace = NULL;
+    long trace_rows = (trace != NULL) ? trace_writer_close(trace) : 0;
     
-    printf("General Purpose System:\n");
-    printf("  Prob. General call delayed: %.4f\n", stats.general_p_stats.prob_call_delayed);
-    printf("  Prob. General call lost: %.4f\n", stats.general_p_stats.prob_call_lost);
-    printf("  Avg delay in General System: %.2f s\n", stats.general_p_stats.avg_delay_of_calls);
-    printf("  Avg absolute prediction error: %.2f s\n", stats.general_p_stats.avg_abs_prediction_error);
-    printf("  Avg relative prediction error: %.4f\n\n", stats.general_p_stats.avg_rel_prediction_error);
+    print_simulation_results(config, &stats);
     
-    printf("Area-Specific System:\n");
-    printf("  Avg time between General Arrival and Specific Handling: %.2f s\n", stats.area_spec_stats.avg_answ_time);
-    
-    // Save delay data to CSV for analysis
-    FILE *delay_file = fopen("outputs/call_center/delay_distribution.csv", "w");
-    if (delay_file != NULL) {
-        fprintf(delay_file, "actual_delay,predicted_delay,absolute_error,relative_error\n");
-        for (int i = 0; i < stats.general_p_stats.delays.size; i++) {
-            double actual = stats.general_p_stats.delays.data[i].actual;
-            double predicted = stats.general_p_stats.delays.data[i].predicted;
-            double abs_error = fabs(predicted - actual);
-            double rel_error = fabs(predicted - actual) / fabs(actual);
-            fprintf(delay_file, "%.6f,%.6f,%.6f,%.6f\n", actual, predicted, abs_error, rel_error);
-        }
-        fclose(delay_file);
-        printf("\nDelay data saved to outputs/call_center/delay_distribution.csv\n");
+    if (trace != NULL) {
+        if (trace_rows < 0) {
+            fprintf(stderr, "Error: Could not write %s\n", DELAY_TRACE_PATH);
+        } else {
+            printf("\nDelay data (%ld calls) saved to %s\n", trace_rows, DELAY_TRACE_PATH);
+        }
+    } else if (delay_trace_csv) {
+        // Save delay data to CSV for analysis
+        FILE *delay_file = fopen(DELAY_CSV_PATH, "w");
+        if (delay_file != NULL) {
+            fprintf(delay_file, "actual_delay,predicted_delay,absolute_error,relative_error\n");
+            for (size_t i = 0; i < stats.general_p_stats.delays.size; i++) {
+                double actual = stats.general_p_stats.delays.data[i].actual;
+                double predicted = stats.general_p_stats.delays.data[i].predicted;
+                double abs_error = fabs(predicted - actual);
+                double rel_error = fabs(predicted - actual) / fabs(actual);
+                fprintf(delay_file, "%.6f,%.6f,%.6f,%.6f\n", actual, predicted, abs_error, rel_error);
+            }
+            fclose(delay_file);
+            printf("\nDelay data saved to %s\n", DELAY_CSV_PATH);
+        }
     }
     
     // Free memory
-    free_delay_array(&stats.general_p_stats.delays);
+    free_call_center_stats(&stats);
+}
+
+// Snapshots hold the state of the event-list engine, the only one that also
+// models queued callers hanging up
+static bool require_event_engine(const char *mode) {
+    if (simulate != start_call_center) {
+        fprintf(stderr, "Error: %s needs the event engine (--engine event)\n", mode);
+        return false;
+    }
+    return true;
+}
+
+// Features modelled on the event list, sequential or split across threads
+static bool require_event_list_engine(const char *mode) {
+    if (simulate != start_call_center && simulate != start_call_center_pdes) {
+        fprintf(stderr, "Error: %s needs an event-list engine (--engine event|pdes)\n", mode);
+        return false;
+    }
+    return true;
+}
+
+// The CTMC engine assumes exponential durations; the other two take any law
+static bool reject_ctmc_engine(const char *mode) {
+    if (simulate == start_call_center_ctmc) {
+        fprintf(stderr, "Error: %s needs the event or kw engine (--engine event|kw)\n", mode);
+        return false;
+    }
+    return true;
+}
+
+// Restores a warm-up snapshot and reseeds it, so the branch draws from its own seed
+static bool branch_from_snapshot(const char *path, call_center_config config, unsigned long long seed,
+                                 call_center_state *state) {
+    if (load_call_center_snapshot(path, config, state) != 0) {
+        return false;
+    }
+    rng_seed(seed);
+    if (config.tier_streams) {
+        // The saved specialist stream would be shared by every branch; derive it
+        // from the new seed as init_call_center_state does
+        rng_get_state(&state->counters.specific_stream);
+        rng_jump(&state->counters.specific_stream);
+    }
+    return true;
+}
+
+static bool simulate_from_snapshot(const char *path, call_center_config config, int number_of_events,
+                                   unsigned long long seed, call_center_stats *stats) {
+    call_center_state state;
+    if (!branch_from_snapshot(path, config, seed, &state)) {
+        return false;
+    }
+    advance_call_center(config, &state, number_of_events);
+    *stats = finish_call_center(&state);
+    return true;
+}
+
+// Arrivals of each branch of the independence check
+#define SNAPSHOT_CHECK_EVENTS 2000
+
+// Two branches from one snapshot with different seeds must start the specialist
+// tier from different streams and end with different specialist-tier statistics,
+// with the tier on the caller's stream and on its own (tier_streams)
+static bool snapshot_branches_independent(const char *path, call_center_config config, unsigned long long seed) {
+    bool independent = true;
+    for (int own_stream = 0; own_stream <= 1 && independent; own_stream++) {
+        config.tier_streams = own_stream;
+        call_center_state a, b;
+        if (!branch_from_snapshot(path, config, seed + 1, &a)) {
+            return false;
+        }
+        advance_call_center(config, &a, SNAPSHOT_CHECK_EVENTS);
+        if (!branch_from_snapshot(path, config, seed + 2, &b)) {
+            free_call_center_state(&a);
+            return false;
+        }
+        if (own_stream && memcmp(&a.counters.specific_stream, &b.counters.specific_stream, sizeof(rng_state)) == 0) {
+            independent = false;
+        }
+        advance_call_center(config, &b, SNAPSHOT_CHECK_EVENTS);
+
+        call_center_stats sa = finish_call_center(&a), sb = finish_call_center(&b);
+        const area_specific_stats *x = &sa.area_spec_stats, *y = &sb.area_spec_stats;
+        if (x->avg_answ_time == y->avg_answ_time && x->avg_busy_operators == y->avg_busy_operators &&
+            x->avg_queue_length == y->avg_queue_length) {
+            independent = false;
+        }
+        free_call_center_stats(&sa);
+        free_call_center_stats(&sb);
+    }
+    return independent;
+}
+
+// Runs warmup_events arrivals from an empty system, discards their statistics
+// and saves the warmed-up state for runs to branch from
+int run_warmup(int gen_opr, int spec_opr, int queue_len, const char *snapshot_path) {
+    scenario_config scenario;
+    call_center_config config = initialize_config(&scenario);
+    config.number_of_gen_opr = gen_opr;
+    config.number_of_spec_opr = spec_opr;
+    config.length_gen_queue = queue_len;
+
+    seed_random(scenario.simulation.random_seed);
+    call_center_state state;
+    init_call_center_state(config, &state);
+    advance_call_center(config, &state, scenario.simulation.warmup_events);
+    reset_call_center_statistics(&state);
+
+    int status = save_call_center_snapshot(snapshot_path, config, &state);
+    if (status != 0) {
+        fprintf(stderr, "Error: Could not write %s\n", snapshot_path);
+    } else {
+        const call_center_counters *k = &state.counters;
+        printf("Warmed up %d/%d/%d over %d arrivals (t = %.0f s)\n", gen_opr, spec_opr, queue_len,
+               scenario.simulation.warmup_events, state.gen_busy_avg.last_time);
+        printf("  General: %d of %d operators busy, %d queued\n", k->general_opr_busy, gen_opr, k->in_queue_general_call);
+        printf("  Specific: %d of %d operators busy, %d queued\n", k->specific_opr_busy, spec_opr, k->in_queue_specific_call);
+        printf("Snapshot saved to %s\n", snapshot_path);
+    }
+    free_call_center_state(&state);
+    if (status == 0) {
+        bool independent = snapshot_branches_independent(snapshot_path, config, scenario.simulation.random_seed);
+        printf("  Branches with different seeds differ in both tiers: %s\n", independent ? "yes" : "no");
+        status = independent ? 0 : 1;
+    }
+    return status;
+}
+
+// Long run of number_of_events arrivals in steps of checkpoint_events. With a
+// snapshot_path the state is saved after every step and rerunning the same
+// command after an interruption resumes from the last checkpoint. long_run
+// keeps no per-call delays, for runs of billions of calls.
+int run_checkpointed(int gen_opr, int spec_opr, int queue_len, const char *snapshot_path,
+                     int64_t number_of_events, bool long_run) {
+    scenario_config scenario;
+    call_center_config config = initialize_config(&scenario);
+    const simulation_config *sim = &scenario.simulation;
+    config.number_of_gen_opr = gen_opr;
+    config.number_of_spec_opr = spec_opr;
+    config.length_gen_queue = queue_len;
+    config.long_run = long_run;
+
+    call_center_state state;
+    FILE *existing = (snapshot_path != NULL) ? fopen(snapshot_path, "rb") : NULL;
+    if (existing != NULL) {
+        fclose(existing);
+        if (load_call_center_snapshot(snapshot_path, config, &state) != 0) {
+            return 1;
+        }
+        printf("Resuming from %s after %lld arrivals\n", snapshot_path, (long long)state.counters.general_arrivals);
+    } else {
+        seed_random(sim->random_seed);
+        init_call_center_state(config, &state);
+    }
+
+    while (state.counters.general_arrivals < number_of_events) {
+        int64_t target = state.counters.general_arrivals + sim->checkpoint_events;
+        advance_call_center(config, &state, (target < number_of_events) ? target : number_of_events);
+        if (snapshot_path != NULL && save_call_center_snapshot(snapshot_path, config, &state) != 0) {
+            fprintf(stderr, "Error: Could not write %s\n", snapshot_path);
+            free_call_center_state(&state);
+            return 1;
+        }
+        printf("\r%s: %lld/%lld arrivals    ", (snapshot_path != NULL) ? "Checkpoint" : "Progress",
+               (long long)state.counters.general_arrivals, (long long)number_of_events);
+        fflush(stdout);
+    }
+    printf("\n\n");
+
+    double horizon = (double)state.counters.epochs * CALL_CENTER_EPOCH_S + state.gen_busy_avg.last_time;
+    long long epochs = (long long)state.counters.epochs;
+    call_center_stats stats = finish_call_center(&state);
+    print_simulation_results(config, &stats);
+    if (long_run) {
+        printf("\nSimulated time: %.6e s (clock rebased %lld times)\n", horizon, epochs);
+    }
+    free_call_center_stats(&stats);
+    return 0;
+}
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Every statistic both engines report, compared bit for bit
+static bool same_call_center_stats(const call_center_stats *a, const call_center_stats *b) {
+    const general_purpose_stats *ga = &a->general_p_stats, *gb = &b->general_p_stats;
+    const area_specific_stats *sa = &a->area_spec_stats, *sb = &b->area_spec_stats;
+    double x[] = {ga->prob_call_delayed, ga->prob_call_lost, ga->prob_call_abandoned, ga->prob_call_preempted,
+                  ga->avg_delay_of_calls, ga->avg_abs_prediction_error, ga->avg_rel_prediction_error,
+                  ga->avg_busy_operators, ga->avg_queue_length, ga->mean_interarrival_time,
+                  ga->generic_only_fraction, ga->mean_service_time, sa->avg_answ_time, sa->prob_call_abandoned,
+                  sa->prob_call_preempted, sa->avg_busy_operators, sa->avg_queue_length};
+    double y[] = {gb->prob_call_delayed, gb->prob_call_lost, gb->prob_call_abandoned, gb->prob_call_preempted,
+                  gb->avg_delay_of_calls, gb->avg_abs_prediction_error, gb->avg_rel_prediction_error,
+                  gb->avg_busy_operators, gb->avg_queue_length, gb->mean_interarrival_time,
+                  gb->generic_only_fraction, gb->mean_service_time, sb->avg_answ_time, sb->prob_call_abandoned,
+                  sb->prob_call_preempted, sb->avg_busy_operators, sb->avg_queue_length};
+    return memcmp(x, y, sizeof(x)) == 0 && ga->delays.size == gb->delays.size &&
+           memcmp(ga->delays.data, gb->delays.data, ga->delays.size * sizeof(delay)) == 0 &&
+           sa->queue_length_distribution_size == sb->queue_length_distribution_size &&
+           memcmp(sa->queue_length_distribution, sb->queue_length_distribution,
+                  sa->queue_length_distribution_size * sizeof(double)) == 0 &&
+           a->n_priority_classes == b->n_priority_classes &&
+           memcmp(a->priority_classes, b->priority_classes,
+                  a->n_priority_classes * sizeof(call_center_class_stats)) == 0;
+}
+
+// The parallel engine against the sequential one from the same seed, both with
+// the specialist tier on its own stream. Returns 1 when the results differ.
+int run_pdes_comparison(int gen_opr, int spec_opr, int queue_len, int number_of_events) {
+    scenario_config scenario;
+    call_center_config config = initialize_config(&scenario);
+    config.number_of_gen_opr = gen_opr;
+    config.number_of_spec_opr = spec_opr;
+    config.length_gen_queue = queue_len;
+    config.tier_streams = true;
+    unsigned long long seed = replication_base_seed();
+
+    rng_seed(seed);
+    double start = wall_seconds();
+    call_center_stats sequential = start_call_center(config, number_of_events);
+    double sequential_s = wall_seconds() - start;
+
+    rng_seed(seed);
+    start = wall_seconds();
+    call_center_stats parallel = start_call_center_pdes(config, number_of_events);
+    double parallel_s = wall_seconds() - start;
+
+    print_simulation_results(config, &parallel);
+    bool identical = same_call_center_stats(&sequential, &parallel);
+    printf("\nTwo tiers as logical processes, %d arrivals:\n", number_of_events);
+    printf("  sequential: %8.3f s  (%7.1f ns/arrival)\n", sequential_s, 1e9 * sequential_s / number_of_events);
+    printf("  parallel:   %8.3f s  (%7.1f ns/arrival)\n", parallel_s, 1e9 * parallel_s / number_of_events);
+    printf("  speedup:    %8.3fx\n", sequential_s / parallel_s);
+    printf("  identical results: %s\n", identical ? "yes" : "no");
+
+    free_call_center_stats(&sequential);
+    free_call_center_stats(&parallel);
+    return identical ? 0 : 1;
 }
 
-void run_sensitivity_analysis(int gen_opr, int spec_opr, int queue_len) {
+void run_sensitivity_analysis(int gen_opr, int spec_opr, int queue_len, const char *snapshot_path) {
     printf("Running sensitivity analysis...\n");
     printf("Configuration: gen=%d, spec=%d, queue=%d\n", gen_opr, spec_opr, queue_len);
+    if (snapshot_path != NULL) {
+        printf("Every replication branches from the warmed-up state in %s\n", snapshot_path);
+    }
+    
+    scenario_config scenario;
+    call_center_config config = initialize_config(&scenario);
+    const simulation_config *sim = &scenario.simulation;
+    
     printf("Arrival rate range: %.0f to %.0f calls/hour (step: %.0f)\n", 
-           MIN_ARRIVAL_RATE, MAX_ARRIVAL_RATE, ARRIVAL_RATE_STEP);
-    printf("Replications per point: %d\n\n", NUM_REPLICATIONS);
+           sim->min_arrival_rate, sim->max_arrival_rate, sim->arrival_rate_step);
+    printf("Replications per point: %d\n\n", sim->num_replications);
     
     FILE *sensitivity_file = fopen("outputs/call_center/sensitivity_analysis.csv", "w");
     if (sensitivity_file == NULL) {
@@ -218,15 +1084,6 @@ void run_sensitivity_analysis(int gen_opr, int spec_opr, int queue_len) {
     
     fprintf(sensitivity_file, "arrival_rate,replication,prob_delayed,prob_lost,avg_delay,total_delay\n");
     
-    call_center_config config;
-    generic_call_gen_only_config gen_call_only;
-    generic_call_specific_config gen_call_specific_config;
-    general_purpose_config general_p_cfg;
-    area_specific_config area_spec_config;
-    
-    initialize_config(&config, &gen_call_only, &gen_call_specific_config, 
-                     &general_p_cfg, &area_spec_config);
-    
     config.number_of_gen_opr = gen_opr;
     config.number_of_spec_opr = spec_opr;
     config.length_gen_queue = queue_len;
@@ -234,17 +1091,22 @@ void run_sensitivity_analysis(int gen_opr, int spec_opr, int queue_len) {
     int total_runs = 0;
     
     int rate_count = 0;
-    int total_rates = (int)((MAX_ARRIVAL_RATE - MIN_ARRIVAL_RATE) / ARRIVAL_RATE_STEP) + 1;
+    int total_rates = (int)((sim->max_arrival_rate - sim->min_arrival_rate) / sim->arrival_rate_step) + 1;
     
-    for (double arrival_rate = MIN_ARRIVAL_RATE; arrival_rate <= MAX_ARRIVAL_RATE; arrival_rate += ARRIVAL_RATE_STEP) {
+    for (double arrival_rate = sim->min_arrival_rate; arrival_rate <= sim->max_arrival_rate; arrival_rate += sim->arrival_rate_step) {
         config.arrival_rate = arrival_rate / 3600.0;  // Convert to calls/second
         rate_count++;
         
-        for (int rep = 0; rep < NUM_REPLICATIONS; rep++) {
+        for (int rep = 0; rep < sim->num_replications; rep++) {
             // Use different seed for each replication
-            srand(RANDOM_SEED + total_runs);
-            
-            call_center_stats stats = start_call_center(config, NUMBER_OF_EVENTS);
+            unsigned long long seed = (unsigned long long)(sim->random_seed + total_runs);
+            call_center_stats stats;
+            if (snapshot_path == NULL) {
+                stats = simulate_cached(config, sim->number_of_events, seed);
+            } else if (!simulate_from_snapshot(snapshot_path, config, sim->number_of_events, seed, &stats)) {
+                fclose(sensitivity_file);
+                return;
+            }
             
             fprintf(sensitivity_file, "%.2f,%d,%.6f,%.6f,%.6f,%.6f\n",
                     arrival_rate,
@@ -254,12 +1116,12 @@ void run_sensitivity_analysis(int gen_opr, int spec_opr, int queue_len) {
                     stats.general_p_stats.avg_delay_of_calls,
                     stats.area_spec_stats.avg_answ_time);
             
-            free_delay_array(&stats.general_p_stats.delays);
+            free_call_center_stats(&stats);
             total_runs++;
             
             // Update progress on same line
             printf("\rTesting arrival rate: %.0f calls/hour [%d/%d] (%.1f%% complete)    ", 
-                   arrival_rate, rate_count, total_rates, 100.0 * total_runs / (total_rates * NUM_REPLICATIONS));
+                   arrival_rate, rate_count, total_rates, 100.0 * total_runs / (total_rates * sim->num_replications));
             fflush(stdout);
         }
     }
@@ -271,20 +1133,815 @@ void run_sensitivity_analysis(int gen_opr, int spec_opr, int queue_len) {
     printf("Total simulations run: %d\n", total_runs);
 }
 
+typedef struct {
+    scenario_config scenario;
+    unsigned long long seed;
+    call_center_stats stats;
+} batch_job;
+
+static void run_batch_job(void *arg) {
+    batch_job *job = arg;
+
+    // Each worker thread owns its RNG stream, so seeding here only affects this job
+    rng_seed(job->seed);
+    job->stats = simulate(job->scenario.call_center, job->scenario.simulation.number_of_events);
+    free_call_center_stats(&job->stats);
+}
+
+int run_batch(const char *batch_path, int n_threads) {
+    scenario_config *scenarios = NULL;
+    int n_scenarios = 0;
+
+    if (load_batch_file(batch_path, &app_config, &scenarios, &n_scenarios) != 0) {
+        return 1;
+    }
+    if (n_scenarios == 0) {
+        fprintf(stderr, "Error: %s does not define any [scenario <name>] section\n", batch_path);
+        return 1;
+    }
+    for (int i = 0; i < n_scenarios; i++) {
+        if ((call_center_has_patience(scenarios[i].call_center) && !require_event_list_engine("caller abandonment")) ||
+            (call_center_has_priorities(scenarios[i].call_center) && !require_event_list_engine("priority classes")) ||
+            (call_center_has_arrival_process(scenarios[i].call_center) && !require_event_list_engine("non-Poisson arrivals")) ||
+            (call_center_has_general_service(scenarios[i].call_center) && !reject_ctmc_engine("general service times"))) {
+            free_scenario_configs(scenarios, n_scenarios);
+            return 1;
+        }
+    }
+
+    batch_job *jobs = calloc(n_scenarios, sizeof(batch_job));
+    if (!jobs) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    thread_pool *pool = thread_pool_create(n_threads);
+    printf("Running %d scenarios from %s on %d threads...\n", n_scenarios, batch_path,
+           (n_threads > 0) ? n_threads : default_thread_count());
+
+    unsigned long long time_seed = (unsigned long long)time(NULL);
+    for (int i = 0; i < n_scenarios; i++) {
+        jobs[i].scenario = scenarios[i];
+        link_scenario_config(&jobs[i].scenario);
+        jobs[i].seed = (scenarios[i].simulation.random_seed == 0) ? time_seed + i : (unsigned long long)scenarios[i].simulation.random_seed;
+        thread_pool_submit(pool, run_batch_job, &jobs[i]);
+    }
+    thread_pool_wait(pool);
+    thread_pool_destroy(pool);
+
+    FILE *batch_file = fopen("outputs/call_center/batch_results.csv", "w");
+    if (batch_file == NULL) {
+        fprintf(stderr, "Error: Could not open batch output file\n");
+    } else {
+        fprintf(batch_file, "scenario,gen_opr,spec_opr,queue_len,arrival_rate,prob_delayed,prob_lost,avg_delay,total_delay\n");
+        for (int i = 0; i < n_scenarios; i++) {
+            const scenario_config *sc = &jobs[i].scenario;
+            const call_center_stats *st = &jobs[i].stats;
+            fprintf(batch_file, "%s,%d,%d,%d,%.2f,%.6f,%.6f,%.6f,%.6f\n",
+                    sc->name,
+                    sc->call_center.number_of_gen_opr,
+                    sc->call_center.number_of_spec_opr,
+                    sc->call_center.length_gen_queue,
+                    sc->arrival_rate_per_hour,
+                    st->general_p_stats.prob_call_delayed,
+                    st->general_p_stats.prob_call_lost,
+                    st->general_p_stats.avg_delay_of_calls,
+                    st->area_spec_stats.avg_answ_time);
+        }
+        fclose(batch_file);
+        printf("Results saved to outputs/call_center/batch_results.csv\n");
+    }
+
+    free(jobs);
+    free_scenario_configs(scenarios, n_scenarios);
+    return 0;
+}
+
+// Sweep result row: the summary statistics, then the counts of the delay
+// histogram, so the replications of a scenario can be merged
+typedef struct {
+    stored_call_center_result summary;
+    uint64_t delay_total;
+    double delay_min;
+    double delay_max;
+    double delay_sum;
+} sweep_row;
+
+typedef struct {
+    const scenario_config *scenarios;
+    size_t row_size;
+} sweep_context;
+
+// Runs claimed (scenario, seed) items until the sweep runs dry; forked per worker process
+static void run_sweep_worker(sweep_transport *transport, void *arg) {
+    const sweep_context *context = arg;
+    sweep_row *row = malloc(context->row_size);
+    if (!row) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    sweep_item item;
+
+    while (transport->claim(transport->ctx, &item)) {
+        scenario_config scenario = context->scenarios[item.scenario];
+        link_scenario_config(&scenario);
+        rng_seed(item.seed);
+        call_center_stats stats = simulate(scenario.call_center, scenario.simulation.number_of_events);
+
+        const hdr_histogram *delays = &stats.general_p_stats.delay_histogram;
+        row->summary = stored_result_from_stats(&stats);
+        row->delay_total = delays->total;
+        row->delay_min = delays->min;
+        row->delay_max = delays->max;
+        row->delay_sum = delays->sum;
+        memcpy(row + 1, delays->counts, context->row_size - sizeof(sweep_row));
+        free_call_center_stats(&stats);
+        transport->complete(transport->ctx, &item, row);
+    }
+    free(row);
+}
+
+int run_sweep(const char *batch_path, int n_workers, int n_replications) {
+    scenario_config *scenarios = NULL;
+    int n_scenarios = 0;
+
+    if (load_batch_file(batch_path, &app_config, &scenarios, &n_scenarios) != 0) {
+        return 1;
+    }
+    if (n_scenarios == 0) {
+        fprintf(stderr, "Error: %s does not define any [scenario <name>] section\n", batch_path);
+        return 1;
+    }
+    for (int i = 0; i < n_scenarios; i++) {
+        if ((call_center_has_patience(scenarios[i].call_center) && !require_event_list_engine("caller abandonment")) ||
+            (call_center_has_priorities(scenarios[i].call_center) && !require_event_list_engine("priority classes")) ||
+            (call_center_has_arrival_process(scenarios[i].call_center) && !require_event_list_engine("non-Poisson arrivals")) ||
+            (call_center_has_general_service(scenarios[i].call_center) && !reject_ctmc_engine("general service times"))) {
+            free_scenario_configs(scenarios, n_scenarios);
+            return 1;
+        }
+    }
+
+    // One item per (scenario, replication); the key covers every item, so only an
+    // identical sweep resumes from the table. Items of scenarios without a
+    // random_seed are keyed by their offset from the time-based seed, which the
+    // table keeps from the first run, so such a sweep resumes too.
+    int n_items = n_scenarios * n_replications;
+    sweep_item *items = malloc(n_items * sizeof(sweep_item));
+    if (!items) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    unsigned long long time_seed = (unsigned long long)time(NULL);
+    bool any_time_seeded = false;
+    uint64_t sweep_key = result_store_hash(NULL, 0);
+    for (int i = 0; i < n_items; i++) {
+        scenario_config scenario = scenarios[i / n_replications];
+        link_scenario_config(&scenario);
+        bool time_seeded = scenario.simulation.random_seed == 0;
+        unsigned long long base = time_seeded
+                                      ? time_seed + (unsigned long long)(i / n_replications) * n_replications
+                                      : (unsigned long long)scenario.simulation.random_seed;
+        items[i].index = (uint32_t)i;
+        items[i].scenario = (uint32_t)(i / n_replications);
+        items[i].seed = base + i % n_replications;
+        any_time_seeded |= time_seeded;
+
+        char key[RESULT_KEY_LEN];
+        size_t key_len = call_center_result_key(key, scenario.call_center, scenario.simulation.number_of_events,
+                                                time_seeded ? items[i].seed - time_seed : items[i].seed);
+        if (key_len == 0) {
+            fprintf(stderr, "Error: scenario %s is described by more than %d bytes and cannot be keyed\n",
+                    scenario.name, RESULT_KEY_LEN);
+            free(items);
+            free_scenario_configs(scenarios, n_scenarios);
+            return 1;
+        }
+        sweep_key = sweep_key * 1099511628211ull ^ result_store_hash(key, key_len) ^ time_seeded;
+    }
+
+    hdr_histogram delays;
+    init_call_center_delay_histogram(&delays);
+    sweep_context context = {scenarios, sizeof(sweep_row) + delays.n_buckets * sizeof(uint64_t)};
+    sweep_table *table = sweep_table_open(SWEEP_TABLE_PATH, items, (uint32_t)n_items,
+                                          (uint32_t)context.row_size, sweep_key, time_seed);
+    free(items);
+    if (table == NULL) {
+        perror("open " SWEEP_TABLE_PATH);
+        free_hdr_histogram(&delays);
+        free_scenario_configs(scenarios, n_scenarios);
+        return 1;
+    }
+    if (any_time_seeded && sweep_table_base_seed(table) != time_seed) {
+        printf("Resuming with the time-based seed %llu of the first run\n",
+               (unsigned long long)sweep_table_base_seed(table));
+    }
+
+    printf("Running %d scenarios x %d replications from %s on %d worker processes...\n",
+           n_scenarios, n_replications, batch_path, n_workers);
+    sweep_report report;
+    int status = sweep_run(table, n_workers, run_sweep_worker, &context, &report);
+    printf("%d items: %d resumed from %s, %d worker crashes, %d backup runs, %d failed\n",
+           n_items, report.resumed, SWEEP_TABLE_PATH, report.crashes, report.backups, report.failed);
+
+    FILE *sweep_file = fopen("outputs/call_center/sweep_results.csv", "w");
+    if (sweep_file == NULL) {
+        fprintf(stderr, "Error: Could not open sweep output file\n");
+    } else {
+        fprintf(sweep_file, "scenario,gen_opr,spec_opr,queue_len,arrival_rate,replications,"
+                            "prob_delayed,prob_lost,avg_delay,avg_delay_std_error,p99_delay,p999_delay,total_delay\n");
+        for (int sc = 0; sc < n_scenarios; sc++) {
+            double delayed = 0.0, lost = 0.0, delay = 0.0, delay_sq = 0.0, total = 0.0;
+            int n = 0;
+            hdr_histogram_reset(&delays);
+            for (int rep = 0; rep < n_replications; rep++) {
+                const sweep_row *row = sweep_table_row(table, (uint32_t)(sc * n_replications + rep));
+                if (row == NULL) {
+                    continue;
+                }
+                const stored_call_center_result *r = &row->summary;
+                hdr_histogram view = delays;
+                view.counts = (uint64_t *)(row + 1);
+                view.total = row->delay_total;
+                view.min = row->delay_min;
+                view.max = row->delay_max;
+                view.sum = row->delay_sum;
+                hdr_histogram_merge(&delays, &view);
+                delayed += r->prob_call_delayed;
+                lost += r->prob_call_lost;
+                delay += r->avg_delay_of_calls;
+                delay_sq += r->avg_delay_of_calls * r->avg_delay_of_calls;
+                total += r->avg_answ_time;
+                n++;
+            }
+            if (n == 0) {
+                continue;
+            }
+            double var = (n > 1) ? (delay_sq - delay * delay / n) / (n - 1) : 0.0;
+            fprintf(sweep_file, "%s,%d,%d,%d,%.2f,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n",
+                    scenarios[sc].name,
+                    scenarios[sc].call_center.number_of_gen_opr,
+                    scenarios[sc].call_center.number_of_spec_opr,
+                    scenarios[sc].call_center.length_gen_queue,
+                    scenarios[sc].arrival_rate_per_hour,
+                    n, delayed / n, lost / n, delay / n, sqrt((var > 0.0 ? var : 0.0) / n),
+                    hdr_histogram_percentile(&delays, 99.0), hdr_histogram_percentile(&delays, 99.9), total / n);
+        }
+        fclose(sweep_file);
+        printf("Results saved to outputs/call_center/sweep_results.csv\n");
+    }
+
+    sweep_table_close(table);
+    free_hdr_histogram(&delays);
+    free_scenario_configs(scenarios, n_scenarios);
+    return (status == 0) ? 0 : 1;
+}
+
+// Blocking for 1..ERLANG_MAX_CHANNELS channels from a single ordered-hunting run
+void run_erlang_b_curve() {
+    double blocking[ERLANG_MAX_CHANNELS];
+    unsigned long long seed = replication_base_seed();
+    char key[RESULT_KEY_LEN];
+    size_t key_len = 0, value_len;
+    double *stored = NULL;
+
+    if (use_result_cache()) {
+        key_len = (size_t)snprintf(key, sizeof(key), "erlang_b v%d channels=%d lambda=%d avg=%a events=%d seed=%llu",
+                                   ERLANG_RESULTS_VERSION, ERLANG_MAX_CHANNELS, ERLANG_LAMBDA,
+                                   ERLANG_AVG_DURATION_S, ERLANG_NUMBER_OF_EVENTS, seed);
+        stored = result_store_get(&result_cache, key, key_len, &value_len);
+    }
+    if (stored != NULL && value_len == sizeof(blocking)) {
+        memcpy(blocking, stored, sizeof(blocking));
+    } else {
+        rng_seed(seed);
+        erlang_b_curve(ERLANG_MAX_CHANNELS, ERLANG_LAMBDA, ERLANG_AVG_DURATION_S, ERLANG_NUMBER_OF_EVENTS, blocking);
+        if (key_len > 0) {
+            result_store_put(&result_cache, key, key_len, blocking, sizeof(blocking));
+        }
+    }
+    free(stored);
+
+    FILE *file = fopen("outputs/erlang_b/blk_prob.txt", "w");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Could not open outputs/erlang_b/blk_prob.txt\n");
+        return;
+    }
+    fprintf(file, "Lambda = %d\nNumber Events = %d\nAvg Duration = %g\n",
+            ERLANG_LAMBDA, ERLANG_NUMBER_OF_EVENTS, ERLANG_AVG_DURATION_S);
+    for (int c = 1; c <= ERLANG_MAX_CHANNELS; c++) {
+        fprintf(file, (c < ERLANG_MAX_CHANNELS) ? "%d,%f\n" : "%d,%f", c, blocking[c - 1]);
+        printf("channels=%d: P(block)=%.6f\n", c, blocking[c - 1]);
+    }
+    fclose(file);
+    printf("Results saved to outputs/erlang_b/blk_prob.txt\n");
+}
+
+// Mean and 95% confidence half-width of one field over the replications
+static void print_replication_ci(const char *label, const ErlangRepStat *reps, int n, size_t offset) {
+    double sum = 0.0, sum_sq = 0.0;
+    for (int i = 0; i < n; i++) {
+        double v = *(const double *)((const char *)&reps[i] + offset);
+        sum += v;
+        sum_sq += v * v;
+    }
+    double mean = sum / n;
+    double var = (n > 1) ? (sum_sq - n * mean * mean) / (n - 1) : 0.0;
+    printf("  %-28s %.6f +/- %.6f\n", label, mean, 1.96 * sqrt(var > 0.0 ? var : 0.0) / sqrt(n));
+}
+
+// Independent M/M/c/K replications advanced in lockstep by the uniformized CTMC engine
+void run_erlang_replications(int channels, int queue_capacity, int n_replications) {
+    ErlangRepStat *reps = malloc(n_replications * sizeof(ErlangRepStat));
+    if (reps == NULL) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    seed_random(app_config.simulation.random_seed);
+    erlang_ctmc_replications(channels, ERLANG_LAMBDA, ERLANG_AVG_DURATION_S, queue_capacity,
+                             ERLANG_NUMBER_OF_EVENTS, n_replications, reps);
+
+    char system_size[16];
+    if (queue_capacity < 0) {
+        snprintf(system_size, sizeof(system_size), "inf");
+    } else {
+        snprintf(system_size, sizeof(system_size), "%d", channels + queue_capacity);
+    }
+    printf("M/M/%d/%s, lambda=%d, avg duration=%g s, %d replications of %d arrivals\n",
+           channels, system_size, ERLANG_LAMBDA, ERLANG_AVG_DURATION_S, n_replications, ERLANG_NUMBER_OF_EVENTS);
+    print_replication_ci("Blocking probability:", reps, n_replications, offsetof(ErlangRepStat, block_probability));
+    print_replication_ci("Prob. delayed:", reps, n_replications, offsetof(ErlangRepStat, prob_pkt_delayed));
+    print_replication_ci("Avg delay of delayed (s):", reps, n_replications, offsetof(ErlangRepStat, avg_delay_delayed_pkt));
+    print_replication_ci("Avg busy channels:", reps, n_replications, offsetof(ErlangRepStat, avg_busy));
+    print_replication_ci("Avg queue length:", reps, n_replications, offsetof(ErlangRepStat, avg_queue_length));
+
+    free(reps);
+}
+
+// Delay thresholds (s) of the Erlang-C grid, ascending as erlang_c_system_thresholds() expects
+static const double erlang_c_thresholds[] = {0.0, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0, 5.0, 10.0};
+
+#define ERLANG_C_THRESHOLDS ((int)(sizeof(erlang_c_thresholds) / sizeof(erlang_c_thresholds[0])))
+
+// Stored form of one channel count of the sweep; histogram_size ints follow it,
+// then the log_buckets counts of the log-linear histogram
+typedef struct {
+    double prob_pkt_delayed;
+    double avg_delay_all_pkt;
+    double prob_delayed_more[ERLANG_C_THRESHOLDS];
+    int histogram_size;
+    int log_buckets;
+    uint64_t log_total;
+    double log_min;
+    double log_max;
+    double log_sum;
+} stored_erlang_c_result;
+
+// erlang_c_system_thresholds() from rng_seed(seed), or the stored result of an identical run
+static ErlangCstat erlang_c_cached(int channels, unsigned long long seed, double *prob_delayed_more) {
+    char key[RESULT_KEY_LEN];
+    size_t key_len = 0, value_len;
+    ErlangCstat stats;
+
+    if (use_result_cache()) {
+        int len = append_key(key, 0, "erlang_c v%d channels=%d lambda=%d avg=%a events=%d seed=%llu thresholds=",
+                             ERLANG_RESULTS_VERSION, channels, ERLANG_LAMBDA, ERLANG_AVG_DURATION_S,
+                             ERLANG_NUMBER_OF_EVENTS, seed);
+        for (int k = 0; k < ERLANG_C_THRESHOLDS; k++) {
+            len = append_key(key, len, "%a,", erlang_c_thresholds[k]);
+        }
+        if (erlang_service() != NULL) {
+            len = append_service_key(key, len, " service=", erlang_service());
+        }
+        // A key that does not fit is neither looked up nor stored
+        key_len = (len < 0) ? 0 : (size_t)len;
+        stored_erlang_c_result *r = (key_len > 0) ? result_store_get(&result_cache, key, key_len, &value_len) : NULL;
+        init_sample_histogram(&stats.log_histogram);
+        if (r != NULL && value_len >= sizeof(*r) && r->log_buckets == stats.log_histogram.n_buckets &&
+            value_len == sizeof(*r) + (size_t)r->histogram_size * sizeof(int) + r->log_buckets * sizeof(uint64_t)) {
+            stats.prob_pkt_delayed = r->prob_pkt_delayed;
+            stats.avg_delay_all_pkt = r->avg_delay_all_pkt;
+            stats.prob_pkt_delayed_more_ax = r->prob_delayed_more[0];
+            stats.histogram_size = r->histogram_size;
+            stats.histogram = malloc((r->histogram_size > 0 ? r->histogram_size : 1) * sizeof(int));
+            if (stats.histogram == NULL) {
+                perror("malloc failed");
+                exit(EXIT_FAILURE);
+            }
+            memcpy(stats.histogram, r + 1, r->histogram_size * sizeof(int));
+            memcpy(stats.log_histogram.counts, (const int *)(r + 1) + r->histogram_size,
+                   r->log_buckets * sizeof(uint64_t));
+            stats.log_histogram.total = r->log_total;
+            stats.log_histogram.min = r->log_min;
+            stats.log_histogram.max = r->log_max;
+            stats.log_histogram.sum = r->log_sum;
+            memcpy(prob_delayed_more, r->prob_delayed_more, sizeof(r->prob_delayed_more));
+            free(r);
+            return stats;
+        }
+        free(r);
+        free_hdr_histogram(&stats.log_histogram);
+    }
+
+    rng_seed(seed);
+    stats = erlang_c_system_thresholds(channels, ERLANG_LAMBDA, ERLANG_AVG_DURATION_S, erlang_service(),
+                                       ERLANG_NUMBER_OF_EVENTS, erlang_c_thresholds, ERLANG_C_THRESHOLDS,
+                                       prob_delayed_more);
+
+    if (key_len > 0) {
+        const hdr_histogram *log = &stats.log_histogram;
+        size_t size = sizeof(stored_erlang_c_result) + stats.histogram_size * sizeof(int) +
+                      log->n_buckets * sizeof(uint64_t);
+        stored_erlang_c_result *r = calloc(1, size);
+        if (r == NULL) {
+            perror("calloc failed");
+            exit(EXIT_FAILURE);
+        }
+        r->prob_pkt_delayed = stats.prob_pkt_delayed;
+        r->avg_delay_all_pkt = stats.avg_delay_all_pkt;
+        memcpy(r->prob_delayed_more, prob_delayed_more, sizeof(r->prob_delayed_more));
+        r->histogram_size = stats.histogram_size;
+        memcpy(r + 1, stats.histogram, stats.histogram_size * sizeof(int));
+        r->log_buckets = log->n_buckets;
+        r->log_total = log->total;
+        r->log_min = log->min;
+        r->log_max = log->max;
+        r->log_sum = log->sum;
+        memcpy((int *)(r + 1) + r->histogram_size, log->counts, log->n_buckets * sizeof(uint64_t));
+        result_store_put(&result_cache, key, key_len, r, size);
+        free(r);
+    }
+    return stats;
+}
+
+// One simulation per channel count covers every threshold of the grid. Every channel
+// count starts from the same seed so each one can be served from the result store.
+void run_erlang_c_sweep() {
+    const int n_thresholds = ERLANG_C_THRESHOLDS;
+    double prob_delayed_more[ERLANG_C_THRESHOLDS];
+    char filename[128];
+    unsigned long long seed = replication_base_seed();
+
+    for (int channels = 1; channels <= ERLANG_MAX_CHANNELS; channels++) {
+        ErlangCstat stats = erlang_c_cached(channels, seed, prob_delayed_more);
+
+        for (int k = 0; k < n_thresholds; k++) {
+            snprintf(filename, sizeof(filename), "outputs/erlang_c/num_channels_%d_threshold_%.3f.txt",
+                     channels, erlang_c_thresholds[k]);
+            FILE *file = fopen(filename, "w");
+            if (file == NULL) {
+                fprintf(stderr, "Error: Could not open %s\n", filename);
+                continue;
+            }
+            fprintf(file, "Estimated Probability of Delayed: %f\n", stats.prob_pkt_delayed);
+            fprintf(file, "Estimated Probability of Delayed more than: %f\n", prob_delayed_more[k]);
+            fprintf(file, "Average Delay: %f\n", stats.avg_delay_all_pkt);
+            fprintf(file, "Histogram: ");
+            for (int i = 0; i < stats.histogram_size; i++) {
+                fprintf(file, (i > 0) ? ",%d" : "%d", stats.histogram[i]);
+            }
+            fprintf(file, "\n");
+            fprintf(file, "Delay percentiles (p50,p90,p99,p99.9): %f,%f,%f,%f\n",
+                    hdr_histogram_percentile(&stats.log_histogram, 50.0),
+                    hdr_histogram_percentile(&stats.log_histogram, 90.0),
+                    hdr_histogram_percentile(&stats.log_histogram, 99.0),
+                    hdr_histogram_percentile(&stats.log_histogram, 99.9));
+            fclose(file);
+        }
+
+        printf("channels=%d: P(delay)=%.4f, P(delay >= %.3f s)=%.4f, p99 wait when delayed=%.6f s\n", channels,
+               stats.prob_pkt_delayed, erlang_c_thresholds[n_thresholds / 2], prob_delayed_more[n_thresholds / 2],
+               hdr_histogram_percentile(&stats.log_histogram, 99.0));
+        free(stats.histogram);
+        free_hdr_histogram(&stats.log_histogram);
+    }
+    printf("Results saved to outputs/erlang_c/\n");
+}
+
+static void print_vr_estimate(const char *label, vr_estimate est) {
+    printf("  %-28s %.6f +/- %.6f (plain +/- %.6f, VRF %.2f)\n", label, est.mean,
+           1.96 * est.std_error, 1.96 * est.plain_std_error, est.reduction_factor);
+}
+
+#define VR_CC_OUTPUTS 4
+#define VR_CC_CONTROLS 3
+
+// Antithetic pairs of call center runs, with the sample means of the inputs
+// (interarrival time, generic-only fraction, general service time) as controls
+void run_variance_reduction(int gen_opr, int spec_opr, int queue_len, int n_pairs) {
+    static const char *labels[VR_CC_OUTPUTS] = {
+        "Prob. General call delayed:", "Prob. General call lost:",
+        "Avg delay (s):", "Avg answer time (s):"
+    };
+    scenario_config scenario;
+    call_center_config config = initialize_config(&scenario);
+    config.number_of_gen_opr = gen_opr;
+    config.number_of_spec_opr = spec_opr;
+    config.length_gen_queue = queue_len;
+
+    double x_mean[VR_CC_CONTROLS];
+    call_center_input_means(config, &x_mean[0], &x_mean[1], &x_mean[2]);
+
+    double *y[2][VR_CC_OUTPUTS];
+    double *x[2];
+    for (int a = 0; a < 2; a++) {
+        for (int k = 0; k < VR_CC_OUTPUTS; k++) {
+            y[a][k] = alloc_doubles(n_pairs);
+        }
+        x[a] = alloc_doubles(n_pairs * VR_CC_CONTROLS);
+    }
+
+    unsigned long long base = replication_base_seed();
+    for (int rep = 0; rep < n_pairs; rep++) {
+        // Second run of each pair replays the same stream mirrored (u -> 1 - u)
+        for (int a = 0; a < 2; a++) {
+            rng_seed(base + (unsigned long long)rep);
+            rng_set_antithetic(a);
+            call_center_stats stats = simulate(config, scenario.simulation.number_of_events);
+
+            y[a][0][rep] = stats.general_p_stats.prob_call_delayed;
+            y[a][1][rep] = stats.general_p_stats.prob_call_lost;
+            y[a][2][rep] = stats.general_p_stats.avg_delay_of_calls;
+            y[a][3][rep] = stats.area_spec_stats.avg_answ_time;
+            x[a][rep * VR_CC_CONTROLS + 0] = stats.general_p_stats.mean_interarrival_time;
+            x[a][rep * VR_CC_CONTROLS + 1] = stats.general_p_stats.generic_only_fraction;
+            x[a][rep * VR_CC_CONTROLS + 2] = stats.general_p_stats.mean_service_time;
+            free_call_center_stats(&stats);
+        }
+    }
+    rng_set_antithetic(0);
+
+    printf("Configuration %d/%d/%d, %d antithetic pairs of %d events\n\n",
+           gen_opr, spec_opr, queue_len, n_pairs, scenario.simulation.number_of_events);
+    printf("Independent runs:\n");
+    for (int k = 0; k < VR_CC_OUTPUTS; k++) {
+        print_vr_estimate(labels[k], vr_control_variates(y[0][k], NULL, n_pairs, 0, NULL));
+    }
+    printf("\nAntithetic pairs:\n");
+    for (int k = 0; k < VR_CC_OUTPUTS; k++) {
+        print_vr_estimate(labels[k], vr_antithetic(y[0][k], y[1][k], NULL, NULL, n_pairs, 0, NULL));
+    }
+    printf("\nAntithetic pairs + control variates:\n");
+    for (int k = 0; k < VR_CC_OUTPUTS; k++) {
+        print_vr_estimate(labels[k], vr_antithetic(y[0][k], y[1][k], x[0], x[1], n_pairs, VR_CC_CONTROLS, x_mean));
+    }
+
+    for (int a = 0; a < 2; a++) {
+        for (int k = 0; k < VR_CC_OUTPUTS; k++) {
+            free(y[a][k]);
+        }
+        free(x[a]);
+    }
+}
+
+// Same estimators on erlang_gen_system, checked against the exact M/M/c/K values
+// when service is exponential
+void run_erlang_variance_reduction(int channels, int queue_capacity, int n_pairs) {
+    double *blocked[2], *delayed[2], *x[2];
+    const double x_mean[2] = {1.0 / ERLANG_LAMBDA, ERLANG_AVG_DURATION_S};
+    // Deterministic service times carry no noise to regress on
+    int n_controls = (app_config.erlang_service.kind == SERVICE_DETERMINISTIC) ? 1 : 2;
+
+    for (int a = 0; a < 2; a++) {
+        blocked[a] = alloc_doubles(n_pairs);
+        delayed[a] = alloc_doubles(n_pairs);
+        x[a] = alloc_doubles(n_pairs * 2);
+    }
+
+    unsigned long long base = replication_base_seed();
+    for (int rep = 0; rep < n_pairs; rep++) {
+        for (int a = 0; a < 2; a++) {
+            rng_seed(base + (unsigned long long)rep);
+            rng_set_antithetic(a);
+            ErlangGenStat st = erlang_gen_system(channels, ERLANG_LAMBDA, ERLANG_AVG_DURATION_S, erlang_service(),
+                                                 ERLANG_NUMBER_OF_EVENTS, 0.0, queue_capacity);
+            blocked[a][rep] = st.block_probability;
+            delayed[a][rep] = st.prob_pkt_delayed;
+            x[a][rep * n_controls + 0] = st.mean_interarrival;
+            if (n_controls == 2) {
+                x[a][rep * 2 + 1] = st.mean_service;
+            }
+            free(st.histogram);
+            free_hdr_histogram(&st.log_histogram);
+            free(st.queue_length_distribution);
+        }
+    }
+    rng_set_antithetic(0);
+
+    printf("M/%s/%d/%d, lambda=%d, avg duration=%g s (%s), %d antithetic pairs of %d arrivals\n\n",
+           (erlang_service() != NULL) ? "G" : "M", channels, channels + queue_capacity, ERLANG_LAMBDA,
+           ERLANG_AVG_DURATION_S, service_kind_name(app_config.erlang_service.kind), n_pairs, ERLANG_NUMBER_OF_EVENTS);
+    printf("Independent runs:\n");
+    print_vr_estimate("Blocking probability:", vr_control_variates(blocked[0], NULL, n_pairs, 0, NULL));
+    print_vr_estimate("Prob. delayed:", vr_control_variates(delayed[0], NULL, n_pairs, 0, NULL));
+    printf("\nAntithetic pairs + control variates:\n");
+    print_vr_estimate("Blocking probability:",
+                      vr_antithetic(blocked[0], blocked[1], x[0], x[1], n_pairs, n_controls, x_mean));
+    print_vr_estimate("Prob. delayed:", vr_antithetic(delayed[0], delayed[1], x[0], x[1], n_pairs, n_controls, x_mean));
+    if (erlang_service() == NULL) {
+        double exact_blocked, exact_delayed;
+        erlang_gen_analytic(channels, ERLANG_LAMBDA, ERLANG_AVG_DURATION_S, queue_capacity,
+                            &exact_blocked, &exact_delayed);
+        printf("\nExact M/M/c/K: blocking %.6f, delayed %.6f\n", exact_blocked, exact_delayed);
+    }
+
+    for (int a = 0; a < 2; a++) {
+        free(blocked[a]);
+        free(delayed[a]);
+        free(x[a]);
+    }
+}
+
 void print_usage(const char *program_name) {
     printf("Usage:\n");
     printf("  %s optimize                    - Run optimization to find best configuration\n", program_name);
+    printf("  %s optimize_surrogate          - Same search guided by a Gaussian-process model, in\n", program_name);
+    printf("                                  surrogate_budget simulations whatever the grid size\n");
     printf("  %s <gen> <spec> <queue>       - Run simulation with specific configuration\n", program_name);
-    printf("  %s sensitivity <gen> <spec> <queue> - Run sensitivity analysis\n", program_name);
+    printf("  %s sensitivity <gen> <spec> <queue> [snapshot] - Run sensitivity analysis (optionally\n", program_name);
+    printf("                                  branching every replication from a warm-up snapshot)\n");
+    printf("  %s warmup <gen> <spec> <queue> <snapshot> - Save the state after warmup_events arrivals\n", program_name);
+    printf("  %s checkpoint <gen> <spec> <queue> <snapshot> - Run saving a snapshot every checkpoint_events\n", program_name);
+    printf("                                  arrivals; rerun to resume after an interruption\n");
+    printf("  %s soak <gen> <spec> <queue> <events> [snapshot] - Long run of any number of arrivals\n", program_name);
+    printf("                                  (64-bit), keeping only delay histograms and sums\n");
+    printf("  %s batch <file> [threads]     - Run every scenario of a batch file on a thread pool\n", program_name);
+    printf("  %s sweep <file> [workers] [reps] - Run a batch file's scenarios x replications on forked\n", program_name);
+    printf("                                  worker processes; results survive crashes and reruns resume\n");
+    printf("  %s erlang_b                    - Erlang-B blocking curve for every channel count in one run\n", program_name);
+    printf("  %s erlang_reps <channels> <queue> [reps] - Lockstep M/M/c/K replications (queue -1: unbounded)\n", program_name);
+    printf("  %s erlang_c                    - Erlang-C delay threshold sweep (one run per channel count)\n", program_name);
+    printf("  %s vr <gen> <spec> <queue> [pairs] - Antithetic + control-variate estimates of a configuration\n", program_name);
+    printf("  %s vr_erlang <channels> <queue> [pairs] - Same on M/M/c/K, against the exact values\n", program_name);
+    printf("  %s pdes <gen> <spec> <queue> [events] - Parallel two-tier run against the sequential engine\n", program_name);
+    printf("\nOptions:\n");
+    printf("  --config <file>               - Load parameters from an INI file instead of constants.h\n");
+    printf("  --engine event|kw|ctmc|pdes   - Event-list engine (default), Kiefer-Wolfowitz recursion,\n");
+    printf("                                  steady-state CTMC solution with exponential durations, or the\n");
+    printf("                                  event-list engine with the two tiers on two threads\n");
+    printf("  --trace bin|csv               - Per-call delays as a columnar binary trace (default, written\n");
+    printf("                                  by a background thread) or as the legacy CSV\n");
+    printf("  --predictor average|rate      - Wait estimate given to queued calls: queue position times the\n");
+    printf("                                  mean observed wait (default) or from the EWMA completion rate\n");
+    printf("  --no-cache                    - Always simulate instead of reusing results from\n");
+    printf("                                  %s (optimize, sensitivity, erlang_b, erlang_c)\n", RESULT_CACHE_PATH);
     printf("\nExamples:\n");
     printf("  %s optimize\n", program_name);
     printf("  %s 2 3 4\n", program_name);
     printf("  %s sensitivity 2 2 2\n", program_name);
+    printf("  %s --config configs/default.ini optimize\n", program_name);
+    printf("  %s batch configs/batch_example.ini 4\n", program_name);
 }
 
 int main(int argc, char *argv[]) {
+    default_scenario_config(&app_config);
+
+    // Strip "--config <file>", "--engine <name>", "--trace <format>", "--predictor <kind>" and "--no-cache" so the remaining arguments keep their positions
+    int n_args = 1;
+    int predictor = WAIT_PREDICTOR_QUEUE_AVERAGE;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--config") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --config requires a file path\n\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+            if (load_config_file(argv[++i], &app_config) != 0) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            const char *format = (i + 1 < argc) ? argv[++i] : "";
+            if (strcmp(format, "bin") == 0 || strcmp(format, "csv") == 0) {
+                delay_trace_csv = strcmp(format, "csv") == 0;
+            } else {
+                fprintf(stderr, "Error: --trace must be 'bin' or 'csv'\n\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--predictor") == 0) {
+            predictor = wait_predictor_kind_from_name((i + 1 < argc) ? argv[++i] : "");
+            if (predictor < 0) {
+                fprintf(stderr, "Error: --predictor must be 'average' or 'rate'\n\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--no-cache") == 0) {
+            result_cache_enabled = false;
+        } else if (strcmp(argv[i], "--engine") == 0) {
+            const char *engine = (i + 1 < argc) ? argv[++i] : "";
+            if (strcmp(engine, "event") == 0) {
+                simulate = start_call_center;
+                engine_name = "event";
+            } else if (strcmp(engine, "kw") == 0) {
+                simulate = start_call_center_kw;
+                engine_name = "kw";
+            } else if (strcmp(engine, "ctmc") == 0) {
+                simulate = start_call_center_ctmc;
+                engine_name = "ctmc";
+            } else if (strcmp(engine, "pdes") == 0) {
+                simulate = start_call_center_pdes;
+                engine_name = "pdes";
+            } else {
+                fprintf(stderr, "Error: --engine must be 'event', 'kw', 'ctmc' or 'pdes'\n\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else {
+            argv[n_args++] = argv[i];
+        }
+    }
+    argc = n_args;
+    app_config.call_center.wait_predictor = (wait_predictor_kind)predictor;
+    // The recursion and the CTMC keep the original estimate
+    if (predictor != WAIT_PREDICTOR_QUEUE_AVERAGE && !require_event_list_engine("--predictor rate")) {
+        return 1;
+    }
+    if (call_center_has_patience(app_config.call_center) && !require_event_list_engine("caller abandonment")) {
+        return 1;
+    }
+    if (call_center_has_priorities(app_config.call_center) && !require_event_list_engine("priority classes")) {
+        return 1;
+    }
+    if (call_center_has_arrival_process(app_config.call_center) && !require_event_list_engine("non-Poisson arrivals")) {
+        return 1;
+    }
+    if (call_center_has_general_service(app_config.call_center) && !reject_ctmc_engine("general service times")) {
+        return 1;
+    }
+
     if (argc == 2 && strcmp(argv[1], "optimize") == 0) {
         run_optimization();
+    } else if (argc == 2 && strcmp(argv[1], "optimize_surrogate") == 0) {
+        run_surrogate_optimization();
+    } else if (argc == 2 && strcmp(argv[1], "erlang_b") == 0) {
+        run_erlang_b_curve();
+    } else if ((argc == 4 || argc == 5) && strcmp(argv[1], "erlang_reps") == 0) {
+        int channels = atoi(argv[2]);
+        int queue_capacity = atoi(argv[3]);
+        int n_replications = (argc == 5) ? atoi(argv[4]) : app_config.simulation.num_replications;
+
+        if (channels <= 0 || queue_capacity < CTMC_UNBOUNDED_QUEUE || n_replications <= 0) {
+            fprintf(stderr, "Error: channels and replications must be positive, queue >= -1\n");
+            print_usage(argv[0]);
+            return 1;
+        }
+        if (service_dist_is_general(&app_config.erlang_service)) {
+            fprintf(stderr, "Error: erlang_reps solves M/M/c/K; set erlang_service_distribution = exponential\n");
+            return 1;
+        }
+
+        run_erlang_replications(channels, queue_capacity, n_replications);
+    } else if (argc == 2 && strcmp(argv[1], "erlang_c") == 0) {
+        run_erlang_c_sweep();
+    } else if ((argc == 5 || argc == 6) && strcmp(argv[1], "vr") == 0) {
+        int gen_opr = atoi(argv[2]);
+        int spec_opr = atoi(argv[3]);
+        int queue_len = atoi(argv[4]);
+        int n_pairs = (argc == 6) ? atoi(argv[5]) : app_config.simulation.num_replications;
+
+        if (gen_opr <= 0 || spec_opr <= 0 || queue_len <= 0 || n_pairs < VR_CC_CONTROLS + 2) {
+            fprintf(stderr, "Error: All parameters must be positive integers, pairs >= %d\n", VR_CC_CONTROLS + 2);
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        run_variance_reduction(gen_opr, spec_opr, queue_len, n_pairs);
+    } else if ((argc == 4 || argc == 5) && strcmp(argv[1], "vr_erlang") == 0) {
+        int channels = atoi(argv[2]);
+        int queue_capacity = atoi(argv[3]);
+        int n_pairs = (argc == 5) ? atoi(argv[4]) : app_config.simulation.num_replications;
+
+        if (channels <= 0 || queue_capacity < 0 || n_pairs < 4) {
+            fprintf(stderr, "Error: channels must be positive, queue >= 0, pairs >= 4\n");
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        run_erlang_variance_reduction(channels, queue_capacity, n_pairs);
+    } else if ((argc == 3 || argc == 4) && strcmp(argv[1], "batch") == 0) {
+        int n_threads = (argc == 4) ? atoi(argv[3]) : 0;
+
+        if (n_threads < 0) {
+            fprintf(stderr, "Error: Thread count must be a positive integer\n");
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        int status = run_batch(argv[2], n_threads);
+        PROF_REPORT(stderr);
+        return status;
+    } else if (argc >= 3 && argc <= 5 && strcmp(argv[1], "sweep") == 0) {
+        int n_workers = (argc >= 4) ? atoi(argv[3]) : default_thread_count();
+        int n_replications = (argc == 5) ? atoi(argv[4]) : 1;
+
+        if (n_workers <= 0 || n_replications <= 0) {
+            fprintf(stderr, "Error: Worker and replication counts must be positive integers\n");
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        return run_sweep(argv[2], n_workers, n_replications);
     } else if (argc == 4) {
         int gen_opr = atoi(argv[1]);
         int spec_opr = atoi(argv[2]);
@@ -297,7 +1954,23 @@ int main(int argc, char *argv[]) {
         }
         
         run_simulation(gen_opr, spec_opr, queue_len);
-    } else if (argc == 5 && strcmp(argv[1], "sensitivity") == 0) {
+    } else if ((argc == 5 || argc == 6) && strcmp(argv[1], "sensitivity") == 0) {
+        int gen_opr = atoi(argv[2]);
+        int spec_opr = atoi(argv[3]);
+        int queue_len = atoi(argv[4]);
+        const char *snapshot_path = (argc == 6) ? argv[5] : NULL;
+        
+        if (gen_opr <= 0 || spec_opr <= 0 || queue_len <= 0) {
+            fprintf(stderr, "Error: All parameters must be positive integers\n");
+            print_usage(argv[0]);
+            return 1;
+        }
+        if (snapshot_path != NULL && !require_event_engine("sensitivity from a snapshot")) {
+            return 1;
+        }
+        
+        run_sensitivity_analysis(gen_opr, spec_opr, queue_len, snapshot_path);
+    } else if (argc == 6 && (strcmp(argv[1], "warmup") == 0 || strcmp(argv[1], "checkpoint") == 0)) {
         int gen_opr = atoi(argv[2]);
         int spec_opr = atoi(argv[3]);
         int queue_len = atoi(argv[4]);
@@ -307,13 +1980,56 @@ int main(int argc, char *argv[]) {
             print_usage(argv[0]);
             return 1;
         }
+        if (!require_event_engine(argv[1])) {
+            return 1;
+        }
         
-        run_sensitivity_analysis(gen_opr, spec_opr, queue_len);
+        int status = (strcmp(argv[1], "warmup") == 0)
+                         ? run_warmup(gen_opr, spec_opr, queue_len, argv[5])
+                         : run_checkpointed(gen_opr, spec_opr, queue_len, argv[5],
+                                            app_config.simulation.number_of_events, false);
+        if (status != 0) {
+            return 1;
+        }
+    } else if ((argc == 5 || argc == 6) && strcmp(argv[1], "pdes") == 0) {
+        int gen_opr = atoi(argv[2]);
+        int spec_opr = atoi(argv[3]);
+        int queue_len = atoi(argv[4]);
+        int number_of_events = (argc == 6) ? atoi(argv[5]) : app_config.simulation.number_of_events;
+
+        if (gen_opr <= 0 || spec_opr <= 0 || queue_len <= 0 || number_of_events <= 0) {
+            fprintf(stderr, "Error: All parameters must be positive integers\n");
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        if (run_pdes_comparison(gen_opr, spec_opr, queue_len, number_of_events) != 0) {
+            return 1;
+        }
+    } else if ((argc == 6 || argc == 7) && strcmp(argv[1], "soak") == 0) {
+        int gen_opr = atoi(argv[2]);
+        int spec_opr = atoi(argv[3]);
+        int queue_len = atoi(argv[4]);
+        long long number_of_events = strtoll(argv[5], NULL, 10);
+
+        if (gen_opr <= 0 || spec_opr <= 0 || queue_len <= 0 || number_of_events <= 0) {
+            fprintf(stderr, "Error: All parameters must be positive integers\n");
+            print_usage(argv[0]);
+            return 1;
+        }
+        if (!require_event_engine(argv[1])) {
+            return 1;
+        }
+
+        if (run_checkpointed(gen_opr, spec_opr, queue_len, (argc == 7) ? argv[6] : NULL, number_of_events, true) != 0) {
+            return 1;
+        }
     } else {
         fprintf(stderr, "Error: Invalid arguments\n\n");
         print_usage(argv[0]);
         return 1;
     }
     
+    PROF_REPORT(stderr);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "arrival_process.h"
+#include "profiling.h"
+#include "../poisson/poisson.h"
+
+static const char *const arrival_kind_names[] = {"poisson", "mmpp", "batch", "renewal"};
+
+const char *arrival_kind_name(arrival_kind kind) {
+    return arrival_kind_names[kind];
+}
+
+int arrival_kind_from_name(const char *name) {
+    for (int k = 0; k < (int)(sizeof(arrival_kind_names) / sizeof(arrival_kind_names[0])); k++) {
+        if (strcmp(name, arrival_kind_names[k]) == 0) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int load_renewal_gaps(const char *path, arrival_config *config) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Error: Could not open inter-arrival file %s\n", path);
+        return -1;
+    }
+
+    int capacity = 1024, n = 0;
+    double *gaps = malloc(capacity * sizeof(double));
+    if (!gaps) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    double gap, total = 0.0;
+    while (fscanf(f, "%lf", &gap) == 1) {
+        if (gap < 0.0) {
+            break;
+        }
+        if (n == capacity) {
+            capacity *= 2;
+            double *tmp = realloc(gaps, capacity * sizeof(double));
+            if (!tmp) {
+                perror("realloc failed");
+                exit(EXIT_FAILURE);
+            }
+            gaps = tmp;
+        }
+        gaps[n++] = gap;
+        total += gap;
+    }
+    int complete = feof(f);
+    fclose(f);
+
+    if (!complete || n == 0 || total <= 0.0) {
+        fprintf(stderr, "Error: %s must hold non-negative inter-arrival times with a positive mean\n", path);
+        free(gaps);
+        return -1;
+    }
+    qsort(gaps, n, sizeof(double), compare_doubles);
+    free(config->renewal_gaps);
+    config->renewal_gaps = gaps;
+    config->n_renewal_gaps = n;
+    return 0;
+}
+
+void copy_renewal_gaps(arrival_config *config) {
+    if (config->renewal_gaps == NULL) {
+        return;
+    }
+    double *gaps = malloc(config->n_renewal_gaps * sizeof(double));
+    if (!gaps) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(gaps, config->renewal_gaps, config->n_renewal_gaps * sizeof(double));
+    config->renewal_gaps = gaps;
+}
+
+void free_renewal_gaps(arrival_config *config) {
+    free(config->renewal_gaps);
+    config->renewal_gaps = NULL;
+    config->n_renewal_gaps = 0;
+}
+
+// Mean of the piecewise-linear inverse CDF through the sorted sample, which is
+// what renewal_gap() draws from
+static double renewal_sample_mean(const arrival_config *config) {
+    const double *g = config->renewal_gaps;
+    int n = config->n_renewal_gaps;
+    if (n == 1) {
+        return g[0];
+    }
+    double total = 0.0;
+    for (int i = 0; i + 1 < n; i++) {
+        total += 0.5 * (g[i] + g[i + 1]);
+    }
+    return total / (n - 1);
+}
+
+void init_arrival_process(arrival_process *p, const arrival_config *config, double rate) {
+    memset(p, 0, sizeof(*p));
+    p->config = config;
+    p->gaps = malloc(ARRIVAL_BLOCK * sizeof(double));
+    PROF_ALLOC();
+    if (!p->gaps) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    switch (config->kind) {
+    case ARRIVAL_MMPP: {
+        // Phases are visited in turn, so phase k holds for a fraction of time
+        // proportional to its mean sojourn
+        double level_time = 0.0, time = 0.0;
+        for (int k = 0; k < config->n_phases; k++) {
+            level_time += config->mmpp_levels[k] * config->mmpp_sojourn_s[k];
+            time += config->mmpp_sojourn_s[k];
+        }
+        for (int k = 0; k < config->n_phases; k++) {
+            p->rate_scale[k] = rate * config->mmpp_levels[k] * time / level_time;
+        }
+        p->phase_left = next_poisson(config->mmpp_sojourn_s[0]);
+        break;
+    }
+    case ARRIVAL_BATCH:
+        p->gap_scale = config->batch_mean_size / rate;
+        if (config->batch_mean_size > 1.0) {
+            p->batch_log_q = log(1.0 - 1.0 / config->batch_mean_size);
+        }
+        break;
+    case ARRIVAL_RENEWAL:
+        p->gap_scale = 1.0 / (rate * renewal_sample_mean(config));
+        break;
+    default:
+        p->gap_scale = 1.0 / rate;
+        break;
+    }
+}
+
+void free_arrival_process(arrival_process *p) {
+    free(p->gaps);
+    p->gaps = NULL;
+    p->head = p->count = 0;
+}
+
+// Exponential gaps at the current phase's rate; when a gap outlasts the phase,
+// memorylessness lets it restart from the phase change at the next rate
+static double mmpp_gap(arrival_process *p) {
+    const arrival_config *config = p->config;
+    double gap = 0.0;
+    for (;;) {
+        double d = next_poisson(1.0 / p->rate_scale[p->phase]);
+        if (d < p->phase_left) {
+            p->phase_left -= d;
+            return gap + d;
+        }
+        gap += p->phase_left;
+        p->phase = (p->phase + 1) % config->n_phases;
+        p->phase_left = next_poisson(config->mmpp_sojourn_s[p->phase]);
+    }
+}
+
+// A batch opens with an exponential gap, then its other calls follow at gap 0;
+// batch sizes are geometric on {1, 2, ...} with mean batch_mean_size
+static double batch_gap(arrival_process *p) {
+    if (p->batch_left > 0) {
+        p->batch_left--;
+        return 0.0;
+    }
+    if (p->batch_log_q < 0.0) {
+        double u;
+        do {
+            u = next_uniform();
+        } while (u == 0.0);
+        p->batch_left = (int)(log(u) / p->batch_log_q);
+    }
+    return next_poisson(p->gap_scale);
+}
+
+// Inverse CDF of the sample, interpolated linearly between order statistics
+static double renewal_gap(arrival_process *p) {
+    const double *g = p->config->renewal_gaps;
+    int n = p->config->n_renewal_gaps;
+    if (n == 1) {
+        return p->gap_scale * g[0];
+    }
+    double x = next_uniform() * (n - 1);
+    int i = (int)x;
+    return p->gap_scale * (g[i] + (x - i) * (g[i + 1] - g[i]));
+}
+
+void arrival_process_fill(arrival_process *p) {
+    switch (p->config->kind) {
+    case ARRIVAL_MMPP:
+        for (int i = 0; i < ARRIVAL_BLOCK; i++) {
+            p->gaps[i] = mmpp_gap(p);
+        }
+        break;
+    case ARRIVAL_BATCH:
+        for (int i = 0; i < ARRIVAL_BLOCK; i++) {
+            p->gaps[i] = batch_gap(p);
+        }
+        break;
+    case ARRIVAL_RENEWAL:
+        for (int i = 0; i < ARRIVAL_BLOCK; i++) {
+            p->gaps[i] = renewal_gap(p);
+        }
+        break;
+    default:
+        for (int i = 0; i < ARRIVAL_BLOCK; i++) {
+            p->gaps[i] = next_poisson(p->gap_scale);
+        }
+        break;
+    }
+    p->head = 0;
+    p->count = ARRIVAL_BLOCK;
+}
@@ -0,0 +1,76 @@
+#ifndef ARRIVAL_PROCESS_H
+#define ARRIVAL_PROCESS_H
+
+#include <stdint.h>
+
+// Arrival processes beyond Poisson, all scaled to the same mean rate so only
+// the burstiness changes:
+//   ARRIVAL_MMPP     Markov-modulated Poisson: the rate cycles through phases
+//                    with exponential sojourns, each phase at a relative level
+//   ARRIVAL_BATCH    batch Poisson: Poisson epochs, each bringing a geometric
+//                    number of simultaneous calls
+//   ARRIVAL_RENEWAL  renewal process with i.i.d. gaps from an empirical sample
+//
+// Gaps are generated ARRIVAL_BLOCK at a time into a buffer, so drawing one is
+// a buffer pop; the process state (phase, batch in progress) carries over from
+// one block to the next. Draws come from the calling thread's stream.
+
+#define ARRIVAL_BLOCK 2048
+#define ARRIVAL_MAX_PHASES 4
+
+typedef enum {
+    ARRIVAL_POISSON,
+    ARRIVAL_MMPP,
+    ARRIVAL_BATCH,
+    ARRIVAL_RENEWAL,
+} arrival_kind;
+
+typedef struct {
+    arrival_kind kind;
+    int n_phases;                               // MMPP phases, derived from mmpp_levels
+    double mmpp_levels[ARRIVAL_MAX_PHASES];     // Relative rate of each phase
+    double mmpp_sojourn_s[ARRIVAL_MAX_PHASES];  // Mean time spent in each phase
+    double batch_mean_size;                     // Mean calls per batch (>= 1)
+    double *renewal_gaps;                       // Sorted empirical gaps (any unit)
+    int n_renewal_gaps;
+} arrival_config;
+
+typedef struct {
+    const arrival_config *config;
+    double rate_scale[ARRIVAL_MAX_PHASES];  // MMPP: arrival rate of each phase
+    double gap_scale;                       // Batch: mean gap between epochs; renewal: sample scale
+    int phase;                              // MMPP phase and the time left in it
+    double phase_left;
+    int batch_left;                         // Calls of the current batch still to arrive
+    double batch_log_q;                     // log P(batch continues), 0 for single calls
+    uint32_t head;
+    uint32_t count;
+    double *gaps;                           // ARRIVAL_BLOCK buffered gaps, [head, count) unread
+} arrival_process;
+
+const char *arrival_kind_name(arrival_kind kind);
+// Kind named `name`; -1 when unknown
+int arrival_kind_from_name(const char *name);
+
+// Reads a whitespace-separated list of positive gaps into a sorted table.
+// Returns 0 on success, -1 (with a message) on failure.
+int load_renewal_gaps(const char *path, arrival_config *config);
+// Every config owns its gaps: one copied by value must take a private copy
+// before it is loaded into or freed
+void copy_renewal_gaps(arrival_config *config);
+void free_renewal_gaps(arrival_config *config);
+
+// `rate` is the mean arrival rate in calls per second
+void init_arrival_process(arrival_process *p, const arrival_config *config, double rate);
+void free_arrival_process(arrival_process *p);
+// Refills the buffer with the next ARRIVAL_BLOCK gaps
+void arrival_process_fill(arrival_process *p);
+
+static inline double arrival_process_next(arrival_process *p) {
+    if (p->head == p->count) {
+        arrival_process_fill(p);
+    }
+    return p->gaps[p->head++];
+}
+
+#endif // ARRIVAL_PROCESS_H
@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "class_queue.h"
+#include "profiling.h"
+
+static void init_ring(class_ring *ring, uint32_t capacity) {
+    ring->head = 0;
+    ring->size = 0;
+    ring->capacity = capacity;
+    ring->items = malloc(capacity * sizeof(void *));
+    PROF_ALLOC();
+    if (!ring->items) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void init_class_queue(class_queue *q, int n_classes, int capacity_hint) {
+    uint32_t capacity = 8;
+    while (capacity < (uint32_t)capacity_hint && capacity < (1u << 30)) {
+        capacity *= 2;
+    }
+
+    q->occupied = 0;
+    q->n_classes = (n_classes < 1) ? 1 : (n_classes > CLASS_QUEUE_MAX_CLASSES) ? CLASS_QUEUE_MAX_CLASSES : n_classes;
+    q->size = 0;
+    q->rings = malloc(q->n_classes * sizeof(class_ring));
+    if (!q->rings) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int k = 0; k < q->n_classes; k++) {
+        init_ring(&q->rings[k], capacity);
+    }
+}
+
+void free_class_queue(class_queue *q) {
+    for (int k = 0; k < q->n_classes; k++) {
+        free(q->rings[k].items);
+    }
+    free(q->rings);
+    q->rings = NULL;
+    q->n_classes = 0;
+    q->size = 0;
+    q->occupied = 0;
+}
+
+// Doubles a full ring, unwrapping its items to the start of the new buffer
+static void grow_ring(class_ring *ring) {
+    uint32_t capacity = ring->capacity * 2;
+    void **items = malloc(capacity * sizeof(void *));
+    PROF_ALLOC();
+    if (!items) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    uint32_t first = ring->capacity - ring->head;
+    if (first > ring->size) {
+        first = ring->size;
+    }
+    memcpy(items, ring->items + ring->head, first * sizeof(void *));
+    memcpy(items + first, ring->items, (ring->size - first) * sizeof(void *));
+    free(ring->items);
+    ring->items = items;
+    ring->head = 0;
+    ring->capacity = capacity;
+}
+
+void class_queue_push(class_queue *q, int k, void *item) {
+    class_ring *ring = &q->rings[k];
+    if (ring->size == ring->capacity) {
+        grow_ring(ring);
+    }
+    ring->items[(ring->head + ring->size) & (ring->capacity - 1)] = item;
+    ring->size++;
+    q->size++;
+    q->occupied |= 1ull << k;
+}
+
+void class_queue_push_front(class_queue *q, int k, void *item) {
+    class_ring *ring = &q->rings[k];
+    if (ring->size == ring->capacity) {
+        grow_ring(ring);
+    }
+    ring->head = (ring->head - 1) & (ring->capacity - 1);
+    ring->items[ring->head] = item;
+    ring->size++;
+    q->size++;
+    q->occupied |= 1ull << k;
+}
+
+void *class_queue_pop(class_queue *q) {
+    if (q->occupied == 0) {
+        return NULL;
+    }
+    int k = __builtin_ctzll(q->occupied);
+    class_ring *ring = &q->rings[k];
+    void *item = ring->items[ring->head];
+    ring->head = (ring->head + 1) & (ring->capacity - 1);
+    q->size--;
+    if (--ring->size == 0) {
+        q->occupied &= ~(1ull << k);
+    }
+    return item;
+}
+
+void *class_queue_at(const class_queue *q, int k, uint32_t i) {
+    const class_ring *ring = &q->rings[k];
+    return ring->items[(ring->head + i) & (ring->capacity - 1)];
+}
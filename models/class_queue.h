@@ -0,0 +1,47 @@
+#ifndef CLASS_QUEUE_H
+#define CLASS_QUEUE_H
+
+#include <stdint.h>
+
+// Multi-level FIFO queue for up to 64 priority classes, class 0 served first.
+// Each class is a growable ring of item pointers, and a bitmap records which
+// classes hold items, so the next class to serve is one find-first-set and
+// every push and pop is O(1) however many items are queued.
+
+#define CLASS_QUEUE_MAX_CLASSES 64
+
+typedef struct {
+    void **items;
+    uint32_t head;          // Index of the oldest item
+    uint32_t size;
+    uint32_t capacity;      // Power of two
+} class_ring;
+
+typedef struct {
+    uint64_t occupied;      // Bit k set while class k holds items
+    int n_classes;
+    int size;               // Items over all classes
+    class_ring *rings;
+} class_queue;
+
+void init_class_queue(class_queue *q, int n_classes, int capacity_hint);
+void free_class_queue(class_queue *q);
+// Appends to the tail of class k
+void class_queue_push(class_queue *q, int k, void *item);
+// Puts an item back at the head of class k, ahead of everything in its class
+void class_queue_push_front(class_queue *q, int k, void *item);
+// Removes the head of the highest non-empty class; NULL when the queue is empty
+void *class_queue_pop(class_queue *q);
+// Item at position i (0 = head) of class k
+void *class_queue_at(const class_queue *q, int k, uint32_t i);
+
+// Highest non-empty class, or -1 when the queue is empty
+static inline int class_queue_top_class(const class_queue *q) {
+    return q->occupied ? __builtin_ctzll(q->occupied) : -1;
+}
+
+static inline uint32_t class_queue_class_size(const class_queue *q, int k) {
+    return q->rings[k].size;
+}
+
+#endif // CLASS_QUEUE_H
@@ -0,0 +1,29 @@
+#ifndef COMPENSATED_SUM_H
+#define COMPENSATED_SUM_H
+
+#include <math.h>
+
+// Neumaier's compensated summation: the rounding error of every addition is
+// carried in a second term, so the error of a sum of n terms stays a few ulps
+// instead of growing with n. Used for running totals over billions of calls.
+
+typedef struct {
+    double sum;
+    double compensation;
+} compensated_sum;
+
+static inline void compensated_add(compensated_sum *s, double x) {
+    double t = s->sum + x;
+    if (fabs(s->sum) >= fabs(x)) {
+        s->compensation += (s->sum - t) + x;
+    } else {
+        s->compensation += (x - t) + s->sum;
+    }
+    s->sum = t;
+}
+
+static inline double compensated_value(const compensated_sum *s) {
+    return s->sum + s->compensation;
+}
+
+#endif // COMPENSATED_SUM_H
@@ -1,9 +1,11 @@
 #include "delay_array.h"
+#include "profiling.h"
 
 void init_delay_array(delay_array *arr) {
     arr->size = 0;
     arr->capacity = 10; 
     arr->data = malloc(arr->capacity * sizeof(delay));
+    PROF_ALLOC();
     if (!arr->data) {
         perror("malloc failed");
         exit(EXIT_FAILURE);
@@ -15,6 +17,7 @@ void add_delay(delay_array *arr, delay c) {
     if (arr->size >= arr->capacity) {
         arr->capacity *= 2;
         delay *tmp = realloc(arr->data, arr->capacity * sizeof(delay));
+        PROF_ALLOC();
         if (!tmp) {
             perror("realloc failed");
             exit(EXIT_FAILURE);
@@ -1,6 +1,7 @@
 #ifndef DELAY_ARRAY_H
 #define DELAY_ARRAY_H
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -11,8 +12,8 @@ typedef struct {
 
 typedef struct {
     delay *data;
-    int size;      
-    int capacity; 
+    size_t size;
+    size_t capacity;
 } delay_array;
 
 void init_delay_array(delay_array *arr);
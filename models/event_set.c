@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "event_set.h"
+#include "profiling.h"
+
+// Links slots [from, capacity) into the free list ahead of its current head
+static void link_free_slots(event_set *set, int from) {
+    for (int h = set->capacity - 1; h >= from; h--) {
+        set->slots[h].position = set->free_slot;
+        set->free_slot = h;
+    }
+}
+
+void init_event_set(event_set *set, int capacity) {
+    set->size = 0;
+    set->capacity = (capacity > 0) ? capacity : 1;
+    set->heap = malloc(set->capacity * sizeof(int));
+    set->slots = malloc(set->capacity * sizeof(event_set_slot));
+    PROF_ALLOC();
+    if (!set->heap || !set->slots) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    set->free_slot = EVENT_HANDLE_NONE;
+    link_free_slots(set, 0);
+}
+
+void free_event_set(event_set *set) {
+    free(set->heap);
+    free(set->slots);
+    set->heap = NULL;
+    set->slots = NULL;
+    set->size = set->capacity = 0;
+    set->free_slot = EVENT_HANDLE_NONE;
+}
+
+static inline void place(event_set *set, int i, int handle) {
+    set->heap[i] = handle;
+    set->slots[handle].position = i;
+}
+
+// Moves the handle at heap index i up or down until the heap is ordered again
+static void sift(event_set *set, int i) {
+    int handle = set->heap[i];
+    double time = set->slots[handle].time;
+
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (set->slots[set->heap[parent]].time <= time) {
+            break;
+        }
+        place(set, i, set->heap[parent]);
+        i = parent;
+    }
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= set->size) {
+            break;
+        }
+        if (child + 1 < set->size && set->slots[set->heap[child + 1]].time < set->slots[set->heap[child]].time) {
+            child++;
+        }
+        if (time <= set->slots[set->heap[child]].time) {
+            break;
+        }
+        place(set, i, set->heap[child]);
+        i = child;
+    }
+    place(set, i, handle);
+}
+
+int event_set_schedule(event_set *set, double time, void *data) {
+    if (set->free_slot == EVENT_HANDLE_NONE) {
+        int old_capacity = set->capacity;
+        set->capacity *= 2;
+        int *heap = realloc(set->heap, set->capacity * sizeof(int));
+        event_set_slot *slots = realloc(set->slots, set->capacity * sizeof(event_set_slot));
+        PROF_ALLOC();
+        if (!heap || !slots) {
+            perror("realloc failed");
+            exit(EXIT_FAILURE);
+        }
+        set->heap = heap;
+        set->slots = slots;
+        link_free_slots(set, old_capacity);
+    }
+
+    int handle = set->free_slot;
+    set->free_slot = set->slots[handle].position;
+    set->slots[handle].time = time;
+    set->slots[handle].data = data;
+    place(set, set->size++, handle);
+    sift(set, set->size - 1);
+    return handle;
+}
+
+// Takes the handle at heap index i out and returns its slot to the free list
+static void remove_at(event_set *set, int i) {
+    int handle = set->heap[i];
+    int last = set->heap[--set->size];
+    if (i < set->size) {
+        place(set, i, last);
+        sift(set, i);
+    }
+    set->slots[handle].position = set->free_slot;
+    set->free_slot = handle;
+}
+
+bool event_set_cancel(event_set *set, int handle) {
+    if (handle < 0 || handle >= set->capacity) {
+        return false;
+    }
+    int i = set->slots[handle].position;
+    if (i < 0 || i >= set->size || set->heap[i] != handle) {
+        return false;
+    }
+    remove_at(set, i);
+    return true;
+}
+
+void *event_set_pop(event_set *set, double *time) {
+    int handle = set->heap[0];
+    *time = set->slots[handle].time;
+    void *data = set->slots[handle].data;
+    remove_at(set, 0);
+    return data;
+}
+
+void event_set_shift(event_set *set, double delta) {
+    for (int i = 0; i < set->size; i++) {
+        set->slots[set->heap[i]].time += delta;
+    }
+}
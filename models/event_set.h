@@ -0,0 +1,53 @@
+#ifndef EVENT_SET_H
+#define EVENT_SET_H
+
+#include <stdbool.h>
+
+// Set of pending timed events with cancellable handles: an indexed binary
+// min-heap on time. Scheduling returns a handle that stays valid until the
+// event fires or is cancelled; cancelling through it is O(log n), with no
+// search, and slots are recycled so steady-state use does not allocate.
+//
+// A handle is reused once its event is gone, so callers must forget it when
+// their event fires (event_set_pop) or is cancelled.
+
+#define EVENT_HANDLE_NONE (-1)
+
+typedef struct {
+    double time;
+    void *data;
+    int position;           // Index in heap while scheduled, next free slot otherwise
+} event_set_slot;
+
+typedef struct {
+    int *heap;              // Handles, ordered as a min-heap on their slot's time
+    event_set_slot *slots;  // Indexed by handle
+    int size;
+    int capacity;
+    int free_slot;          // Head of the free slot list, or EVENT_HANDLE_NONE
+} event_set;
+
+void init_event_set(event_set *set, int capacity);
+void free_event_set(event_set *set);
+// Schedules `data` at `time` and returns its handle
+int event_set_schedule(event_set *set, double time, void *data);
+// Removes a scheduled event; false if the handle holds no scheduled event
+bool event_set_cancel(event_set *set, int handle);
+// Removes the earliest event, storing its time in *time, and returns its data
+void *event_set_pop(event_set *set, double *time);
+// Moves every scheduled time by delta; the heap order is unchanged
+void event_set_shift(event_set *set, double delta);
+
+static inline bool event_set_empty(const event_set *set) {
+    return set->size == 0;
+}
+
+static inline double event_set_next_time(const event_set *set) {
+    return set->slots[set->heap[0]].time;
+}
+
+static inline double event_set_time(const event_set *set, int handle) {
+    return set->slots[handle].time;
+}
+
+#endif // EVENT_SET_H
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdr_histogram.h"
+
+void init_hdr_histogram(hdr_histogram *h, double unit, double highest, int bits) {
+    double top = highest / unit;
+    uint64_t ticks = (top < 1.8e19) ? (uint64_t)top : UINT64_MAX;
+
+    h->unit = unit;
+    h->bits = bits;
+    h->n_buckets = hdr_histogram_index(bits, ticks) + 1;
+    h->counts = calloc(h->n_buckets, sizeof(uint64_t));
+    if (!h->counts) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    h->total = 0;
+    h->min = 0.0;
+    h->max = 0.0;
+    h->sum = 0.0;
+}
+
+void free_hdr_histogram(hdr_histogram *h) {
+    free(h->counts);
+    h->counts = NULL;
+    h->n_buckets = 0;
+    h->total = 0;
+}
+
+void hdr_histogram_reset(hdr_histogram *h) {
+    memset(h->counts, 0, h->n_buckets * sizeof(uint64_t));
+    h->total = 0;
+    h->min = 0.0;
+    h->max = 0.0;
+    h->sum = 0.0;
+}
+
+int hdr_histogram_merge(hdr_histogram *dst, const hdr_histogram *src) {
+    if (dst->unit != src->unit || dst->bits != src->bits || dst->n_buckets != src->n_buckets) {
+        return -1;
+    }
+    if (src->total == 0) {
+        return 0;
+    }
+    for (int i = 0; i < dst->n_buckets; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    if (dst->total == 0 || src->min < dst->min) {
+        dst->min = src->min;
+    }
+    if (dst->total == 0 || src->max > dst->max) {
+        dst->max = src->max;
+    }
+    dst->total += src->total;
+    dst->sum += src->sum;
+    return 0;
+}
+
+double hdr_histogram_percentile(const hdr_histogram *h, double q) {
+    if (h->total == 0) {
+        return 0.0;
+    }
+    double wanted = q / 100.0 * (double)h->total;
+    uint64_t rank = (wanted < 1.0) ? 1 : (uint64_t)wanted + ((double)(uint64_t)wanted < wanted);
+    if (rank > h->total) {
+        rank = h->total;
+    }
+
+    uint64_t seen = 0;
+    int i = 0;
+    while (i < h->n_buckets - 1 && (seen += h->counts[i]) < rank) {
+        i++;
+    }
+
+    // Midpoint of the bucket, which holds values [lower, lower + width) ticks
+    double lower, width;
+    if (i < (1 << h->bits)) {
+        lower = i;
+        width = 1.0;
+    } else {
+        int shift = (i >> (h->bits - 1)) - 1;
+        lower = (double)((uint64_t)(i - (shift << (h->bits - 1))) << shift);
+        width = (double)(1ull << shift);
+    }
+    double value = (lower + 0.5 * width) * h->unit;
+    if (value < h->min) {
+        return h->min;
+    }
+    return (value > h->max) ? h->max : value;
+}
@@ -0,0 +1,64 @@
+#ifndef HDR_HISTOGRAM_H
+#define HDR_HISTOGRAM_H
+
+#include <stdint.h>
+
+// High-dynamic-range histogram with log-linear buckets. Values are counted in
+// multiples ("ticks") of a resolution unit; ticks below 2^bits get a bucket each,
+// and every power of two above is split into 2^(bits-1) equal buckets, so a
+// bucket is never wider than 2^-(bits-1) of its values. Recording is O(1) and
+// two histograms with the same layout merge by adding their counts.
+//
+// Values above `highest` are counted in the last bucket (min, max and sum stay
+// exact), so percentiles beyond it are clamped to the largest value recorded.
+
+#define HDR_DEFAULT_BITS 7  // Buckets within 1/64 (0.8% from the midpoint)
+
+typedef struct {
+    double unit;            // Value of one tick
+    int bits;
+    int n_buckets;
+    uint64_t *counts;
+    uint64_t total;
+    double min;
+    double max;
+    double sum;
+} hdr_histogram;
+
+void init_hdr_histogram(hdr_histogram *h, double unit, double highest, int bits);
+void free_hdr_histogram(hdr_histogram *h);
+void hdr_histogram_reset(hdr_histogram *h);
+// Adds the counts of src to dst; -1 (and dst unchanged) unless both share a layout
+int hdr_histogram_merge(hdr_histogram *dst, const hdr_histogram *src);
+// Value at or below which q percent (0..100) of the recorded values lie
+double hdr_histogram_percentile(const hdr_histogram *h, double q);
+
+static inline double hdr_histogram_mean(const hdr_histogram *h) {
+    return (h->total > 0) ? h->sum / (double)h->total : 0.0;
+}
+
+static inline int hdr_histogram_index(int bits, uint64_t ticks) {
+    if (ticks < (1ull << bits)) {
+        return (int)ticks;
+    }
+    int shift = 64 - __builtin_clzll(ticks) - bits;
+    return (shift << (bits - 1)) + (int)(ticks >> shift);
+}
+
+static inline void hdr_histogram_record(hdr_histogram *h, double value) {
+    double scaled = value / h->unit;
+    uint64_t ticks = (scaled > 0.0) ? ((scaled < 1.8e19) ? (uint64_t)scaled : UINT64_MAX) : 0;
+    int index = hdr_histogram_index(h->bits, ticks);
+    h->counts[(index < h->n_buckets) ? index : h->n_buckets - 1]++;
+
+    if (h->total == 0 || value < h->min) {
+        h->min = value;
+    }
+    if (h->total == 0 || value > h->max) {
+        h->max = value;
+    }
+    h->total++;
+    h->sum += value;
+}
+
+#endif // HDR_HISTOGRAM_H
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "linked-list.h"
+#include "profiling.h"
 
 // Function that removes the first element of the linked list
 list *__remove(list *pointer)
@@ -15,8 +16,11 @@ list *__add(list *pointer, int n_type, double n_time)
 {
     list *lp = pointer;
     list *p_aux, *p_next;
+    int depth = 0;
+    PROF_ALLOC();
     if (pointer == NULL)
     {
+        PROF_LIST_INSERT(depth);
         pointer = (list *)malloc(sizeof(list));
         pointer->next = NULL;
         pointer->type = n_type;
@@ -27,6 +31,7 @@ list *__add(list *pointer, int n_type, double n_time)
     {
         if (pointer->time > n_time)
         {
+            PROF_LIST_INSERT(depth);
             p_aux = (list *)malloc(sizeof(list));
             p_aux->type = n_type;
             p_aux->time = n_time;
@@ -42,7 +47,9 @@ list *__add(list *pointer, int n_type, double n_time)
                 break;
             pointer = (list *)pointer->next;
             p_next = (list *)pointer->next;
+            depth++;
         }
+        PROF_LIST_INSERT(depth);
         p_aux = (list *)pointer->next;
         pointer->next = (struct list *)malloc(sizeof(list));
         pointer = (list *)pointer->next;
@@ -59,12 +66,15 @@ list *__add(list *pointer, int n_type, double n_time)
 list *__add_fifo(list *pointer, int n_type, double n_time)
 {
     list *new_node = (list *)malloc(sizeof(list));
+    int depth = 0;
+    PROF_ALLOC();
     new_node->type = n_type;
     new_node->time = n_time;
     new_node->next = NULL;
 
     if (pointer == NULL)
     {
+        PROF_LIST_INSERT(depth);
         return new_node;
     }
     else
@@ -73,7 +83,9 @@ list *__add_fifo(list *pointer, int n_type, double n_time)
         while (pointer->next != NULL)
         {
             pointer = pointer->next;
+            depth++;
         }
+        PROF_LIST_INSERT(depth);
         pointer->next = new_node;
         
         return head; 
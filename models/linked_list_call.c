@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "linked_list_call.h"
+#include "profiling.h"
 
 // Function that removes the first element of the linked list
 call_list *_remove(call_list *pointer)
@@ -16,8 +17,11 @@ call_list *_add(call_list *pointer, int n_type, double n_time, call c)
 {
     call_list *lp = pointer;
     call_list *p_aux, *p_next;
+    int depth = 0;
+    PROF_ALLOC();
     if (pointer == NULL)
     {
+        PROF_LIST_INSERT(depth);
         pointer = (call_list *)malloc(sizeof(call_list));
         pointer->next = NULL;
         pointer->type = n_type;
@@ -29,6 +33,7 @@ call_list *_add(call_list *pointer, int n_type, double n_time, call c)
     {
         if (pointer->time > n_time)
         {
+            PROF_LIST_INSERT(depth);
             p_aux = (call_list *)malloc(sizeof(call_list));
             p_aux->type = n_type;
             p_aux->time = n_time;
@@ -45,7 +50,9 @@ call_list *_add(call_list *pointer, int n_type, double n_time, call c)
                 break;
             pointer = (call_list *)pointer->next;
             p_next = (call_list *)pointer->next;
+            depth++;
         }
+        PROF_LIST_INSERT(depth);
         p_aux = (call_list *)pointer->next;
         pointer->next = (struct call_list *)malloc(sizeof(call_list));
         pointer = (call_list *)pointer->next;
@@ -60,6 +67,39 @@ call_list *_add(call_list *pointer, int n_type, double n_time, call c)
     }
 }
 
+// Allocates an element that is not linked into any list yet
+call_list *_node(int n_type, double n_time, call c)
+{
+    PROF_ALLOC();
+    call_list *node = (call_list *)malloc(sizeof(call_list));
+    if (!node)
+    {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    node->type = n_type;
+    node->time = n_time;
+    node->c = c;
+    node->next = NULL;
+    return node;
+}
+
+// Links an element made by _node into the list, after those with the same time as _add does
+call_list *_insert(call_list *pointer, call_list *node)
+{
+    call_list **link = &pointer;
+    int depth = 0;
+    while (*link != NULL && (*link)->time <= node->time)
+    {
+        link = &(*link)->next;
+        depth++;
+    }
+    PROF_LIST_INSERT(depth);
+    node->next = *link;
+    *link = node;
+    return pointer;
+}
+
 void _print(call_list *pointer)
 {
     if (pointer == NULL)
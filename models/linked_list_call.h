@@ -1,5 +1,5 @@
-#ifndef LINKED_LIST_H
-#define LINKED_LIST_H
+#ifndef LINKED_LIST_CALL_H
+#define LINKED_LIST_CALL_H
 #include <stdbool.h>
 
 typedef enum{
@@ -9,15 +9,23 @@ typedef enum{
 
 typedef struct general_call {
     bool is_generic_only;
-    double answer_time;
+    double answer_time;            // When a general operator first answered
     double prediction_waiting;
     double original_arrival_time;  // Track when call first arrived to general system
+    double service_start;          // answer_time plus any time spent preempted, so that
+                                   // departure - service_start is the service received
 } general_call;
 
 
 typedef struct call {
     CALL_TYPE type;
     struct general_call gen_call;
+    int priority;                   // Class 0 is served first
+    double remaining_service;       // Service still owed to a preempted call, 0 otherwise
+    // While waiting in a queue: handle of the caller's abandonment timer, and
+    // whether the caller already hung up (left in place until it reaches the head)
+    int patience_timer;
+    bool abandoned;
 } call;
 
 typedef struct call_list
@@ -30,9 +38,11 @@ typedef struct call_list
 
 call_list *_remove(call_list *pointer);
 call_list *_add(call_list *pointer, int n_type, double n_time, call c);
+call_list *_node(int n_type, double n_time, call c);
+call_list *_insert(call_list *pointer, call_list *node);
 void _print(call_list *pointer);
 
 #define ARRIVAL 1
 #define DEPARTURE 2
 
-#endif // LINKED_LIST_H
+#endif // LINKED_LIST_CALL_H
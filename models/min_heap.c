@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "min_heap.h"
+#include "profiling.h"
+
+void init_min_heap(min_heap *heap, int capacity) {
+    heap->size = 0;
+    heap->capacity = (capacity > 0) ? capacity : 1;
+    heap->nodes = malloc(heap->capacity * sizeof(heap_node));
+    PROF_ALLOC();
+    if (!heap->nodes) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void min_heap_push(min_heap *heap, double key, int value) {
+    if (heap->size == heap->capacity) {
+        heap->capacity *= 2;
+        heap_node *tmp = realloc(heap->nodes, heap->capacity * sizeof(heap_node));
+        PROF_ALLOC();
+        if (!tmp) {
+            perror("realloc failed");
+            exit(EXIT_FAILURE);
+        }
+        heap->nodes = tmp;
+    }
+
+    // Sift up: move parents down until the new key fits
+    int i = heap->size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap->nodes[parent].key <= key) {
+            break;
+        }
+        heap->nodes[i] = heap->nodes[parent];
+        i = parent;
+    }
+    heap->nodes[i].key = key;
+    heap->nodes[i].value = value;
+}
+
+heap_node min_heap_pop(min_heap *heap) {
+    heap_node top = heap->nodes[0];
+    heap_node last = heap->nodes[--heap->size];
+
+    // Sift down: move the smaller child up until the last node fits
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        if (child + 1 < heap->size && heap->nodes[child + 1].key < heap->nodes[child].key) {
+            child++;
+        }
+        if (last.key <= heap->nodes[child].key) {
+            break;
+        }
+        heap->nodes[i] = heap->nodes[child];
+        i = child;
+    }
+    if (heap->size > 0) {
+        heap->nodes[i] = last;
+    }
+    return top;
+}
+
+void free_min_heap(min_heap *heap) {
+    free(heap->nodes);
+    heap->nodes = NULL;
+    heap->size = heap->capacity = 0;
+}
@@ -0,0 +1,31 @@
+#ifndef MIN_HEAP_H
+#define MIN_HEAP_H
+
+// Binary min-heap of (time, id) pairs stored in one array, so pops and pushes
+// are O(log n) with no per-event allocation.
+
+typedef struct {
+    double key;
+    int value;
+} heap_node;
+
+typedef struct {
+    heap_node *nodes;
+    int size;
+    int capacity;
+} min_heap;
+
+void init_min_heap(min_heap *heap, int capacity);
+void min_heap_push(min_heap *heap, double key, int value);
+heap_node min_heap_pop(min_heap *heap);
+void free_min_heap(min_heap *heap);
+
+static inline int min_heap_empty(const min_heap *heap) {
+    return heap->size == 0;
+}
+
+static inline heap_node min_heap_top(const min_heap *heap) {
+    return heap->nodes[0];
+}
+
+#endif // MIN_HEAP_H
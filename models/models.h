@@ -10,12 +10,26 @@
  *
  */
 
+#ifndef MODELS_H
+#define MODELS_H
+
+#include "hdr_histogram.h"
+
+// Layout of the log-linear histograms below, shared so results can be merged
+#define SAMPLE_HISTOGRAM_RESOLUTION_S 1e-6
+#define SAMPLE_HISTOGRAM_HIGHEST_S 1e5
+
+static inline void init_sample_histogram(hdr_histogram *h) {
+    init_hdr_histogram(h, SAMPLE_HISTOGRAM_RESOLUTION_S, SAMPLE_HISTOGRAM_HIGHEST_S, HDR_DEFAULT_BITS);
+}
+
 typedef struct
 {
     double average;
     double theoretical_average;
     int *histogram;
     int histogram_size;
+    hdr_histogram log_histogram;      // Same samples, log-linear and without an overflow bin
 } Result;
 
 typedef struct 
@@ -24,6 +38,7 @@ typedef struct
     double avg_delay_all_pkt;
     int *histogram;
     int histogram_size;
+    hdr_histogram log_histogram;      // Same waits, log-linear and without an overflow bin
     double prob_pkt_delayed_more_ax;
 } ErlangCstat;
 
@@ -33,6 +48,25 @@ typedef struct
     double avg_delay_all_pkt;
     int *histogram;
     int histogram_size;
+    hdr_histogram log_histogram;      // Same waits, log-linear and without an overflow bin
     double prob_pkt_delayed_more_ax;
     double block_probability;
-} ErlangGenStat;
\ No newline at end of file
+    double avg_busy;                  // Time-averaged busy channels
+    double avg_queue_length;          // Time-averaged waiting calls
+    double *queue_length_distribution; // Fraction of time with k calls waiting
+    int queue_length_distribution_size;
+    double mean_interarrival;         // Sample means of the inputs (known expectations:
+    double mean_service;              // 1/lambda and avg_duration), for control variates
+} ErlangGenStat;
+
+// One replication of the uniformized M/M/c/K chain (see erlang_ctmc_replications)
+typedef struct
+{
+    double block_probability;
+    double prob_pkt_delayed;
+    double avg_delay_delayed_pkt;     // Mean wait of delayed calls, from Little's law
+    double avg_busy;
+    double avg_queue_length;
+} ErlangRepStat;
+
+#endif // MODELS_H
@@ -0,0 +1,111 @@
+#define _POSIX_C_SOURCE 200809L
+#include "profiling.h"
+
+#ifdef TELESIM_PROFILE
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+__thread prof_counters prof_local;
+
+static prof_counters prof_total;
+static pthread_mutex_t prof_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *event_names[PROF_EVENT_TYPES] = {
+    "arrival",
+    "departure (general)",
+    "departure (specific)",
+    "abandonment",
+    "departure",
+};
+
+static const char *queue_names[PROF_QUEUES] = {
+    "general queue",
+    "specific queue",
+    "erlang queue",
+};
+
+uint64_t prof_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void merge_max(uint64_t *dst, uint64_t v) {
+    if (v > *dst) {
+        *dst = v;
+    }
+}
+
+// Adds this thread's counters to the process-wide summary and resets them
+void prof_flush(void) {
+    pthread_mutex_lock(&prof_lock);
+    prof_total.rng_draws += prof_local.rng_draws;
+    prof_total.allocations += prof_local.allocations;
+    prof_total.list_inserts += prof_local.list_inserts;
+    prof_total.list_insert_depth += prof_local.list_insert_depth;
+    merge_max(&prof_total.list_insert_max_depth, prof_local.list_insert_max_depth);
+    for (int q = 0; q < PROF_QUEUES; q++) {
+        prof_total.queue_samples[q] += prof_local.queue_samples[q];
+        prof_total.queue_length_sum[q] += prof_local.queue_length_sum[q];
+        merge_max(&prof_total.queue_length_max[q], prof_local.queue_length_max[q]);
+    }
+    for (int e = 0; e < PROF_EVENT_TYPES; e++) {
+        prof_total.events[e] += prof_local.events[e];
+        prof_total.event_ns[e] += prof_local.event_ns[e];
+    }
+    prof_total.runs++;
+    pthread_mutex_unlock(&prof_lock);
+
+    memset(&prof_local, 0, sizeof(prof_local));
+}
+
+void prof_report(FILE *out) {
+    pthread_mutex_lock(&prof_lock);
+    prof_counters t = prof_total;
+    pthread_mutex_unlock(&prof_lock);
+
+    uint64_t total_events = 0;
+    for (int e = 0; e < PROF_EVENT_TYPES; e++) {
+        total_events += t.events[e];
+    }
+
+    fprintf(out, "\n========================================\n");
+    fprintf(out, "PROFILE (%llu engine runs)\n", (unsigned long long)t.runs);
+    fprintf(out, "========================================\n");
+    fprintf(out, "Events handled: %llu\n", (unsigned long long)total_events);
+    for (int e = 0; e < PROF_EVENT_TYPES; e++) {
+        if (t.events[e] == 0) {
+            continue;
+        }
+        fprintf(out, "  %-22s %12llu  %8.1f ns/event\n", event_names[e],
+                (unsigned long long)t.events[e], (double)t.event_ns[e] / t.events[e]);
+    }
+
+    fprintf(out, "Event list / queue inserts: %llu\n", (unsigned long long)t.list_inserts);
+    if (t.list_inserts > 0) {
+        fprintf(out, "  avg nodes walked: %.2f, max: %llu\n",
+                (double)t.list_insert_depth / t.list_inserts, (unsigned long long)t.list_insert_max_depth);
+    }
+
+    for (int q = 0; q < PROF_QUEUES; q++) {
+        if (t.queue_samples[q] == 0) {
+            continue;
+        }
+        fprintf(out, "  %-22s avg length at enqueue %.2f, max %llu\n", queue_names[q],
+                (double)t.queue_length_sum[q] / t.queue_samples[q], (unsigned long long)t.queue_length_max[q]);
+    }
+
+    fprintf(out, "RNG draws: %llu", (unsigned long long)t.rng_draws);
+    if (total_events > 0) {
+        fprintf(out, " (%.2f per event)", (double)t.rng_draws / total_events);
+    }
+    fprintf(out, "\nAllocations: %llu", (unsigned long long)t.allocations);
+    if (total_events > 0) {
+        fprintf(out, " (%.2f per event)", (double)t.allocations / total_events);
+    }
+    fprintf(out, "\n");
+}
+
+#endif // TELESIM_PROFILE
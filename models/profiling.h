@@ -0,0 +1,93 @@
+#ifndef PROFILING_H
+#define PROFILING_H
+
+#include <stdio.h>
+
+// Opt-in hot-path instrumentation. Build with `make clean && make PROFILE=1`
+// (defines TELESIM_PROFILE); otherwise every PROF_* macro compiles to nothing.
+//
+// Counters are thread-local and merged into a process-wide summary by
+// PROF_FLUSH() at the end of each engine run, so batch runs on the thread
+// pool are counted without contention. PROF_REPORT() prints the summary.
+
+typedef enum {
+    PROF_EVENT_ARRIVAL,
+    PROF_EVENT_DEPARTURE_GENERAL,
+    PROF_EVENT_DEPARTURE_SPECIFIC,
+    PROF_EVENT_ABANDONMENT,  // A queued caller hanging up
+    PROF_EVENT_DEPARTURE,  // Erlang engines do not distinguish tiers
+    PROF_EVENT_TYPES
+} prof_event_type;
+
+typedef enum {
+    PROF_QUEUE_GENERAL,
+    PROF_QUEUE_SPECIFIC,
+    PROF_QUEUE_ERLANG,
+    PROF_QUEUES
+} prof_queue;
+
+#ifdef TELESIM_PROFILE
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t rng_draws;
+    uint64_t allocations;
+    uint64_t list_inserts;
+    uint64_t list_insert_depth;      // Nodes walked by sorted/FIFO inserts
+    uint64_t list_insert_max_depth;
+    uint64_t queue_samples[PROF_QUEUES];
+    uint64_t queue_length_sum[PROF_QUEUES];
+    uint64_t queue_length_max[PROF_QUEUES];
+    uint64_t events[PROF_EVENT_TYPES];
+    uint64_t event_ns[PROF_EVENT_TYPES];
+    uint64_t runs;
+} prof_counters;
+
+extern __thread prof_counters prof_local;
+
+uint64_t prof_now_ns(void);
+void prof_flush(void);
+void prof_report(FILE *out);
+
+#define PROF_RNG_DRAW() (prof_local.rng_draws++)
+#define PROF_ALLOC() (prof_local.allocations++)
+#define PROF_LIST_INSERT(depth)                                         \
+    do {                                                                \
+        uint64_t prof_depth_ = (uint64_t)(depth);                       \
+        prof_local.list_inserts++;                                      \
+        prof_local.list_insert_depth += prof_depth_;                    \
+        if (prof_depth_ > prof_local.list_insert_max_depth)             \
+            prof_local.list_insert_max_depth = prof_depth_;             \
+    } while (0)
+#define PROF_QUEUE_LENGTH(queue, length)                                \
+    do {                                                                \
+        uint64_t prof_len_ = (uint64_t)(length);                        \
+        prof_local.queue_samples[queue]++;                              \
+        prof_local.queue_length_sum[queue] += prof_len_;                \
+        if (prof_len_ > prof_local.queue_length_max[queue])             \
+            prof_local.queue_length_max[queue] = prof_len_;             \
+    } while (0)
+#define PROF_EVENT_BEGIN(var) uint64_t var = prof_now_ns()
+#define PROF_EVENT_END(var, type)                                       \
+    do {                                                                \
+        prof_local.events[type]++;                                      \
+        prof_local.event_ns[type] += prof_now_ns() - (var);             \
+    } while (0)
+#define PROF_FLUSH() prof_flush()
+#define PROF_REPORT(out) prof_report(out)
+
+#else
+
+#define PROF_RNG_DRAW() ((void)0)
+#define PROF_ALLOC() ((void)0)
+#define PROF_LIST_INSERT(depth) ((void)(depth))
+#define PROF_QUEUE_LENGTH(queue, length) ((void)0)
+#define PROF_EVENT_BEGIN(var) ((void)0)
+#define PROF_EVENT_END(var, type) ((void)0)
+#define PROF_FLUSH() ((void)0)
+#define PROF_REPORT(out) ((void)0)
+
+#endif // TELESIM_PROFILE
+
+#endif // PROFILING_H
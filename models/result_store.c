@@ -0,0 +1,209 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "result_store.h"
+
+#define RESULT_STORE_MAGIC 0x32525352u   // "RSR2"
+#define RESULT_STORE_INITIAL_SLOTS 1024
+
+// On-disk record header, followed by key_len key bytes and value_len value bytes
+typedef struct {
+    uint32_t magic;
+    uint32_t key_len;
+    uint32_t value_len;
+    uint32_t value_check;   // Folded hash of the value bytes
+    uint64_t hash;          // Hash of the key bytes
+} record_header;
+
+// FNV-1a
+uint64_t result_store_hash(const void *key, size_t len) {
+    const unsigned char *p = key;
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static uint32_t value_check(const void *value, size_t len) {
+    uint64_t h = result_store_hash(value, len);
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+static void insert_slot(result_store *store, result_store_slot slot) {
+    size_t mask = store->n_slots - 1;
+    size_t i = (size_t)slot.hash & mask;
+    while (store->slots[i].offset != 0) {
+        i = (i + 1) & mask;
+    }
+    store->slots[i] = slot;
+}
+
+static void grow_index(result_store *store) {
+    result_store_slot *old = store->slots;
+    size_t old_n = store->n_slots;
+
+    store->n_slots = old_n ? old_n * 2 : RESULT_STORE_INITIAL_SLOTS;
+    store->slots = calloc(store->n_slots, sizeof(result_store_slot));
+    if (!store->slots) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < old_n; i++) {
+        if (old[i].offset != 0) {
+            insert_slot(store, old[i]);
+        }
+    }
+    free(old);
+}
+
+static void index_record(result_store *store, result_store_slot slot) {
+    // Keep the load factor below 1/2
+    if (2 * (store->n_records + 1) > store->n_slots) {
+        grow_index(store);
+    }
+    insert_slot(store, slot);
+    store->n_records++;
+}
+
+// Slot holding key, or NULL. Candidates with the same hash are confirmed against the stored key.
+static const result_store_slot *find_slot(result_store *store, const void *key, size_t key_len, uint64_t hash) {
+    size_t mask = store->n_slots - 1;
+    char stack_buf[256];
+
+    for (size_t i = (size_t)hash & mask; store->slots[i].offset != 0; i = (i + 1) & mask) {
+        const result_store_slot *s = &store->slots[i];
+        if (s->hash != hash || s->key_len != key_len) {
+            continue;
+        }
+        char *buf = (key_len <= sizeof(stack_buf)) ? stack_buf : malloc(key_len);
+        if (!buf) {
+            perror("malloc failed");
+            exit(EXIT_FAILURE);
+        }
+        int same = fseek(store->file, s->offset, SEEK_SET) == 0 &&
+                   fread(buf, 1, key_len, store->file) == key_len &&
+                   memcmp(buf, key, key_len) == 0;
+        if (buf != stack_buf) {
+            free(buf);
+        }
+        if (same) {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+// Reads the key and value of a record whose header was just read and checks
+// them against the header's hashes
+static int record_is_intact(FILE *file, const record_header *header) {
+    size_t len = (size_t)header->key_len + header->value_len;
+    char *buf = malloc(len ? len : 1);
+    if (!buf) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    int intact = fread(buf, 1, len, file) == len &&
+                 result_store_hash(buf, header->key_len) == header->hash &&
+                 value_check(buf + header->key_len, header->value_len) == header->value_check;
+    free(buf);
+    return intact;
+}
+
+// Opens (creating if needed) the store at path and indexes every record up to
+// the first one that is torn or does not match its hashes, where the file is
+// cut off so that new records are appended after intact ones only.
+int result_store_open(result_store *store, const char *path) {
+    memset(store, 0, sizeof(*store));
+    store->file = fopen(path, "a+b");
+    if (store->file == NULL) {
+        return -1;
+    }
+    grow_index(store);
+
+    fseek(store->file, 0, SEEK_END);
+    long file_size = ftell(store->file);
+    record_header header;
+    long valid_end = 0;
+    rewind(store->file);
+    while (fread(&header, sizeof(header), 1, store->file) == 1 && header.magic == RESULT_STORE_MAGIC) {
+        long key_offset = valid_end + (long)sizeof(header);
+        long record_end = key_offset + (long)header.key_len + (long)header.value_len;
+        if (record_end > file_size || !record_is_intact(store->file, &header)) {
+            break;
+        }
+        result_store_slot slot = {header.hash, key_offset, header.key_len, header.value_len};
+        index_record(store, slot);
+        valid_end = record_end;
+    }
+
+    if (file_size != valid_end) {
+        fflush(store->file);
+        if (ftruncate(fileno(store->file), valid_end) != 0) {
+            perror("ftruncate failed");
+        }
+    }
+    return 0;
+}
+
+void result_store_close(result_store *store) {
+    if (store->file) {
+        fclose(store->file);
+    }
+    free(store->slots);
+    memset(store, 0, sizeof(*store));
+}
+
+void *result_store_get(result_store *store, const void *key, size_t key_len, size_t *value_len) {
+    const result_store_slot *s = find_slot(store, key, key_len, result_store_hash(key, key_len));
+    if (s == NULL) {
+        store->misses++;
+        return NULL;
+    }
+
+    // The file position is just past the key after find_slot()
+    void *value = malloc(s->value_len ? s->value_len : 1);
+    if (!value) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    if (fread(value, 1, s->value_len, store->file) != s->value_len) {
+        free(value);
+        store->misses++;
+        return NULL;
+    }
+    *value_len = s->value_len;
+    store->hits++;
+    return value;
+}
+
+void result_store_put(result_store *store, const void *key, size_t key_len, const void *value, size_t value_len) {
+    uint64_t hash = result_store_hash(key, key_len);
+    if (store->read_only || find_slot(store, key, key_len, hash) != NULL) {
+        return;
+    }
+
+    record_header header = {RESULT_STORE_MAGIC, (uint32_t)key_len, (uint32_t)value_len,
+                            value_check(value, value_len), hash};
+    // "a+b" appends every write at the end regardless of the read position
+    fseek(store->file, 0, SEEK_END);
+    long offset = ftell(store->file);
+    if (fwrite(&header, sizeof(header), 1, store->file) != 1 ||
+        fwrite(key, 1, key_len, store->file) != key_len ||
+        fwrite(value, 1, value_len, store->file) != value_len ||
+        fflush(store->file) != 0) {
+        // Later records would land after the torn one, so nothing more is
+        // appended this session; the next open cuts the torn record off
+        perror("result store write failed");
+        store->read_only = true;
+        if (ftruncate(fileno(store->file), offset) != 0) {
+            perror("ftruncate failed");
+        }
+        return;
+    }
+    result_store_slot slot = {hash, offset + (long)sizeof(header), (uint32_t)key_len, (uint32_t)value_len};
+    index_record(store, slot);
+}
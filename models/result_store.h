@@ -0,0 +1,42 @@
+#ifndef RESULT_STORE_H
+#define RESULT_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Append-only file of (key, value) records with an in-memory hash index built
+// when the file is opened. Keys are canonical byte strings (config + seed +
+// engine version), so identical experiments map to the same record. A record
+// is never rewritten; putting an existing key is a no-op. Each record carries
+// hashes of its key and value, checked when the file is opened.
+
+typedef struct {
+    uint64_t hash;
+    long offset;          // File offset of the key bytes; 0 marks an empty slot
+    uint32_t key_len;
+    uint32_t value_len;
+} result_store_slot;
+
+typedef struct {
+    FILE *file;
+    result_store_slot *slots;   // Open addressing, linear probing
+    size_t n_slots;             // Power of two
+    size_t n_records;
+    long hits;
+    long misses;
+    bool read_only;             // Set by a failed append
+} result_store;
+
+int result_store_open(result_store *store, const char *path);
+void result_store_close(result_store *store);
+
+// Returns a malloc'd copy of the value (caller frees) or NULL on a miss
+void *result_store_get(result_store *store, const void *key, size_t key_len, size_t *value_len);
+void result_store_put(result_store *store, const void *key, size_t key_len, const void *value, size_t value_len);
+
+// Hash under which a key is indexed (FNV-1a)
+uint64_t result_store_hash(const void *key, size_t len);
+
+#endif // RESULT_STORE_H
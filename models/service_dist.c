@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "service_dist.h"
+
+#ifndef M_PI
+#    define M_PI 3.14159265358979323846
+#endif
+
+static const char *const service_kind_names[] = {
+    "exponential", "deterministic", "lognormal", "hyperexponential", "empirical"
+};
+
+const char *service_kind_name(service_kind kind) {
+    return service_kind_names[kind];
+}
+
+int service_kind_from_name(const char *name) {
+    for (int k = 0; k < (int)(sizeof(service_kind_names) / sizeof(service_kind_names[0])); k++) {
+        if (strcmp(name, service_kind_names[k]) == 0) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int load_service_samples(const char *path, service_dist *d) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Error: Could not open holding time file %s\n", path);
+        return -1;
+    }
+
+    int capacity = 1024, n = 0;
+    double *samples = malloc(capacity * sizeof(double));
+    if (!samples) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    double x, total = 0.0;
+    while (fscanf(f, "%lf", &x) == 1 && x >= 0.0) {
+        if (n == capacity) {
+            capacity *= 2;
+            double *tmp = realloc(samples, capacity * sizeof(double));
+            if (!tmp) {
+                perror("realloc failed");
+                exit(EXIT_FAILURE);
+            }
+            samples = tmp;
+        }
+        samples[n++] = x;
+        total += x;
+    }
+    int complete = feof(f);
+    fclose(f);
+
+    if (!complete || n < 2 || total <= 0.0) {
+        fprintf(stderr, "Error: %s must hold at least 2 non-negative holding times with a positive mean\n", path);
+        free(samples);
+        return -1;
+    }
+
+    // Equal-probability bins between sample quantiles follow a heavy tail far
+    // better than equal widths; the density is uniform within each bin
+    qsort(samples, n, sizeof(double), compare_doubles);
+    int n_bins = (n - 1 < SERVICE_MAX_BINS) ? n - 1 : SERVICE_MAX_BINS;
+    double mean = 0.0;
+    for (int j = 0; j <= n_bins; j++) {
+        double pos = (double)j * (n - 1) / n_bins;
+        int i = (int)pos;
+        d->bin_edges[j] = (i + 1 < n) ? samples[i] + (pos - i) * (samples[i + 1] - samples[i]) : samples[n - 1];
+        d->bin_cdf[j] = (double)j / n_bins;
+        if (j > 0) {
+            mean += 0.5 * (d->bin_edges[j - 1] + d->bin_edges[j]) / n_bins;
+        }
+    }
+    free(samples);
+    if (mean <= 0.0) {
+        fprintf(stderr, "Error: %s holds only zero holding times\n", path);
+        return -1;
+    }
+
+    // Rescaled to mean 1, like every other law
+    for (int j = 0; j <= n_bins; j++) {
+        d->bin_edges[j] /= mean;
+    }
+    d->bin_cdf[n_bins] = 1.0;
+    d->n_bins = n_bins;
+    for (int k = 0, j = 0; k < n_bins; k++) {
+        while (d->bin_cdf[j + 1] <= (double)k / n_bins) {
+            j++;
+        }
+        d->guide[k] = j;
+    }
+    return 0;
+}
+
+// Unit-mean survival function and density of the tabulated laws
+
+static void lognormal_params(double cv, double *mu, double *sigma) {
+    double s2 = log(1.0 + cv * cv);
+    *sigma = sqrt(s2);
+    *mu = -0.5 * s2;
+}
+
+// Balanced means: p1 * m1 = p2 * m2 = 1/2
+static void hyperexponential_params(double cv, double *p1, double *m1, double *m2) {
+    double c2 = cv * cv;
+    *p1 = 0.5 * (1.0 + sqrt((c2 - 1.0) / (c2 + 1.0)));
+    *m1 = 0.5 / *p1;
+    *m2 = 0.5 / (1.0 - *p1);
+}
+
+static double survival(const service_dist *d, double x, double *density) {
+    if (x <= 0.0) {
+        *density = 0.0;
+        return 1.0;
+    }
+    if (d->kind == SERVICE_LOGNORMAL) {
+        double mu, sigma;
+        lognormal_params(d->cv, &mu, &sigma);
+        double z = (log(x) - mu) / sigma;
+        *density = exp(-0.5 * z * z) / (x * sigma * sqrt(2.0 * M_PI));
+        return 0.5 * erfc(z / sqrt(2.0));
+    }
+    double p1, m1, m2;
+    hyperexponential_params(d->cv, &p1, &m1, &m2);
+    double s1 = p1 * exp(-x / m1), s2 = (1.0 - p1) * exp(-x / m2);
+    *density = s1 / m1 + s2 / m2;
+    return s1 + s2;
+}
+
+// Bisection on the survival function, for the table
+static double quantile_bisect(const service_dist *d, double u) {
+    double density, lo = 0.0, hi = 1.0;
+    while (survival(d, hi, &density) > 1.0 - u) {
+        lo = hi;
+        hi *= 2.0;
+    }
+    for (int it = 0; it < 100 && hi - lo > 1e-15 * hi; it++) {
+        double mid = 0.5 * (lo + hi);
+        if (survival(d, mid, &density) > 1.0 - u) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return 0.5 * (lo + hi);
+}
+
+// The survival function is convex past the last table point, so Newton steps
+// from there approach the root from below without overshooting
+double service_dist_tail(const service_dist *d, double u) {
+    double target = 1.0 - u;
+    double x = d->quantiles[SERVICE_TABLE_SIZE - 1];
+    if (target <= 0.0) {
+        target = 0x1.0p-53;
+    }
+    for (int it = 0; it < 100; it++) {
+        double density;
+        double s = survival(d, x, &density);
+        if (density <= 0.0) {
+            break;
+        }
+        double step = (s - target) / density;
+        x += step;
+        if (step <= 1e-12 * x) {
+            break;
+        }
+    }
+    return x;
+}
+
+bool prepare_service_dist(service_dist *d) {
+    if (d->kind != SERVICE_LOGNORMAL && d->kind != SERVICE_HYPEREXPONENTIAL) {
+        return true;
+    }
+    if (d->cv <= 0.0 || (d->kind == SERVICE_HYPEREXPONENTIAL && d->cv < 1.0)) {
+        return false;
+    }
+    if (d->table_kind == d->kind && d->table_cv == d->cv) {
+        return true;
+    }
+    d->quantiles[0] = 0.0;
+    for (int i = 1; i < SERVICE_TABLE_SIZE; i++) {
+        d->quantiles[i] = quantile_bisect(d, (double)i / SERVICE_TABLE_SIZE);
+    }
+    d->table_kind = d->kind;
+    d->table_cv = d->cv;
+    return true;
+}
@@ -0,0 +1,95 @@
+#ifndef SERVICE_DIST_H
+#define SERVICE_DIST_H
+
+#include <stdbool.h>
+#include "../poisson/poisson.h"
+
+// Service-time laws as scale families: every law is stored for mean 1 and a
+// draw is multiplied by the wanted mean, so one table serves any mean.
+//   SERVICE_EXPONENTIAL       next_poisson, as before
+//   SERVICE_DETERMINISTIC     always the mean
+//   SERVICE_LOGNORMAL         coefficient of variation cv
+//   SERVICE_HYPEREXPONENTIAL  two phases with balanced means, cv >= 1
+//   SERVICE_EMPIRICAL         equal-probability histogram fitted to a sample
+//
+// Every non-trivial draw is one uniform through the inverse CDF, so antithetic
+// runs mirror service times too. Lognormal and hyperexponential quantiles are
+// tabulated on SERVICE_TABLE_SIZE cells and interpolated linearly; only the
+// last cell solves the exact tail. The empirical histogram is searched through
+// a guide table. Both are O(1) per draw.
+
+#define SERVICE_TABLE_SIZE 1024
+#define SERVICE_MAX_BINS 256
+
+typedef enum {
+    SERVICE_EXPONENTIAL,
+    SERVICE_DETERMINISTIC,
+    SERVICE_LOGNORMAL,
+    SERVICE_HYPEREXPONENTIAL,
+    SERVICE_EMPIRICAL,
+} service_kind;
+
+typedef struct {
+    service_kind kind;
+    double cv;                                  // Lognormal and hyperexponential
+    // Empirical: bin j covers [bin_edges[j], bin_edges[j + 1]) with probability
+    // bin_cdf[j + 1] - bin_cdf[j]; guide[k] is the first bin reaching k / n_bins
+    int n_bins;
+    double bin_edges[SERVICE_MAX_BINS + 1];
+    double bin_cdf[SERVICE_MAX_BINS + 1];
+    int guide[SERVICE_MAX_BINS];
+    // Lognormal and hyperexponential: quantiles[i] at u = i / SERVICE_TABLE_SIZE,
+    // valid while table_kind and table_cv match kind and cv
+    service_kind table_kind;
+    double table_cv;
+    double quantiles[SERVICE_TABLE_SIZE];
+} service_dist;
+
+const char *service_kind_name(service_kind kind);
+// Kind named `name`; -1 when unknown
+int service_kind_from_name(const char *name);
+
+// Fits the empirical histogram to a whitespace-separated sample of holding
+// times. Returns 0 on success, -1 (with a message) on failure.
+int load_service_samples(const char *path, service_dist *d);
+
+// Builds the quantile table for the current kind and cv if it is stale.
+// False when the parameters are invalid (cv <= 0, or cv < 1 for hyperexponential).
+bool prepare_service_dist(service_dist *d);
+
+// Exact unit-mean quantile, solved on the CDF; used for the last table cell
+double service_dist_tail(const service_dist *d, double u);
+
+// True when draws differ from next_poisson(mean)
+static inline bool service_dist_is_general(const service_dist *d) {
+    return d != NULL && d->kind != SERVICE_EXPONENTIAL;
+}
+
+static inline double service_dist_draw(const service_dist *d, double mean) {
+    switch (d->kind) {
+    case SERVICE_DETERMINISTIC:
+        return mean;
+    case SERVICE_EMPIRICAL: {
+        double u = next_uniform();
+        int j = d->guide[(int)(u * d->n_bins)];
+        while (d->bin_cdf[j + 1] <= u) {
+            j++;
+        }
+        double frac = (u - d->bin_cdf[j]) / (d->bin_cdf[j + 1] - d->bin_cdf[j]);
+        return mean * (d->bin_edges[j] + frac * (d->bin_edges[j + 1] - d->bin_edges[j]));
+    }
+    case SERVICE_LOGNORMAL:
+    case SERVICE_HYPEREXPONENTIAL: {
+        double x = next_uniform() * SERVICE_TABLE_SIZE;
+        int i = (int)x;
+        if (i >= SERVICE_TABLE_SIZE - 1) {
+            return mean * service_dist_tail(d, x / SERVICE_TABLE_SIZE);
+        }
+        return mean * (d->quantiles[i] + (x - i) * (d->quantiles[i + 1] - d->quantiles[i]));
+    }
+    default:
+        return next_poisson(mean);
+    }
+}
+
+#endif // SERVICE_DIST_H
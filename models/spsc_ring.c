@@ -0,0 +1,25 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "spsc_ring.h"
+
+void init_spsc_ring(spsc_ring *ring, size_t capacity, int width) {
+    size_t rows = 1;
+    while (rows < capacity) {
+        rows <<= 1;
+    }
+    ring->capacity = rows;
+    ring->width = width;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->rows = malloc(rows * width * sizeof(double));
+    if (!ring->rows) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void free_spsc_ring(spsc_ring *ring) {
+    free(ring->rows);
+    ring->rows = NULL;
+    ring->capacity = 0;
+}
@@ -0,0 +1,70 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// Lock-free single-producer/single-consumer ring of fixed-width rows of doubles.
+// The producer only writes tail and the consumer only writes head; each is
+// published with release semantics and read with acquire semantics.
+
+#define SPSC_CACHE_LINE 64
+
+typedef struct {
+    double *rows;                 // capacity * width doubles
+    size_t capacity;              // Rows, power of two
+    int width;                    // Doubles per row
+    char pad0[SPSC_CACHE_LINE];
+    size_t head;                  // Next row to pop (consumer)
+    char pad1[SPSC_CACHE_LINE];
+    size_t tail;                  // Next row to push (producer)
+    char pad2[SPSC_CACHE_LINE];
+} spsc_ring;
+
+void init_spsc_ring(spsc_ring *ring, size_t capacity, int width);
+void free_spsc_ring(spsc_ring *ring);
+
+static inline bool spsc_ring_try_push(spsc_ring *ring, const double *row) {
+    size_t tail = ring->tail;
+    size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (tail - head == ring->capacity) {
+        return false;
+    }
+    memcpy(ring->rows + (tail & (ring->capacity - 1)) * ring->width, row, ring->width * sizeof(double));
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Pushes all n_rows rows (row-major) or none, publishing them at once
+static inline bool spsc_ring_try_push_rows(spsc_ring *ring, const double *rows, size_t n_rows) {
+    size_t tail = ring->tail;
+    size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (ring->capacity - (tail - head) < n_rows) {
+        return false;
+    }
+    for (size_t i = 0; i < n_rows; i++) {
+        memcpy(ring->rows + ((tail + i) & (ring->capacity - 1)) * ring->width, rows + i * ring->width,
+               ring->width * sizeof(double));
+    }
+    __atomic_store_n(&ring->tail, tail + n_rows, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Pops up to max_rows rows into out (row-major); returns how many were popped
+static inline size_t spsc_ring_pop(spsc_ring *ring, double *out, size_t max_rows) {
+    size_t head = ring->head;
+    size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    size_t n = tail - head;
+    if (n > max_rows) {
+        n = max_rows;
+    }
+    for (size_t i = 0; i < n; i++) {
+        memcpy(out + i * ring->width, ring->rows + ((head + i) & (ring->capacity - 1)) * ring->width,
+               ring->width * sizeof(double));
+    }
+    __atomic_store_n(&ring->head, head + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+#endif // SPSC_RING_H
@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "surrogate.h"
+
+#ifndef M_PI
+#    define M_PI 3.14159265358979323846
+#endif
+
+// Hyperparameter grids of the marginal-likelihood search (inputs span [0, 1])
+static const double length_scales[] = {0.015, 0.03, 0.06, 0.12, 0.25, 0.5, 1.0, 2.0};
+static const double noise_levels[] = {1e-6, 1e-4, 1e-3, 1e-2, 1e-1};
+#define TUNE_SWEEPS 2
+
+void init_gp_model(gp_model *gp, int dims) {
+    memset(gp, 0, sizeof(*gp));
+    gp->dims = dims;
+    for (int d = 0; d < dims; d++) {
+        gp->length_scale[d] = 0.25;
+    }
+    gp->noise = 1e-4;
+    gp->scale = 1.0;
+}
+
+void free_gp_model(gp_model *gp) {
+    free(gp->x);
+    free(gp->y);
+    free(gp->chol);
+    free(gp->alpha);
+    memset(gp, 0, sizeof(*gp));
+}
+
+void gp_add_point(gp_model *gp, const double *x, double y) {
+    if (gp->n == gp->capacity) {
+        int capacity = (gp->capacity > 0) ? 2 * gp->capacity : 64;
+        double *nx = realloc(gp->x, (size_t)capacity * gp->dims * sizeof(double));
+        double *ny = realloc(gp->y, (size_t)capacity * sizeof(double));
+        double *nc = realloc(gp->chol, (size_t)capacity * capacity * sizeof(double));
+        double *na = realloc(gp->alpha, (size_t)capacity * sizeof(double));
+        if (!nx || !ny || !nc || !na) {
+            perror("realloc failed");
+            exit(EXIT_FAILURE);
+        }
+        gp->x = nx;
+        gp->y = ny;
+        gp->chol = nc;
+        gp->alpha = na;
+        gp->capacity = capacity;
+        gp->fitted_n = 0;
+    }
+    memcpy(gp->x + (size_t)gp->n * gp->dims, x, gp->dims * sizeof(double));
+    gp->y[gp->n++] = y;
+}
+
+static double matern52(const double *a, const double *b, const double *length_scale, int dims) {
+    double r2 = 0.0;
+    for (int d = 0; d < dims; d++) {
+        double t = (a[d] - b[d]) / length_scale[d];
+        r2 += t * t;
+    }
+    double s = sqrt(5.0 * r2);
+    return (1.0 + s + 5.0 * r2 / 3.0) * exp(-s);
+}
+
+// Factorizes K + noise I for the given hyperparameters into gp->chol and
+// gp->alpha; returns the log marginal likelihood, -INFINITY if not positive definite
+static double factorize(gp_model *gp, const double *length_scale, double noise) {
+    int n = gp->n, dims = gp->dims;
+    double *L = gp->chol;
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j <= i; j++) {
+            double k = matern52(gp->x + (size_t)i * dims, gp->x + (size_t)j * dims, length_scale, dims);
+            L[(size_t)i * n + j] = (i == j) ? k + noise : k;
+        }
+    }
+    double log_det = 0.0;
+    for (int j = 0; j < n; j++) {
+        double *row_j = L + (size_t)j * n;
+        double diag = row_j[j];
+        for (int k = 0; k < j; k++) {
+            diag -= row_j[k] * row_j[k];
+        }
+        if (diag <= 0.0) {
+            return -INFINITY;
+        }
+        diag = sqrt(diag);
+        row_j[j] = diag;
+        log_det += log(diag);
+        for (int i = j + 1; i < n; i++) {
+            double *row_i = L + (size_t)i * n;
+            double v = row_i[j];
+            for (int k = 0; k < j; k++) {
+                v -= row_i[k] * row_j[k];
+            }
+            row_i[j] = v / diag;
+        }
+    }
+
+    // alpha = L^-T L^-1 y on the standardized outputs
+    double *alpha = gp->alpha;
+    for (int i = 0; i < n; i++) {
+        double v = (gp->y[i] - gp->mean) / gp->scale;
+        for (int k = 0; k < i; k++) {
+            v -= L[(size_t)i * n + k] * alpha[k];
+        }
+        alpha[i] = v / L[(size_t)i * n + i];
+    }
+    double fit = 0.0;
+    for (int i = 0; i < n; i++) {
+        fit += alpha[i] * alpha[i];
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        double v = alpha[i];
+        for (int k = i + 1; k < n; k++) {
+            v -= L[(size_t)k * n + i] * alpha[k];
+        }
+        alpha[i] = v / L[(size_t)i * n + i];
+    }
+    return -0.5 * fit - log_det - 0.5 * n * log(2.0 * M_PI);
+}
+
+// Coordinate search: each length scale, then the noise, over its grid in turn
+static void tune_hyperparameters(gp_model *gp) {
+    double best = factorize(gp, gp->length_scale, gp->noise);
+    for (int sweep = 0; sweep < TUNE_SWEEPS; sweep++) {
+        for (int d = 0; d <= gp->dims; d++) {
+            int n_values = (d < gp->dims) ? (int)(sizeof(length_scales) / sizeof(length_scales[0]))
+                                          : (int)(sizeof(noise_levels) / sizeof(noise_levels[0]));
+            for (int v = 0; v < n_values; v++) {
+                double length_scale[SURROGATE_MAX_DIMS];
+                memcpy(length_scale, gp->length_scale, sizeof(length_scale));
+                double noise = gp->noise;
+                if (d < gp->dims) {
+                    length_scale[d] = length_scales[v];
+                } else {
+                    noise = noise_levels[v];
+                }
+                double lml = factorize(gp, length_scale, noise);
+                if (lml > best) {
+                    best = lml;
+                    memcpy(gp->length_scale, length_scale, sizeof(length_scale));
+                    gp->noise = noise;
+                }
+            }
+        }
+    }
+}
+
+void gp_fit(gp_model *gp, bool tune) {
+    int n = gp->n;
+    gp->fitted_n = 0;
+    if (n == 0) {
+        return;
+    }
+
+    double mean = 0.0, var = 0.0;
+    for (int i = 0; i < n; i++) {
+        mean += gp->y[i];
+    }
+    mean /= n;
+    for (int i = 0; i < n; i++) {
+        var += (gp->y[i] - mean) * (gp->y[i] - mean);
+    }
+    var /= n;
+    gp->mean = mean;
+    gp->scale = (var > 1e-24) ? sqrt(var) : 1.0;
+
+    if (tune) {
+        tune_hyperparameters(gp);
+    }
+    // Duplicated inputs make K singular without enough noise
+    while (factorize(gp, gp->length_scale, gp->noise) == -INFINITY) {
+        gp->noise *= 10.0;
+    }
+    gp->fitted_n = n;
+}
+
+void gp_predict(const gp_model *gp, const double *x, double *mean, double *sd, double *work) {
+    int n = gp->fitted_n, dims = gp->dims;
+    if (n == 0) {
+        *mean = gp->mean;
+        *sd = gp->scale;
+        return;
+    }
+
+    const double *L = gp->chol;
+    double m = 0.0;
+    for (int i = 0; i < n; i++) {
+        work[i] = matern52(x, gp->x + (size_t)i * dims, gp->length_scale, dims);
+        m += work[i] * gp->alpha[i];
+    }
+    // Forward substitution in place: work = L^-1 k
+    double explained = 0.0;
+    for (int i = 0; i < n; i++) {
+        double v = work[i];
+        for (int k = 0; k < i; k++) {
+            v -= L[(size_t)i * n + k] * work[k];
+        }
+        work[i] = v / L[(size_t)i * n + i];
+        explained += work[i] * work[i];
+    }
+    double var = 1.0 - explained;
+    *mean = gp->mean + gp->scale * m;
+    *sd = gp->scale * sqrt((var > 1e-12) ? var : 1e-12);
+}
+
+double expected_improvement(double best, double mean, double sd) {
+    double gain = best - mean;
+    if (sd <= 0.0) {
+        return (gain > 0.0) ? gain : 0.0;
+    }
+    double z = gain / sd;
+    return gain * 0.5 * erfc(-z / sqrt(2.0)) + sd * exp(-0.5 * z * z) / sqrt(2.0 * M_PI);
+}
+
+double probability_below(double bound, double mean, double sd) {
+    if (sd <= 0.0) {
+        return (mean <= bound) ? 1.0 : 0.0;
+    }
+    return 0.5 * erfc(-(bound - mean) / (sd * sqrt(2.0)));
+}
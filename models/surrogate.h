@@ -0,0 +1,49 @@
+#ifndef SURROGATE_H
+#define SURROGATE_H
+
+#include <stdbool.h>
+
+// Gaussian-process response surface for expensive simulations, as used by
+// surrogate-guided search. Inputs are points of [0, 1]^dims and outputs are
+// standardized before fitting. The kernel is Matern 5/2 with one length scale
+// per dimension plus a noise term. Length scales and noise are chosen by
+// maximum marginal likelihood, a coordinate search over a fixed grid.
+// Fitting is one O(n^3) Cholesky factorization, and a prediction costs
+// O(n^2), so a model of a few hundred points refits in milliseconds.
+
+#define SURROGATE_MAX_DIMS 8
+
+typedef struct {
+    int dims;
+    int n;
+    int capacity;
+    double *x;                                  // n x dims inputs, row-major
+    double *y;                                  // n outputs
+    double length_scale[SURROGATE_MAX_DIMS];
+    double noise;                               // Noise variance, relative to the output variance
+    // Fit: outputs standardized as (y - mean) / scale, chol the lower Cholesky
+    // factor of K + noise I and alpha = (K + noise I)^-1 times the outputs
+    double mean;
+    double scale;
+    double *chol;
+    double *alpha;
+    int fitted_n;                               // Points the factorization covers
+} gp_model;
+
+void init_gp_model(gp_model *gp, int dims);
+void free_gp_model(gp_model *gp);
+void gp_add_point(gp_model *gp, const double *x, double y);
+
+// Factorizes the current points, after first tuning the hyperparameters if
+// `tune` is set (a few dozen factorizations)
+void gp_fit(gp_model *gp, bool tune);
+
+// Posterior mean and standard deviation at x; work holds at least n doubles
+void gp_predict(const gp_model *gp, const double *x, double *mean, double *sd, double *work);
+
+// Expected amount by which a value ~ N(mean, sd^2) falls below best
+double expected_improvement(double best, double mean, double sd);
+// P(value <= bound) for a value ~ N(mean, sd^2)
+double probability_below(double bound, double mean, double sd);
+
+#endif // SURROGATE_H
@@ -0,0 +1,324 @@
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "sweep.h"
+
+#define SWEEP_MAGIC "TSSWEEP2"
+
+// Item state: owner pid << 3 | phase, changed with compare-and-swap only
+enum { SLOT_PENDING = 0, SLOT_CLAIMED, SLOT_WRITING, SLOT_DONE, SLOT_FAILED };
+#define SLOT_PHASE(s) ((unsigned)((s) & 7u))
+#define SLOT_OWNER(s) ((pid_t)((s) >> 3))
+#define SLOT_STATE(pid, phase) (((uint64_t)(pid) << 3) | (phase))
+
+// File layout: header, one slot per item, then one row per item
+typedef struct {
+    char magic[8];
+    uint64_t key;
+    uint64_t base_seed;     // Given when the file was created, kept on resume
+    uint32_t n_items;
+    uint32_t row_size;
+    uint32_t cursor;        // Next item never handed out
+    uint32_t settled;       // Items done or failed
+} sweep_header;
+
+typedef struct {
+    uint64_t state;
+    uint64_t seed;
+    uint32_t scenario;
+    uint32_t attempts;      // Workers that crashed holding the item (coordinator only)
+    uint32_t backups;       // Set once a second worker runs the item
+    uint32_t reserved;
+} sweep_slot;
+
+struct sweep_table {
+    int fd;
+    size_t size;
+    size_t row_stride;
+    int resumed;
+    sweep_header *header;
+    sweep_slot *slots;
+    unsigned char *rows;
+};
+
+sweep_table *sweep_table_open(const char *path, const sweep_item *items, uint32_t n_items,
+                              uint32_t row_size, uint64_t key, uint64_t base_seed) {
+    size_t row_stride = (row_size + 7u) & ~(size_t)7u;
+    size_t size = sizeof(sweep_header) + n_items * (sizeof(sweep_slot) + row_stride);
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    // Resume only a file written for exactly this sweep
+    struct stat st;
+    sweep_header existing;
+    bool resume = fstat(fd, &st) == 0 && (size_t)st.st_size == size &&
+                  pread(fd, &existing, sizeof(existing), 0) == (ssize_t)sizeof(existing) &&
+                  memcmp(existing.magic, SWEEP_MAGIC, sizeof(existing.magic)) == 0 &&
+                  existing.key == key && existing.n_items == n_items && existing.row_size == row_size;
+    if (!resume && (ftruncate(fd, 0) != 0 || ftruncate(fd, (off_t)size) != 0)) {
+        close(fd);
+        return NULL;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+
+    sweep_table *table = malloc(sizeof(sweep_table));
+    if (!table) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    table->fd = fd;
+    table->size = size;
+    table->row_stride = row_stride;
+    table->header = map;
+    table->slots = (sweep_slot *)(table->header + 1);
+    table->rows = (unsigned char *)(table->slots + n_items);
+
+    sweep_header *h = table->header;
+    if (!resume) {
+        memcpy(h->magic, SWEEP_MAGIC, sizeof(h->magic));
+        h->key = key;
+        h->base_seed = base_seed;
+        h->n_items = n_items;
+        h->row_size = row_size;
+        for (uint32_t i = 0; i < n_items; i++) {
+            table->slots[i].seed = items[i].seed;
+            table->slots[i].scenario = items[i].scenario;
+        }
+    }
+
+    // Whoever held an unfinished item is gone; failed items get another chance
+    h->settled = 0;
+    for (uint32_t i = 0; i < n_items; i++) {
+        sweep_slot *s = &table->slots[i];
+        if (SLOT_PHASE(s->state) == SLOT_DONE) {
+            h->settled++;
+        } else {
+            s->state = SLOT_PENDING;
+            s->attempts = 0;
+        }
+        s->backups = 0;
+    }
+    h->cursor = 0;
+    table->resumed = (int)h->settled;
+    return table;
+}
+
+uint64_t sweep_table_base_seed(const sweep_table *table) {
+    return table->header->base_seed;
+}
+
+void sweep_table_close(sweep_table *table) {
+    msync(table->header, table->size, MS_SYNC);
+    munmap(table->header, table->size);
+    close(table->fd);
+    free(table);
+}
+
+const void *sweep_table_row(const sweep_table *table, uint32_t index) {
+    uint64_t state = __atomic_load_n(&table->slots[index].state, __ATOMIC_ACQUIRE);
+    return (SLOT_PHASE(state) == SLOT_DONE) ? table->rows + index * table->row_stride : NULL;
+}
+
+// ------------------- WORKER SIDE ------------------- //
+
+static void fill_item(const sweep_table *table, uint32_t i, sweep_item *item) {
+    item->index = i;
+    item->scenario = table->slots[i].scenario;
+    item->seed = table->slots[i].seed;
+}
+
+static bool claim_slot(sweep_table *table, uint32_t i, pid_t self) {
+    uint64_t expected = SLOT_PENDING;
+    return __atomic_compare_exchange_n(&table->slots[i].state, &expected, SLOT_STATE(self, SLOT_CLAIMED),
+                                       false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+static bool table_claim(void *ctx, sweep_item *item) {
+    sweep_table *table = ctx;
+    uint32_t n = table->header->n_items;
+    pid_t self = getpid();
+
+    // Items in order, then any handed back after a crash
+    uint32_t i;
+    while ((i = __atomic_fetch_add(&table->header->cursor, 1, __ATOMIC_RELAXED)) < n) {
+        if (claim_slot(table, i, self)) {
+            fill_item(table, i, item);
+            return true;
+        }
+    }
+    for (i = 0; i < n; i++) {
+        if (claim_slot(table, i, self)) {
+            fill_item(table, i, item);
+            return true;
+        }
+    }
+
+    // Nothing left to claim: back up an item another worker is still running
+    for (i = 0; i < n; i++) {
+        uint64_t state = __atomic_load_n(&table->slots[i].state, __ATOMIC_ACQUIRE);
+        uint32_t expected = 0;
+        if (SLOT_PHASE(state) == SLOT_CLAIMED && SLOT_OWNER(state) != self &&
+            __atomic_compare_exchange_n(&table->slots[i].backups, &expected, 1, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            fill_item(table, i, item);
+            return true;
+        }
+    }
+    return false;
+}
+
+// The first copy of an item to get here writes the row; later copies are dropped
+static void table_complete(void *ctx, const sweep_item *item, const void *row) {
+    sweep_table *table = ctx;
+    sweep_slot *slot = &table->slots[item->index];
+    pid_t self = getpid();
+
+    uint64_t state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+    do {
+        if (SLOT_PHASE(state) >= SLOT_WRITING) {
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&slot->state, &state, SLOT_STATE(self, SLOT_WRITING),
+                                          false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    memcpy(table->rows + item->index * table->row_stride, row, table->header->row_size);
+    __atomic_store_n(&slot->state, SLOT_STATE(self, SLOT_DONE), __ATOMIC_RELEASE);
+    __atomic_fetch_add(&table->header->settled, 1, __ATOMIC_ACQ_REL);
+}
+
+// ------------------- COORDINATOR SIDE ------------------- //
+
+static pid_t spawn_worker(sweep_table *table, sweep_worker_fn fn, void *arg) {
+    // Buffered output would otherwise be written once more by every child
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork failed");
+        return -1;
+    }
+    if (pid == 0) {
+        sweep_transport transport = {table, table_claim, table_complete};
+        fn(&transport, arg);
+        _exit(0);
+    }
+    return pid;
+}
+
+// Hands the unfinished items of `owner` (every owner when 0) out again, or gives
+// an item up once it has been held by SWEEP_MAX_ATTEMPTS crashed workers
+static void release_items(sweep_table *table, pid_t owner, bool crashed, sweep_report *report) {
+    for (uint32_t i = 0; i < table->header->n_items; i++) {
+        sweep_slot *slot = &table->slots[i];
+        uint64_t state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+        unsigned phase = SLOT_PHASE(state);
+        if ((phase != SLOT_CLAIMED && phase != SLOT_WRITING) || (owner != 0 && SLOT_OWNER(state) != owner)) {
+            continue;
+        }
+
+        bool give_up = crashed && ++slot->attempts >= SWEEP_MAX_ATTEMPTS;
+        uint64_t next = give_up ? SLOT_FAILED : SLOT_PENDING;
+        // A backup copy may have published the row in the meantime
+        if (__atomic_compare_exchange_n(&slot->state, &state, next, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            if (give_up) {
+                __atomic_fetch_add(&table->header->settled, 1, __ATOMIC_ACQ_REL);
+                report->failed++;
+            } else {
+                __atomic_store_n(&slot->backups, 0, __ATOMIC_RELEASE);
+            }
+        }
+    }
+}
+
+int sweep_run(sweep_table *table, int n_workers, sweep_worker_fn fn, void *arg, sweep_report *report) {
+    memset(report, 0, sizeof(*report));
+    report->resumed = table->resumed;
+
+    uint32_t n = table->header->n_items;
+    pid_t *workers = calloc(n_workers, sizeof(pid_t));
+    if (!workers) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    int live = 0;
+    for (int w = 0; w < n_workers && __atomic_load_n(&table->header->settled, __ATOMIC_ACQUIRE) < n; w++) {
+        workers[w] = spawn_worker(table, fn, arg);
+        live += workers[w] > 0;
+    }
+
+    bool finished = false;
+    while (live > 0) {
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("waitpid failed");
+            break;
+        }
+        int w = 0;
+        while (w < n_workers && workers[w] != pid) {
+            w++;
+        }
+        if (w == n_workers) {
+            continue;
+        }
+        workers[w] = 0;
+        live--;
+
+        bool crashed = !finished && !(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        if (crashed) {
+            report->crashes++;
+            if (WIFSIGNALED(status)) {
+                fprintf(stderr, "Worker %d killed by signal %d; handing its items out again\n",
+                        (int)pid, WTERMSIG(status));
+            } else {
+                fprintf(stderr, "Worker %d exited with status %d; handing its items out again\n",
+                        (int)pid, WEXITSTATUS(status));
+            }
+            release_items(table, pid, true, report);
+        }
+
+        if (__atomic_load_n(&table->header->settled, __ATOMIC_ACQUIRE) >= n) {
+            // Whoever is left only runs copies of finished items
+            if (!finished) {
+                finished = true;
+                for (int k = 0; k < n_workers; k++) {
+                    if (workers[k] > 0) {
+                        kill(workers[k], SIGKILL);
+                    }
+                }
+            }
+        } else if (crashed || live == 0) {
+            if (live == 0) {
+                release_items(table, 0, false, report);
+            }
+            workers[w] = spawn_worker(table, fn, arg);
+            live += workers[w] > 0;
+        }
+    }
+    free(workers);
+
+    for (uint32_t i = 0; i < n; i++) {
+        report->backups += (int)table->slots[i].backups;
+    }
+    msync(table->header, table->size, MS_SYNC);
+    return (__atomic_load_n(&table->header->settled, __ATOMIC_ACQUIRE) >= n) ? 0 : -1;
+}
@@ -0,0 +1,63 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Multi-process sweep: a coordinator forks worker processes that claim work
+// items and publish one fixed-size result row per item. Items and rows live in
+// a memory-mapped file, so rows published by a worker survive it crashing (and
+// the coordinator too: rerunning an identical sweep resumes from the file).
+//
+// A crashed worker's items are handed out again and the worker is replaced;
+// an item that keeps crashing workers is given up after SWEEP_MAX_ATTEMPTS.
+// Once no unclaimed item is left, an idle worker runs a backup copy of an item
+// still in progress, so one slow worker does not hold up the end of a sweep;
+// whichever copy finishes first publishes its row.
+
+#define SWEEP_MAX_ATTEMPTS 3
+
+// Self-contained description of one unit of work
+typedef struct {
+    uint32_t index;     // Row of the result table
+    uint32_t scenario;
+    uint64_t seed;
+} sweep_item;
+
+// How a worker gets items and returns rows. Workers only see this interface,
+// so a network client could stand in for the shared-memory table.
+typedef struct {
+    void *ctx;
+    bool (*claim)(void *ctx, sweep_item *item);     // false when no work is left
+    void (*complete)(void *ctx, const sweep_item *item, const void *row);
+} sweep_transport;
+
+typedef void (*sweep_worker_fn)(sweep_transport *transport, void *arg);
+
+typedef struct {
+    int resumed;        // Items already done in the file when the sweep started
+    int crashes;        // Workers that died before finishing
+    int backups;        // Items also run by a second worker
+    int failed;         // Items given up after SWEEP_MAX_ATTEMPTS crashes
+} sweep_report;
+
+typedef struct sweep_table sweep_table;
+
+// Opens the table at `path` for these items, resuming it when the file holds the
+// same sweep (same key, item count and row size) and starting over otherwise.
+// A resumed table keeps the item seeds and base_seed of the run that created it.
+sweep_table *sweep_table_open(const char *path, const sweep_item *items, uint32_t n_items,
+                              uint32_t row_size, uint64_t key, uint64_t base_seed);
+void sweep_table_close(sweep_table *table);
+
+// base_seed given when the table file was created
+uint64_t sweep_table_base_seed(const sweep_table *table);
+
+// Row of a finished item, or NULL if the item failed
+const void *sweep_table_row(const sweep_table *table, uint32_t index);
+
+// Runs every unfinished item on n_workers forked processes, each calling fn
+// until the transport runs dry. Returns 0 once every item is done or failed.
+int sweep_run(sweep_table *table, int n_workers, sweep_worker_fn fn, void *arg, sweep_report *report);
+
+#endif // SWEEP_H
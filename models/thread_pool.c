@@ -0,0 +1,138 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "thread_pool.h"
+
+typedef struct pool_task {
+    thread_pool_task fn;
+    void *arg;
+    struct pool_task *next;
+} pool_task;
+
+struct thread_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t has_work;
+    pthread_cond_t all_done;
+    pool_task *head;
+    pool_task *tail;
+    int pending;       // Submitted tasks not yet finished
+    bool shutting_down;
+    int n_threads;
+    pthread_t *threads;
+};
+
+static void *worker_main(void *arg) {
+    thread_pool *pool = arg;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->head == NULL && !pool->shutting_down) {
+            pthread_cond_wait(&pool->has_work, &pool->lock);
+        }
+        if (pool->head == NULL) {
+            break;
+        }
+
+        pool_task *task = pool->head;
+        pool->head = task->next;
+        if (pool->head == NULL) {
+            pool->tail = NULL;
+        }
+        pthread_mutex_unlock(&pool->lock);
+
+        task->fn(task->arg);
+        free(task);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            pthread_cond_broadcast(&pool->all_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+int default_thread_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+}
+
+thread_pool *thread_pool_create(int n_threads) {
+    thread_pool *pool = calloc(1, sizeof(thread_pool));
+    if (!pool) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    pool->n_threads = (n_threads > 0) ? n_threads : default_thread_count();
+    pool->threads = malloc(pool->n_threads * sizeof(pthread_t));
+    if (!pool->threads) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->has_work, NULL);
+    pthread_cond_init(&pool->all_done, NULL);
+
+    for (int i = 0; i < pool->n_threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, worker_main, pool) != 0) {
+            perror("pthread_create failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return pool;
+}
+
+void thread_pool_submit(thread_pool *pool, thread_pool_task fn, void *arg) {
+    pool_task *task = malloc(sizeof(pool_task));
+    if (!task) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    task->fn = fn;
+    task->arg = arg;
+    task->next = NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->tail == NULL) {
+        pool->head = task;
+    } else {
+        pool->tail->next = task;
+    }
+    pool->tail = task;
+    pool->pending++;
+    pthread_cond_signal(&pool->has_work);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Blocks until every submitted task has finished
+void thread_pool_wait(thread_pool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->all_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_destroy(thread_pool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->shutting_down = true;
+    pthread_cond_broadcast(&pool->has_work);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->n_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->has_work);
+    pthread_cond_destroy(&pool->all_done);
+    free(pool->threads);
+    free(pool);
+}
@@ -0,0 +1,14 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+typedef void (*thread_pool_task)(void *arg);
+
+typedef struct thread_pool thread_pool;
+
+int default_thread_count(void);
+thread_pool *thread_pool_create(int n_threads);
+void thread_pool_submit(thread_pool *pool, thread_pool_task fn, void *arg);
+void thread_pool_wait(thread_pool *pool);
+void thread_pool_destroy(thread_pool *pool);
+
+#endif // THREAD_POOL_H
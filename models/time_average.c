@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "time_average.h"
+#include "profiling.h"
+
+void init_time_average(time_average *ta, int initial_levels) {
+    ta->start_time = 0.0;
+    ta->last_time = 0.0;
+    ta->area = 0.0;
+    ta->size = 0;
+    ta->capacity = (initial_levels > 0) ? initial_levels : 1;
+    ta->time_at = calloc(ta->capacity, sizeof(double));
+    PROF_ALLOC();
+    if (!ta->time_at) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void grow_time_average(time_average *ta, int level) {
+    int capacity = ta->capacity;
+    while (capacity <= level) {
+        capacity *= 2;
+    }
+
+    double *tmp = realloc(ta->time_at, capacity * sizeof(double));
+    PROF_ALLOC();
+    if (!tmp) {
+        perror("realloc failed");
+        exit(EXIT_FAILURE);
+    }
+    memset(tmp + ta->capacity, 0, (capacity - ta->capacity) * sizeof(double));
+
+    ta->time_at = tmp;
+    ta->capacity = capacity;
+}
+
+// Returns a newly allocated array with the fraction of time spent at each level
+double *time_average_distribution(const time_average *ta, int *size) {
+    int n = (ta->size > 0) ? ta->size : 1;
+    double *dist = calloc(n, sizeof(double));
+    if (!dist) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    double span = ta->last_time - ta->start_time;
+    if (span > 0.0) {
+        for (int i = 0; i < ta->size; i++) {
+            dist[i] = ta->time_at[i] / span;
+        }
+    }
+
+    *size = n;
+    return dist;
+}
+
+// Restarts the averages at the last advanced time (e.g. after a warm-up period)
+void time_average_reset(time_average *ta) {
+    ta->start_time = ta->last_time;
+    ta->area = 0.0;
+    ta->size = 0;
+    memset(ta->time_at, 0, ta->capacity * sizeof(double));
+}
+
+void free_time_average(time_average *ta) {
+    free(ta->time_at);
+    ta->time_at = NULL;
+    ta->size = ta->capacity = 0;
+}
@@ -0,0 +1,43 @@
+#ifndef TIME_AVERAGE_H
+#define TIME_AVERAGE_H
+
+// Time-weighted statistics of an integer level (busy operators, queue length).
+// Call time_average_advance() before the level changes (or at every event);
+// it charges the elapsed time to the level held since the previous call.
+
+typedef struct {
+    double start_time;  // Origin of the averages (0 unless reset)
+    double last_time;
+    double area;        // Integral of the level over time
+    double *time_at;    // time_at[k]: total time spent at level k
+    int size;           // Highest level seen + 1
+    int capacity;
+} time_average;
+
+void init_time_average(time_average *ta, int initial_levels);
+void grow_time_average(time_average *ta, int level);
+double *time_average_distribution(const time_average *ta, int *size);
+void time_average_reset(time_average *ta);
+void free_time_average(time_average *ta);
+
+static inline void time_average_advance(time_average *ta, double now, int level) {
+    double dt = now - ta->last_time;
+
+    if (level >= ta->capacity) {
+        grow_time_average(ta, level);
+    }
+    if (level >= ta->size) {
+        ta->size = level + 1;
+    }
+
+    ta->area += level * dt;
+    ta->time_at[level] += dt;
+    ta->last_time = now;
+}
+
+static inline double time_average_mean(const time_average *ta) {
+    double span = ta->last_time - ta->start_time;
+    return (span > 0.0) ? ta->area / span : 0.0;
+}
+
+#endif // TIME_AVERAGE_H
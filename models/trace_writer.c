@@ -0,0 +1,150 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "trace_writer.h"
+#include "spsc_ring.h"
+
+// Writer thread poll interval when the ring is empty
+#define TRACE_IDLE_NS 100000
+
+struct trace_writer {
+    spsc_ring ring;
+    FILE *file;
+    int n_columns;
+    double *chunk;          // Column-major, n_columns x TRACE_CHUNK_ROWS
+    double *batch;          // Row-major rows popped from the ring
+    size_t chunk_fill;
+    uint64_t n_rows;
+    int closing;            // Set by the producer, read by the writer thread
+    bool failed;
+    pthread_t thread;
+};
+
+static void write_chunk(trace_writer *w) {
+    if (w->chunk_fill == 0) {
+        return;
+    }
+    // Each column's filled prefix, so a partial last chunk is stored densely
+    for (int c = 0; c < w->n_columns && !w->failed; c++) {
+        if (fwrite(w->chunk + (size_t)c * TRACE_CHUNK_ROWS, sizeof(double), w->chunk_fill, w->file) != w->chunk_fill) {
+            w->failed = true;
+        }
+    }
+    w->n_rows += w->chunk_fill;
+    w->chunk_fill = 0;
+}
+
+static void drain_batch(trace_writer *w, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        for (int c = 0; c < w->n_columns; c++) {
+            w->chunk[(size_t)c * TRACE_CHUNK_ROWS + w->chunk_fill] = w->batch[i * w->n_columns + c];
+        }
+        if (++w->chunk_fill == TRACE_CHUNK_ROWS) {
+            write_chunk(w);
+        }
+    }
+}
+
+static void *writer_thread(void *arg) {
+    trace_writer *w = arg;
+    const struct timespec idle = {0, TRACE_IDLE_NS};
+
+    for (;;) {
+        // Read the flag before draining so rows pushed before close are never missed
+        int closing = __atomic_load_n(&w->closing, __ATOMIC_ACQUIRE);
+        size_t n = spsc_ring_pop(&w->ring, w->batch, TRACE_CHUNK_ROWS);
+        if (n > 0) {
+            drain_batch(w, n);
+        } else if (closing) {
+            break;
+        } else {
+            nanosleep(&idle, NULL);
+        }
+    }
+    write_chunk(w);
+    return NULL;
+}
+
+trace_writer *trace_writer_open(const char *path, const char *const *column_names, int n_columns) {
+    if (n_columns <= 0 || n_columns > TRACE_MAX_COLUMNS) {
+        fprintf(stderr, "Error: a trace has 1 to %d columns\n", TRACE_MAX_COLUMNS);
+        return NULL;
+    }
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    trace_writer *w = calloc(1, sizeof(trace_writer));
+    if (!w) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    w->file = file;
+    w->n_columns = n_columns;
+    w->chunk = malloc((size_t)n_columns * TRACE_CHUNK_ROWS * sizeof(double));
+    w->batch = malloc((size_t)n_columns * TRACE_CHUNK_ROWS * sizeof(double));
+    if (!w->chunk || !w->batch) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    init_spsc_ring(&w->ring, TRACE_RING_ROWS, n_columns);
+
+    // The row count is rewritten on close
+    trace_file_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.n_columns = (uint32_t)n_columns;
+    header.chunk_rows = TRACE_CHUNK_ROWS;
+    w->failed = fwrite(&header, sizeof(header), 1, file) != 1;
+    for (int c = 0; c < n_columns; c++) {
+        trace_file_column column;
+        memset(&column, 0, sizeof(column));
+        strncpy(column.name, column_names[c], TRACE_COLUMN_NAME_LEN - 1);
+        column.type = TRACE_TYPE_FLOAT64;
+        column.width = sizeof(double);
+        if (fwrite(&column, sizeof(column), 1, file) != 1) {
+            w->failed = true;
+        }
+    }
+
+    if (pthread_create(&w->thread, NULL, writer_thread, w) != 0) {
+        perror("pthread_create failed");
+        exit(EXIT_FAILURE);
+    }
+    return w;
+}
+
+void trace_writer_push(trace_writer *writer, const double *row) {
+    while (!spsc_ring_try_push(&writer->ring, row)) {
+        sched_yield();
+    }
+}
+
+long trace_writer_close(trace_writer *writer) {
+    __atomic_store_n(&writer->closing, 1, __ATOMIC_RELEASE);
+    pthread_join(writer->thread, NULL);
+
+    bool failed = writer->failed;
+    if (!failed) {
+        uint64_t n_rows = writer->n_rows;
+        failed = fseek(writer->file, offsetof(trace_file_header, n_rows), SEEK_SET) != 0 ||
+                 fwrite(&n_rows, sizeof(n_rows), 1, writer->file) != 1;
+    }
+    if (fclose(writer->file) != 0) {
+        failed = true;
+    }
+    long n_rows = (long)writer->n_rows;
+
+    free_spsc_ring(&writer->ring);
+    free(writer->chunk);
+    free(writer->batch);
+    free(writer);
+    return failed ? -1 : n_rows;
+}
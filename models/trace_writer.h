@@ -0,0 +1,45 @@
+#ifndef TRACE_WRITER_H
+#define TRACE_WRITER_H
+
+// Columnar binary trace written by a background thread. The producer pushes
+// rows into a lock-free SPSC ring and never touches the file.
+//
+// File layout (host byte order, little-endian on every supported target):
+//   trace_file_header
+//   n_columns x trace_file_column
+//   chunks of chunk_rows rows, each stored column by column; the last chunk
+//   holds the remaining n_rows % chunk_rows rows, also column by column.
+// scripts/trace_loader.py maps it with numpy.memmap.
+
+#include <stdint.h>
+
+#define TRACE_MAGIC "TSTRACE1"
+#define TRACE_MAX_COLUMNS 8
+#define TRACE_COLUMN_NAME_LEN 24
+#define TRACE_TYPE_FLOAT64 1
+#define TRACE_CHUNK_ROWS 65536
+#define TRACE_RING_ROWS (1 << 16)
+
+typedef struct {
+    char magic[8];
+    uint32_t n_columns;
+    uint32_t chunk_rows;
+    uint64_t n_rows;            // Filled in when the writer is closed
+} trace_file_header;
+
+typedef struct {
+    char name[TRACE_COLUMN_NAME_LEN];
+    uint32_t type;
+    uint32_t width;             // Bytes per value
+} trace_file_column;
+
+typedef struct trace_writer trace_writer;
+
+// NULL if the file cannot be created
+trace_writer *trace_writer_open(const char *path, const char *const *column_names, int n_columns);
+// Appends one row of n_columns values; only waits if the writer falls a full ring behind
+void trace_writer_push(trace_writer *writer, const double *row);
+// Drains the ring, finalizes the header and frees the writer. Returns the rows written, or -1 on an I/O error.
+long trace_writer_close(trace_writer *writer);
+
+#endif // TRACE_WRITER_H
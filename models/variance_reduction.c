@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "variance_reduction.h"
+
+double vr_sample_variance(const double *y, int n) {
+    if (n < 2) {
+        return 0.0;
+    }
+    double mean = 0.0;
+    for (int i = 0; i < n; i++) {
+        mean += y[i];
+    }
+    mean /= n;
+
+    double ss = 0.0;
+    for (int i = 0; i < n; i++) {
+        ss += (y[i] - mean) * (y[i] - mean);
+    }
+    return ss / (n - 1);
+}
+
+// Solves the k x k system a * beta = b in place (Gaussian elimination, partial pivoting).
+// Returns 0 when a control is (numerically) constant or collinear with the others.
+static int solve_small_system(double a[VR_MAX_CONTROLS][VR_MAX_CONTROLS], double *b, int k) {
+    for (int col = 0; col < k; col++) {
+        int pivot = col;
+        for (int r = col + 1; r < k; r++) {
+            if (fabs(a[r][col]) > fabs(a[pivot][col])) {
+                pivot = r;
+            }
+        }
+        if (fabs(a[pivot][col]) < 1e-300) {
+            return 0;
+        }
+        for (int c = 0; c < k; c++) {
+            double t = a[col][c];
+            a[col][c] = a[pivot][c];
+            a[pivot][c] = t;
+        }
+        double t = b[col];
+        b[col] = b[pivot];
+        b[pivot] = t;
+
+        for (int r = col + 1; r < k; r++) {
+            double f = a[r][col] / a[col][col];
+            for (int c = col; c < k; c++) {
+                a[r][c] -= f * a[col][c];
+            }
+            b[r] -= f * b[col];
+        }
+    }
+    for (int r = k - 1; r >= 0; r--) {
+        for (int c = r + 1; c < k; c++) {
+            b[r] -= a[r][c] * b[c];
+        }
+        b[r] /= a[r][r];
+    }
+    return 1;
+}
+
+// Regression-adjusted mean: y - beta' (x - x_mean), with beta the least-squares
+// coefficients of y on x. The residual variance uses n - k - 1 degrees of freedom.
+vr_estimate vr_control_variates(const double *y, const double *x, int n, int k, const double *x_mean) {
+    vr_estimate est;
+    double y_bar = 0.0, x_bar[VR_MAX_CONTROLS] = {0.0};
+
+    if (k > VR_MAX_CONTROLS) {
+        k = VR_MAX_CONTROLS;
+    }
+    for (int i = 0; i < n; i++) {
+        y_bar += y[i];
+        for (int j = 0; j < k; j++) {
+            x_bar[j] += x[i * k + j];
+        }
+    }
+    y_bar /= n;
+    for (int j = 0; j < k; j++) {
+        x_bar[j] /= n;
+    }
+
+    double plain_var = vr_sample_variance(y, n) / n;
+    est.mean = y_bar;
+    est.plain_std_error = sqrt(plain_var);
+    est.std_error = est.plain_std_error;
+    est.reduction_factor = 1.0;
+
+    if (k == 0 || n <= k + 1) {
+        return est;
+    }
+
+    double sxx[VR_MAX_CONTROLS][VR_MAX_CONTROLS] = {{0.0}};
+    double beta[VR_MAX_CONTROLS] = {0.0};
+    for (int i = 0; i < n; i++) {
+        for (int a = 0; a < k; a++) {
+            double da = x[i * k + a] - x_bar[a];
+            beta[a] += da * (y[i] - y_bar);
+            for (int b = 0; b < k; b++) {
+                sxx[a][b] += da * (x[i * k + b] - x_bar[b]);
+            }
+        }
+    }
+    if (!solve_small_system(sxx, beta, k)) {
+        return est;
+    }
+
+    double ss = 0.0;
+    for (int i = 0; i < n; i++) {
+        double fit = y[i] - y_bar;
+        for (int j = 0; j < k; j++) {
+            fit -= beta[j] * (x[i * k + j] - x_bar[j]);
+        }
+        ss += fit * fit;
+    }
+    double cv_var = ss / (n - k - 1) / n;
+
+    est.mean = y_bar;
+    for (int j = 0; j < k; j++) {
+        est.mean -= beta[j] * (x_bar[j] - x_mean[j]);
+    }
+    est.std_error = sqrt(cv_var);
+    est.reduction_factor = (cv_var > 0.0) ? plain_var / cv_var : 1.0;
+    return est;
+}
+
+vr_estimate vr_antithetic(const double *y, const double *y_anti, const double *x, const double *x_anti,
+                          int n, int k, const double *x_mean) {
+    double *pair_y = malloc(n * sizeof(double));
+    double *pair_x = malloc((size_t)n * (k > 0 ? k : 1) * sizeof(double));
+    double *runs = malloc(2 * n * sizeof(double));
+    if (!pair_y || !pair_x || !runs) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < n; i++) {
+        pair_y[i] = 0.5 * (y[i] + y_anti[i]);
+        for (int j = 0; j < k; j++) {
+            pair_x[i * k + j] = 0.5 * (x[i * k + j] + x_anti[i * k + j]);
+        }
+        runs[2 * i] = y[i];
+        runs[2 * i + 1] = y_anti[i];
+    }
+
+    vr_estimate est = vr_control_variates(pair_y, pair_x, n, k, x_mean);
+
+    // Baseline: 2n independent runs, whose variance the individual outputs estimate
+    double plain_var = vr_sample_variance(runs, 2 * n) / (2 * n);
+    double var = est.std_error * est.std_error;
+    est.plain_std_error = sqrt(plain_var);
+    est.reduction_factor = (var > 0.0) ? plain_var / var : 1.0;
+
+    free(pair_y);
+    free(pair_x);
+    free(runs);
+    return est;
+}
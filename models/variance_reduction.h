@@ -0,0 +1,26 @@
+#ifndef VARIANCE_REDUCTION_H
+#define VARIANCE_REDUCTION_H
+
+// Estimators over independent replications (or antithetic pairs) with optional
+// control variates. reduction_factor compares the variance of the plain mean
+// of the same number of simulation runs with that of the reduced estimator.
+
+#define VR_MAX_CONTROLS 4
+
+typedef struct {
+    double mean;
+    double std_error;
+    double plain_std_error;     // Standard error of the plain mean over the same runs
+    double reduction_factor;    // plain variance / reduced variance
+} vr_estimate;
+
+double vr_sample_variance(const double *y, int n);
+
+// y[i] with controls x[i * k + j] of known mean x_mean[j]; k = 0 gives the plain mean
+vr_estimate vr_control_variates(const double *y, const double *x, int n, int k, const double *x_mean);
+
+// n antithetic pairs (y[i], y_anti[i]) with the pair-averaged controls corrected as above
+vr_estimate vr_antithetic(const double *y, const double *y_anti, const double *x, const double *x_anti,
+                          int n, int k, const double *x_mean);
+
+#endif // VARIANCE_REDUCTION_H
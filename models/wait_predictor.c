@@ -0,0 +1,28 @@
+#include <string.h>
+#include "wait_predictor.h"
+
+void init_wait_predictor(wait_predictor *p, wait_predictor_kind kind, int operators,
+                         double prior_service_time, double smoothing) {
+    p->kind = kind;
+    p->operators = operators;
+    p->busy = 0;
+    p->queued = 0;
+    p->observed_waits = 0;
+    p->avg_wait = 0.0;
+    p->service_time = prior_service_time;
+    p->smoothing = smoothing;
+}
+
+int wait_predictor_kind_from_name(const char *name) {
+    if (strcmp(name, "average") == 0) {
+        return WAIT_PREDICTOR_QUEUE_AVERAGE;
+    }
+    if (strcmp(name, "rate") == 0) {
+        return WAIT_PREDICTOR_COMPLETION_RATE;
+    }
+    return -1;
+}
+
+const char *wait_predictor_name(wait_predictor_kind kind) {
+    return (kind == WAIT_PREDICTOR_COMPLETION_RATE) ? "rate" : "average";
+}
@@ -0,0 +1,87 @@
+#ifndef WAIT_PREDICTOR_H
+#define WAIT_PREDICTOR_H
+
+#include <stdint.h>
+
+// Online waiting-time prediction for a pool of operators with a FIFO queue.
+// The predictor consumes the live events of the pool (arrival admitted, queued
+// call answered, service completed) and keeps O(1) state, so a prediction is a
+// handful of arithmetic operations and can be served per call in real time.
+//
+//   WAIT_PREDICTOR_QUEUE_AVERAGE  calls ahead * running mean of observed waits
+//                                 (the simulator's original estimate)
+//   WAIT_PREDICTOR_COMPLETION_RATE (calls ahead + 1) / completion rate of a full
+//                                 pool, the rate being operators / EWMA of service
+//                                 times; exact in mean for exponential services
+
+#define WAIT_PREDICTOR_DEFAULT_SMOOTHING 0.02  // EWMA weight of the newest service time
+
+typedef enum {
+    WAIT_PREDICTOR_QUEUE_AVERAGE = 0,
+    WAIT_PREDICTOR_COMPLETION_RATE = 1,
+} wait_predictor_kind;
+
+typedef struct {
+    wait_predictor_kind kind;
+    int operators;
+    int busy;               // Operators serving a call
+    int queued;             // Calls waiting, in arrival order
+    int64_t observed_waits;
+    double avg_wait;        // Running mean of answered calls' waits
+    double service_time;    // EWMA of completed service times
+    double smoothing;
+} wait_predictor;
+
+void init_wait_predictor(wait_predictor *p, wait_predictor_kind kind, int operators,
+                         double prior_service_time, double smoothing);
+// Parses "average" or "rate"; returns -1 for anything else
+int wait_predictor_kind_from_name(const char *name);
+const char *wait_predictor_name(wait_predictor_kind kind);
+
+// Expected wait of a call arriving now (0 while an operator is free)
+static inline double wait_predictor_predict(const wait_predictor *p) {
+    if (p->busy < p->operators) {
+        return 0.0;
+    }
+    if (p->kind == WAIT_PREDICTOR_COMPLETION_RATE) {
+        return (p->queued + 1) * p->service_time / p->operators;
+    }
+    return p->queued * p->avg_wait;
+}
+
+// A call was admitted: answered at once if an operator is free, queued otherwise
+static inline void wait_predictor_arrival(wait_predictor *p) {
+    if (p->busy < p->operators) {
+        p->busy++;
+    } else {
+        p->queued++;
+    }
+}
+
+// The call at the head of the queue was answered after waiting `wait`
+static inline void wait_predictor_answer(wait_predictor *p, double wait) {
+    p->queued--;
+    p->busy++;
+    int64_t n = ++p->observed_waits;
+    p->avg_wait = (p->avg_wait * ((n - 1.0) / n)) + (wait * (1.0 / n));
+}
+
+// An interrupted call got an operator back (its wait was observed when first answered)
+static inline void wait_predictor_resume(wait_predictor *p) {
+    p->queued--;
+    p->busy++;
+}
+
+// A queued call hung up before being answered
+static inline void wait_predictor_abandon(wait_predictor *p) {
+    p->queued--;
+}
+
+// A call finished after `service_time` in service and its operator went idle
+// (a queued call taking over is reported through wait_predictor_answer)
+static inline void wait_predictor_departure(wait_predictor *p, double service_time) {
+    p->busy--;
+    p->service_time += p->smoothing * (service_time - p->service_time);
+}
+
+#endif // WAIT_PREDICTOR_H
@@ -15,4 +15,9 @@
 #define MIN_QUEUE_LEN 1
 #define MAX_QUEUE_LEN 20
 
+// Surrogate-guided search (optimize_surrogate): total simulations, of which
+// the Latin hypercube initial design
+#define SURROGATE_BUDGET 200
+#define SURROGATE_INITIAL_POINTS 16
+
 #endif // OPTIMIZE_PARAM_H
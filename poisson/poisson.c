@@ -13,14 +13,133 @@
 #include <stdlib.h>
 #include <math.h>
 #include <time.h>
+#include "poisson.h"
+#include "../models/profiling.h"
+
+// Stream used by the calling thread until rng_seed() is called
+static __thread rng_state thread_rng = {
+    {0x9E3779B97F4A7C15ULL, 0xBF58476D1CE4E5B9ULL, 0x94D049BB133111EBULL, 0x2545F4914F6CDD1DULL}
+};
+
+// When set, every uniform u is replaced by its mirror 1 - u (see rng_set_antithetic)
+static __thread int thread_antithetic = 0;
+
+static uint64_t splitmix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// Seeds the calling thread's stream (replaces srand)
+void rng_seed(unsigned long long seed)
+{
+    uint64_t x = seed;
+    for (int i = 0; i < 4; i++)
+    {
+        thread_rng.s[i] = splitmix64(&x);
+    }
+}
+
+// Save and restore the calling thread's stream, so a library call can run its own
+// seeded simulation without disturbing the caller's draws
+void rng_get_state(rng_state *state)
+{
+    *state = thread_rng;
+}
+
+void rng_set_state(const rng_state *state)
+{
+    thread_rng = *state;
+}
+
+int rng_get_antithetic(void)
+{
+    return thread_antithetic;
+}
+
+// Antithetic variates: a run reseeded with the same seed and this flag set sees the
+// mirrored draws, so every inverse-transform variate moves the other way
+void rng_set_antithetic(int enabled)
+{
+    thread_antithetic = enabled;
+}
+
+// One xoshiro256+ step: returns the next 64-bit output and advances s
+static inline uint64_t xoshiro_next(uint64_t *s)
+{
+    uint64_t result = s[0] + s[3];
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+// Exchanges the calling thread's stream with *state, so a second stream can be
+// drawn from for a while and put back with a second call
+void rng_swap_state(rng_state *state)
+{
+    rng_state tmp = thread_rng;
+    thread_rng = *state;
+    *state = tmp;
+}
+
+// Advances *state by 2^128 draws: streams jumped from one seed never overlap
+void rng_jump(rng_state *state)
+{
+    static const uint64_t jump[] = {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+    uint64_t s[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            if (jump[i] & (1ULL << b))
+            {
+                for (int j = 0; j < 4; j++)
+                {
+                    s[j] ^= state->s[j];
+                }
+            }
+            xoshiro_next(state->s);
+        }
+    }
+    for (int j = 0; j < 4; j++)
+    {
+        state->s[j] = s[j];
+    }
+}
+
+// Uniform double in [0, 1) with 53 bits of resolution
+double next_uniform(void)
+{
+    PROF_RNG_DRAW();
+    uint64_t result = xoshiro_next(thread_rng.s);
+
+    double u = (double)(result >> 11) * 0x1.0p-53;
+    // Mirror on the same 2^-53 grid so the result stays in [0, 1)
+    return thread_antithetic ? (1.0 - 0x1.0p-53) - u : u;
+}
 
 double next_poisson(double x)
 {
     double u;
     do
     {
-        u = (double)rand() / (double)RAND_MAX;
-    } while (u == 0.0 || u == 1.0);
+        u = next_uniform();
+    } while (u == 0.0);
 
     return (-x) * log(u);
 }
@@ -13,6 +13,22 @@
 #ifndef poisson_H
 #define poisson_H
 
+#include <stdint.h>
+
+// xoshiro256+ generator state. Each thread owns one stream, so simulations
+// running on a thread pool neither share nor lock a global generator.
+typedef struct {
+    uint64_t s[4];
+} rng_state;
+
+void rng_seed(unsigned long long seed);
+void rng_get_state(rng_state *state);
+void rng_set_state(const rng_state *state);
+void rng_swap_state(rng_state *state);
+void rng_jump(rng_state *state);
+int rng_get_antithetic(void);
+void rng_set_antithetic(int enabled);
+double next_uniform(void);
 double next_poisson(double x);
 
 #endif // poisson_H
@@ -14,6 +14,8 @@ import seaborn as sns
 from pathlib import Path
 from scipy import stats
 
+from trace_loader import load_delay_trace
+
 # Set style
 sns.set_style("whitegrid")
 plt.rcParams['figure.figsize'] = (10, 6)
@@ -26,9 +28,16 @@ PLOTS_DIR = BASE_DIR / "plots" / "call_center"
 PLOTS_DIR.mkdir(parents=True, exist_ok=True)
 
 
+def load_delays(delay_file):
+    """Per-call delays from the binary trace (default) or the legacy CSV (--trace csv)."""
+    if delay_file.suffix == ".trc":
+        return load_delay_trace(delay_file)
+    return pd.read_csv(delay_file)
+
+
 def plot_delay_distribution(delay_file):
     """Plot the distribution of actual delays."""
-    df = pd.read_csv(delay_file)
+    df = load_delays(delay_file)
     
     fig, axes = plt.subplots(1, 2, figsize=(14, 5))
     
@@ -83,7 +92,7 @@ def plot_delay_distribution(delay_file):
 
 def plot_prediction_errors(delay_file):
     """Plot histograms of prediction errors."""
-    df = pd.read_csv(delay_file)
+    df = load_delays(delay_file)
     
     fig, axes = plt.subplots(2, 2, figsize=(14, 10))
     
@@ -256,7 +265,7 @@ def plot_sensitivity_analysis(sensitivity_file, nominal_rate=80.0):
 
 def generate_summary_report(delay_file, sensitivity_file):
     """Generate a comprehensive text report."""
-    delay_df = pd.read_csv(delay_file)
+    delay_df = load_delays(delay_file)
     sens_df = pd.read_csv(sensitivity_file)
     
     report_file = PLOTS_DIR / 'simulation_report.txt'
@@ -314,7 +323,9 @@ def main():
     print("CALL CENTER SIMULATION - RESULTS ANALYSIS")
     print("="*70 + "\n")
     
-    delay_file = DATA_DIR / "delay_distribution.csv"
+    delay_file = DATA_DIR / "delay_distribution.trc"
+    if not delay_file.exists():
+        delay_file = DATA_DIR / "delay_distribution.csv"
     sensitivity_file = DATA_DIR / "sensitivity_analysis.csv"
     
     # Check if files exist
@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+"""
+ctypes bindings for libtelesim.so (build with `make libtelesim.so`).
+
+Runs the simulation engines in-process. Array results (per-call delays,
+histograms, queue length distributions) are numpy views of the library's
+buffers, freed when the owning result object is garbage collected.
+
+    import telesim
+    r = telesim.run_call_center(gen_operators=3, spec_operators=3, gen_queue_length=5, seed=42)
+    r.prob_call_delayed, r.delays["actual"].mean()
+"""
+
+import ctypes
+import os
+import weakref
+from pathlib import Path
+
+import numpy as np
+
+API_VERSION = 2
+ENGINES = {"event": 0, "kw": 1, "ctmc": 2}
+
+_LIB_PATH = os.environ.get("TELESIM_LIB", str(Path(__file__).parent.parent / "libtelesim.so"))
+
+
+class CallCenterConfig(ctypes.Structure):
+    _fields_ = [
+        ("gen_operators", ctypes.c_int),
+        ("spec_operators", ctypes.c_int),
+        ("gen_queue_length", ctypes.c_int),
+        ("arrival_rate_per_hour", ctypes.c_double),
+        ("general_purpose_ratio", ctypes.c_double),
+        ("gen_only_min_duration_s", ctypes.c_double),
+        ("gen_only_avg_duration_s", ctypes.c_double),
+        ("gen_only_max_duration_s", ctypes.c_double),
+        ("spec_min_duration_s", ctypes.c_double),
+        ("spec_avg_duration_s", ctypes.c_double),
+        ("spec_std_duration_s", ctypes.c_double),
+        ("spec_max_duration_s", ctypes.c_double),
+        ("area_spec_min_duration_s", ctypes.c_double),
+        ("area_spec_avg_duration_s", ctypes.c_double),
+        ("number_of_events", ctypes.c_int),
+        ("engine", ctypes.c_int),
+        ("seed", ctypes.c_uint64),
+        ("antithetic", ctypes.c_int),
+    ]
+
+
+class _Delay(ctypes.Structure):
+    _fields_ = [("predicted", ctypes.c_double), ("actual", ctypes.c_double)]
+
+
+DELAY_DTYPE = np.dtype([("predicted", "<f8"), ("actual", "<f8")])
+
+
+class _CallCenterResult(ctypes.Structure):
+    _fields_ = [
+        ("prob_call_delayed", ctypes.c_double),
+        ("prob_call_lost", ctypes.c_double),
+        ("avg_delay_s", ctypes.c_double),
+        ("avg_abs_prediction_error", ctypes.c_double),
+        ("avg_rel_prediction_error", ctypes.c_double),
+        ("gen_avg_busy_operators", ctypes.c_double),
+        ("gen_avg_queue_length", ctypes.c_double),
+        ("avg_answer_time_s", ctypes.c_double),
+        ("spec_avg_busy_operators", ctypes.c_double),
+        ("spec_avg_queue_length", ctypes.c_double),
+        ("mean_interarrival_time", ctypes.c_double),
+        ("generic_only_fraction", ctypes.c_double),
+        ("mean_service_time", ctypes.c_double),
+        ("delay_p50_s", ctypes.c_double),
+        ("delay_p90_s", ctypes.c_double),
+        ("delay_p99_s", ctypes.c_double),
+        ("delay_p999_s", ctypes.c_double),
+        ("delays", ctypes.POINTER(_Delay)),
+        ("n_delays", ctypes.c_int64),
+        ("gen_queue_length_distribution", ctypes.POINTER(ctypes.c_double)),
+        ("gen_queue_length_distribution_size", ctypes.c_int32),
+        ("spec_queue_length_distribution", ctypes.POINTER(ctypes.c_double)),
+        ("spec_queue_length_distribution_size", ctypes.c_int32),
+    ]
+
+
+class _ErlangResult(ctypes.Structure):
+    _fields_ = [
+        ("prob_delayed", ctypes.c_double),
+        ("avg_delay_s", ctypes.c_double),
+        ("prob_delayed_more", ctypes.c_double),
+        ("block_probability", ctypes.c_double),
+        ("avg_busy", ctypes.c_double),
+        ("avg_queue_length", ctypes.c_double),
+        ("mean_interarrival", ctypes.c_double),
+        ("mean_service", ctypes.c_double),
+        ("delay_p50_s", ctypes.c_double),
+        ("delay_p90_s", ctypes.c_double),
+        ("delay_p99_s", ctypes.c_double),
+        ("delay_p999_s", ctypes.c_double),
+        ("delay_histogram", ctypes.POINTER(ctypes.c_int32)),
+        ("delay_histogram_size", ctypes.c_int32),
+        ("queue_length_distribution", ctypes.POINTER(ctypes.c_double)),
+        ("queue_length_distribution_size", ctypes.c_int32),
+    ]
+
+
+_lib = ctypes.CDLL(_LIB_PATH)
+_lib.telesim_api_version.restype = ctypes.c_int
+_lib.telesim_default_call_center_config.argtypes = [ctypes.POINTER(CallCenterConfig)]
+_lib.telesim_default_call_center_config.restype = None
+_lib.telesim_run_call_center.argtypes = [ctypes.POINTER(CallCenterConfig), ctypes.POINTER(_CallCenterResult)]
+_lib.telesim_run_call_center.restype = ctypes.c_int
+_lib.telesim_free_call_center_result.argtypes = [ctypes.POINTER(_CallCenterResult)]
+_lib.telesim_free_call_center_result.restype = None
+_lib.telesim_run_erlang.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.c_double, ctypes.c_int,
+                                    ctypes.c_double, ctypes.c_int, ctypes.c_uint64,
+                                    ctypes.POINTER(_ErlangResult)]
+_lib.telesim_run_erlang.restype = ctypes.c_int
+_lib.telesim_free_erlang_result.argtypes = [ctypes.POINTER(_ErlangResult)]
+_lib.telesim_free_erlang_result.restype = None
+_lib.telesim_erlang_b_curve.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.c_double, ctypes.c_int,
+                                        ctypes.c_uint64, ctypes.POINTER(ctypes.c_double)]
+_lib.telesim_erlang_b_curve.restype = ctypes.c_int
+
+if _lib.telesim_api_version() != API_VERSION:
+    raise ImportError(f"{_LIB_PATH} implements API version {_lib.telesim_api_version()}, expected {API_VERSION}")
+
+
+def _view(owner, pointer, size, dtype):
+    """numpy view of a library-owned buffer (no copy) that keeps owner, and so the buffer, alive."""
+    if size == 0 or not pointer:
+        return np.empty(0, dtype=dtype)
+    buffer_type = ctypes.c_byte * (size * dtype.itemsize)
+    buffer = buffer_type.from_address(ctypes.cast(pointer, ctypes.c_void_p).value)
+    buffer._owner = owner
+    return np.frombuffer(buffer, dtype=dtype)
+
+
+class _Result:
+    """Scalar fields as attributes. The arrays reference this object, so the
+    library buffers are freed only once neither it nor any array is alive."""
+
+    def __init__(self, raw, free):
+        self._raw = raw
+        for name, _ in raw._fields_:
+            value = getattr(raw, name)
+            if isinstance(value, (int, float)):
+                setattr(self, name, value)
+        self._finalizer = weakref.finalize(self, free, ctypes.byref(raw))
+
+    def __repr__(self):
+        fields = ", ".join(f"{k}={v:.6g}" for k, v in vars(self).items()
+                           if not k.startswith("_") and isinstance(v, float))
+        return f"{type(self).__name__}({fields})"
+
+
+class CallCenterResult(_Result):
+    def __init__(self, raw):
+        super().__init__(raw, _lib.telesim_free_call_center_result)
+        self.delays = _view(self, raw.delays, raw.n_delays, DELAY_DTYPE)
+        self.gen_queue_length_distribution = _view(self, raw.gen_queue_length_distribution,
+                                                   raw.gen_queue_length_distribution_size, np.dtype("<f8"))
+        self.spec_queue_length_distribution = _view(self, raw.spec_queue_length_distribution,
+                                                    raw.spec_queue_length_distribution_size, np.dtype("<f8"))
+
+
+class ErlangResult(_Result):
+    def __init__(self, raw):
+        super().__init__(raw, _lib.telesim_free_erlang_result)
+        self.delay_histogram = _view(self, raw.delay_histogram, raw.delay_histogram_size, np.dtype("<i4"))
+        self.queue_length_distribution = _view(self, raw.queue_length_distribution,
+                                               raw.queue_length_distribution_size, np.dtype("<f8"))
+
+
+def default_config():
+    config = CallCenterConfig()
+    _lib.telesim_default_call_center_config(ctypes.byref(config))
+    return config
+
+
+def run_call_center(config=None, engine="event", **overrides):
+    """Run one call center simulation. Keyword arguments override fields of config (default_config())."""
+    config = config if config is not None else default_config()
+    config.engine = ENGINES[engine]
+    for name, value in overrides.items():
+        setattr(config, name, value)
+    raw = _CallCenterResult()
+    if _lib.telesim_run_call_center(ctypes.byref(config), ctypes.byref(raw)) != 0:
+        raise ValueError("invalid call center configuration")
+    return CallCenterResult(raw)
+
+
+def run_erlang(channels, queue_capacity, lambda_=200, avg_duration_s=0.008, number_of_events=100000,
+               delay_threshold_s=0.0, seed=42):
+    """M/M/c/K system (K = channels + queue_capacity)."""
+    raw = _ErlangResult()
+    if _lib.telesim_run_erlang(channels, lambda_, avg_duration_s, number_of_events, delay_threshold_s,
+                               queue_capacity, seed, ctypes.byref(raw)) != 0:
+        raise ValueError("invalid Erlang system parameters")
+    return ErlangResult(raw)
+
+
+def erlang_b_curve(max_channels, lambda_=200, avg_duration_s=0.008, number_of_events=100000, seed=42):
+    """Erlang-B blocking for 1..max_channels, written directly into a numpy array."""
+    blocking = np.empty(max_channels, dtype=np.float64)
+    if _lib.telesim_erlang_b_curve(max_channels, lambda_, avg_duration_s, number_of_events, seed,
+                                   blocking.ctypes.data_as(ctypes.POINTER(ctypes.c_double))) != 0:
+        raise ValueError("invalid Erlang-B parameters")
+    return blocking
+
+
+if __name__ == "__main__":
+    result = run_call_center(gen_operators=3, spec_operators=3, gen_queue_length=5)
+    print(result)
+    print(f"{len(result.delays)} delays, mean {result.delays['actual'].mean():.2f} s")
+    print("Erlang-B:", np.round(erlang_b_curve(10), 6))
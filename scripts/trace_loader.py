@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+Loader for the columnar binary traces written by models/trace_writer.c
+(e.g. outputs/call_center/delay_distribution.trc).
+
+Layout: a 24-byte header (magic, n_columns, chunk_rows, n_rows), one 32-byte
+descriptor per column (name, type, width), then chunks of chunk_rows rows
+stored column by column; the last chunk holds the remaining rows.
+"""
+
+import sys
+
+import numpy as np
+
+TRACE_MAGIC = b"TSTRACE1"
+TRACE_TYPES = {1: np.dtype("<f8")}
+
+HEADER_DTYPE = np.dtype([("magic", "S8"), ("n_columns", "<u4"), ("chunk_rows", "<u4"), ("n_rows", "<u8")])
+COLUMN_DTYPE = np.dtype([("name", "S24"), ("type", "<u4"), ("width", "<u4")])
+
+
+def load_trace(path):
+    """Return {column name: numpy array}.
+
+    Columns of a single-chunk trace are read-only numpy.memmap views of the
+    file; longer traces are gathered chunk by chunk from one memmap.
+    """
+    header = np.fromfile(path, dtype=HEADER_DTYPE, count=1)[0]
+    if header["magic"] != TRACE_MAGIC:
+        raise ValueError(f"{path} is not a trace file")
+    n_columns = int(header["n_columns"])
+    chunk_rows = int(header["chunk_rows"])
+    n_rows = int(header["n_rows"])
+
+    columns = np.fromfile(path, dtype=COLUMN_DTYPE, count=n_columns, offset=HEADER_DTYPE.itemsize)
+    dtypes = [TRACE_TYPES[int(c["type"])] for c in columns]
+    if len(set(dtypes)) != 1:
+        raise ValueError("mixed column types are not supported")
+    dtype = dtypes[0]
+    names = [c["name"].decode() for c in columns]
+    if n_rows == 0:
+        return {name: np.empty(0, dtype=dtype) for name in names}
+
+    data = np.memmap(path, dtype=dtype, mode="r",
+                     offset=HEADER_DTYPE.itemsize + n_columns * COLUMN_DTYPE.itemsize,
+                     shape=(n_rows * n_columns,))
+    full_chunks, last_rows = divmod(n_rows, chunk_rows)
+    split = full_chunks * chunk_rows * n_columns
+    full = data[:split].reshape(full_chunks, n_columns, chunk_rows)
+    last = data[split:].reshape(n_columns, last_rows)
+
+    result = {}
+    for c, name in enumerate(names):
+        if full_chunks == 0:
+            result[name] = last[c]
+        elif last_rows == 0 and full_chunks == 1:
+            result[name] = full[0, c]
+        else:
+            result[name] = np.concatenate([full[:, c, :].reshape(-1), last[c]])
+    return result
+
+
+def load_delay_trace(path):
+    """Delay trace as a DataFrame with the columns of the legacy delay_distribution.csv."""
+    import pandas as pd
+
+    trace = load_trace(path)
+    actual = np.asarray(trace["actual_delay"])
+    predicted = np.asarray(trace["predicted_delay"])
+    abs_error = np.abs(predicted - actual)
+    with np.errstate(divide="ignore", invalid="ignore"):
+        rel_error = abs_error / np.abs(actual)
+    return pd.DataFrame({
+        "actual_delay": actual,
+        "predicted_delay": predicted,
+        "absolute_error": abs_error,
+        "relative_error": rel_error,
+    })
+
+
+if __name__ == "__main__":
+    for path in sys.argv[1:]:
+        for name, values in load_trace(path).items():
+            print(f"{path}: {name}: {len(values)} rows, mean {values.mean():.6f}")
@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "kiefer_wolfowitz.h"
+#include "../poisson/poisson.h"
+#include "../models/profiling.h"
+
+void init_kw_station(kw_station *st, int servers) {
+    init_min_heap(&st->free_at, servers);
+    for (int i = 0; i < servers; i++) {
+        min_heap_push(&st->free_at, 0.0, i);
+    }
+
+    st->head = 0;
+    st->count = 0;
+    st->capacity = 16;
+    st->waiting = malloc(st->capacity * sizeof(kw_call));
+    PROF_ALLOC();
+    if (!st->waiting) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void grow_waiting(kw_station *st) {
+    kw_call *tmp = malloc(2 * st->capacity * sizeof(kw_call));
+    PROF_ALLOC();
+    if (!tmp) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Unwrap the ring so the oldest call lands at index 0
+    int first = st->capacity - st->head;
+    if (first > st->count) {
+        first = st->count;
+    }
+    memcpy(tmp, st->waiting + st->head, first * sizeof(kw_call));
+    memcpy(tmp + first, st->waiting, (st->count - first) * sizeof(kw_call));
+
+    free(st->waiting);
+    st->waiting = tmp;
+    st->head = 0;
+    st->capacity *= 2;
+}
+
+// Seizes the earliest free server and returns the call's start time. The caller
+// decides blocking beforehand from kw_next_free() and kw_queue_length().
+double kw_admit(kw_station *st, double arrival, double service, double tag) {
+    heap_node server = min_heap_pop(&st->free_at);
+    double start = (server.key > arrival) ? server.key : arrival;
+    min_heap_push(&st->free_at, start + service, server.value);
+
+    if (start > arrival) {
+        if (st->count == st->capacity) {
+            grow_waiting(st);
+        }
+        int tail = st->head + st->count;
+        if (tail >= st->capacity) {
+            tail -= st->capacity;
+        }
+        st->waiting[tail].arrival = arrival;
+        st->waiting[tail].start = start;
+        st->waiting[tail].tag = tag;
+        st->count++;
+    }
+    return start;
+}
+
+void free_kw_station(kw_station *st) {
+    free_min_heap(&st->free_at);
+    free(st->waiting);
+    st->waiting = NULL;
+    st->count = st->capacity = 0;
+}
+
+// Same statistics as erlang_c_system, computed call by call with the recursion.
+// Every call's wait is known on admission, so no waiting ring pops are needed.
+ErlangCstat erlang_c_system_kw(int channels, int lambda, double avg_duration, int n_samples, double delay_threshold) {
+    double delta = (1.0 / 5.0) * (1.0 / lambda);
+    double v_max = 5.0 * (1.0 / lambda);
+    int n = round(v_max / delta);
+    int *histogram = calloc(n, sizeof(int));
+    if (!histogram) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    hdr_histogram log_histogram;
+    init_sample_histogram(&log_histogram);
+
+    min_heap free_at;
+    init_min_heap(&free_at, channels);
+    for (int i = 0; i < channels; i++) {
+        min_heap_push(&free_at, 0.0, i);
+    }
+
+    double now = 0.0;
+    double total_waiting_time = 0.0;
+    int delayed = 0;
+    int higher_than_threshold = 0;
+
+    for (int total = 0; total < n_samples; total++) {
+        PROF_EVENT_BEGIN(prof_start);
+        heap_node server = min_heap_pop(&free_at);
+        double wait = server.key - now;
+
+        if (wait > 0.0) {
+            delayed++;
+            total_waiting_time += wait;
+
+            int bin_index = (int)(wait / delta);
+            if (bin_index >= n - 1) {
+                bin_index = n - 1;
+            }
+            histogram[bin_index]++;
+            hdr_histogram_record(&log_histogram, wait);
+
+            if (wait >= delay_threshold) {
+                higher_than_threshold++;
+            }
+        } else {
+            wait = 0.0;
+        }
+
+        min_heap_push(&free_at, now + wait + next_poisson(avg_duration), server.value);
+        now += next_poisson(1.0 / lambda);
+        PROF_EVENT_END(prof_start, PROF_EVENT_ARRIVAL);
+    }
+    PROF_FLUSH();
+    free_min_heap(&free_at);
+
+    ErlangCstat result;
+    result.prob_pkt_delayed = (double)delayed / (double)n_samples;
+    result.avg_delay_all_pkt = (delayed > 0) ? total_waiting_time / (double)delayed : 0.0;
+    result.prob_pkt_delayed_more_ax = (double)higher_than_threshold / (double)n_samples;
+    result.histogram = histogram;
+    result.histogram_size = n;
+    result.log_histogram = log_histogram;
+
+    return result;
+}
@@ -0,0 +1,55 @@
+#ifndef KIEFER_WOLFOWITZ_H
+#define KIEFER_WOLFOWITZ_H
+
+#include "../models/min_heap.h"
+#include "../models/models.h"
+
+// FIFO c-server station driven by the Kiefer-Wolfowitz recursion: calls are
+// offered in arrival order and each one starts at max(arrival, earliest server
+// free time), so no future-event list is needed. Calls that have to wait stay
+// in a FIFO ring until their start time has passed, which gives the queue
+// length seen by later arrivals (finite-buffer blocking) and the order in
+// which waits become known.
+
+typedef struct {
+    double arrival;
+    double start;
+    double tag;         // Caller data carried with the call (e.g. predicted wait)
+} kw_call;
+
+typedef struct {
+    min_heap free_at;   // Time at which each server becomes free
+    kw_call *waiting;   // Ring of calls whose start lies in the future
+    int head;
+    int count;
+    int capacity;
+} kw_station;
+
+void init_kw_station(kw_station *st, int servers);
+double kw_admit(kw_station *st, double arrival, double service, double tag);
+void free_kw_station(kw_station *st);
+
+// Earliest time any server is free; a call arriving before it has to wait
+static inline double kw_next_free(const kw_station *st) {
+    return min_heap_top(&st->free_at).key;
+}
+
+// Calls still waiting at the last arrival offered
+static inline int kw_queue_length(const kw_station *st) {
+    return st->count;
+}
+
+// Pops the oldest waiting call if it has started by `now`; returns 0 when none has
+static inline int kw_pop_started(kw_station *st, double now, kw_call *out) {
+    if (st->count == 0 || st->waiting[st->head].start > now) {
+        return 0;
+    }
+    *out = st->waiting[st->head];
+    st->head = (st->head + 1 == st->capacity) ? 0 : st->head + 1;
+    st->count--;
+    return 1;
+}
+
+ErlangCstat erlang_c_system_kw(int channels, int lambda, double avg_duration, int n_samples, double delay_threshold);
+
+#endif // KIEFER_WOLFOWITZ_H
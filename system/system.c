@@ -1,9 +1,22 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
 #include "../models/linked-list.h"
 #include "../poisson/poisson.h"
 #include "../models/models.h"
+#include "system.h"
+#include "../models/profiling.h"
+#include "../models/time_average.h"
+#include "../models/min_heap.h"
+#include "../models/service_dist.h"
+#include "../models/compensated_sum.h"
+
+// Service time of the M/G/c engines: exponential when no law is given
+static inline double service_time(const service_dist *service, double avg_duration) {
+    return (service != NULL) ? service_dist_draw(service, avg_duration) : next_poisson(avg_duration);
+}
 
 double erlang_b_system(int channels, int lambda, double avg_duration, int n_samples) {
     int busy = 0;
@@ -16,6 +29,10 @@ double erlang_b_system(int channels, int lambda, double avg_duration, int n_samp
 
     while (total < n_samples)
     {
+        PROF_EVENT_BEGIN(prof_start);
+#ifdef TELESIM_PROFILE
+        prof_event_type prof_type = (event_list->type == ARRIVAL) ? PROF_EVENT_ARRIVAL : PROF_EVENT_DEPARTURE;
+#endif
         if (event_list->type == ARRIVAL) {
             if (busy >= channels) {
                 blocked++;
@@ -33,17 +50,130 @@ double erlang_b_system(int channels, int lambda, double avg_duration, int n_samp
             }
         }
         event_list = __remove(event_list);
+        PROF_EVENT_END(prof_start, prof_type);
     }
+    PROF_FLUSH();
 
     return (blocked > 0) ? blocked / total : 0.0;
 }
 
-ErlangCstat erlang_c_system(int channels, int lambda, double avg_duration, int n_samples, double delay_threshold) {
-    int total = 0;
+// Exact M/M/c/K values for erlang_gen_system (K = channels + queue_capacity): the
+// probability that an arrival is lost and that it has to queue
+void erlang_gen_analytic(int channels, int lambda, double avg_duration, int queue_capacity,
+                         double *block_probability, double *prob_delayed) {
+    double load = lambda * avg_duration;
+    double term = 1.0, sum = 0.0, waiting = 0.0;
+
+    for (int n = 0; n <= channels + queue_capacity; n++) {
+        if (n > 0) {
+            term *= load / ((n < channels) ? n : channels);
+        }
+        sum += term;
+        if (n >= channels && n < channels + queue_capacity) {
+            waiting += term;
+        }
+    }
+    *block_probability = term / sum;
+    *prob_delayed = waiting / sum;
+}
+
+// Index of the lowest free trunk in the bitset (bit set = free), or n_words * 64 if all are busy
+static inline int lowest_free_trunk(const uint64_t *free_trunks, int n_words) {
+    for (int w = 0; w < n_words; w++) {
+        if (free_trunks[w] != 0) {
+            return w * 64 + __builtin_ffsll((long long)free_trunks[w]) - 1;
+        }
+    }
+    return n_words * 64;
+}
+
+// Erlang-B blocking for 1..max_channels from one run. With ordered hunting every
+// call seizes the lowest-numbered free trunk, so the traffic offered to trunks
+// >= c is exactly the overflow of a c-channel loss system: blocking[c - 1]
+// receives the fraction of calls that found trunks 0..c-1 all busy.
+void erlang_b_curve(int max_channels, int lambda, double avg_duration, int n_samples, double *blocking) {
+    int n_words = (max_channels + 63) / 64;
+    uint64_t *free_trunks = calloc(n_words, sizeof(uint64_t));
+    // seized[k]: calls that seized trunk k; seized[max_channels]: overflow of the whole group
+    int64_t *seized = calloc(max_channels + 1, sizeof(int64_t));
+    if (!free_trunks || !seized) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int k = 0; k < max_channels; k++) {
+        free_trunks[k / 64] |= UINT64_C(1) << (k % 64);
+    }
+
+    min_heap departures;
+    init_min_heap(&departures, max_channels);
+
+    double next_arrival = 0.0;
+    int64_t total = 0;
+
+    while (total < n_samples) {
+        PROF_EVENT_BEGIN(prof_start);
+        if (!min_heap_empty(&departures) && min_heap_top(&departures).key < next_arrival) {
+            int trunk = min_heap_pop(&departures).value;
+            free_trunks[trunk / 64] |= UINT64_C(1) << (trunk % 64);
+            PROF_EVENT_END(prof_start, PROF_EVENT_DEPARTURE);
+            continue;
+        }
+
+        total++;
+        int trunk = lowest_free_trunk(free_trunks, n_words);
+        if (trunk < max_channels) {
+            free_trunks[trunk / 64] &= ~(UINT64_C(1) << (trunk % 64));
+            min_heap_push(&departures, next_arrival + next_poisson(avg_duration), trunk);
+            seized[trunk]++;
+        } else {
+            seized[max_channels]++;
+        }
+        next_arrival += next_poisson(1.0 / lambda);
+        PROF_EVENT_END(prof_start, PROF_EVENT_ARRIVAL);
+    }
+    PROF_FLUSH();
+
+    // Suffix sums: a call is blocked by c channels if it seized trunk c or higher
+    int64_t overflow = seized[max_channels];
+    for (int c = max_channels; c >= 1; c--) {
+        blocking[c - 1] = (double)overflow / (double)total;
+        overflow += seized[c - 1];
+    }
+
+    free_min_heap(&departures);
+    free(seized);
+    free(free_trunks);
+}
+
+// Number of sorted thresholds t with t <= value, i.e. the thresholds a wait of `value` reaches
+static int thresholds_reached(const double *thresholds, int n_thresholds, double value) {
+    int lo = 0, hi = n_thresholds;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (thresholds[mid] <= value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Single-pass variant of erlang_c_system: prob_delayed_more[k] receives P(delay >= thresholds[k])
+// for every threshold. Thresholds must be sorted in ascending order.
+ErlangCstat erlang_c_system_thresholds(int channels, int lambda, double avg_duration, const service_dist *service,
+                                       int n_samples, const double *thresholds, int n_thresholds,
+                                       double *prob_delayed_more) {
+    int64_t total = 0;
     int busy = 0;
-    int higher_than_threshold = 0;
-    double total_waiting_time = 0.0;
-    int delayed = 0;
+    // reached[k]: waits that reached exactly k thresholds, so a single increment per call
+    int64_t *reached = calloc(n_thresholds + 1, sizeof(int64_t));
+    if (!reached) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    compensated_sum total_waiting_time = {0.0, 0.0};
+    int64_t delayed = 0;
 
     list *event_list = NULL;
     list *waiting_queue = NULL;
@@ -57,8 +187,14 @@ ErlangCstat erlang_c_system(int channels, int lambda, double avg_duration, int n
     int n = round(v_max / delta);
 
     int *histogram = calloc(n, sizeof(int)); 
+    hdr_histogram log_histogram;
+    init_sample_histogram(&log_histogram);
 
     while (total < n_samples) {
+        PROF_EVENT_BEGIN(prof_start);
+#ifdef TELESIM_PROFILE
+        prof_event_type prof_type = (event_list->type == ARRIVAL) ? PROF_EVENT_ARRIVAL : PROF_EVENT_DEPARTURE;
+#endif
         if (event_list->type == ARRIVAL) {
             total++;
             if (busy >= channels) {
@@ -66,7 +202,7 @@ ErlangCstat erlang_c_system(int channels, int lambda, double avg_duration, int n
                 waiting_queue = __add_fifo(waiting_queue, ARRIVAL, event_list->time);
             } else {
                 busy++;
-                double dep = next_poisson(avg_duration);
+                double dep = service_time(service, avg_duration);
                 event_list = __add(event_list, DEPARTURE, event_list->time + dep);
             }
             double tmp = next_poisson(1.0 / lambda);
@@ -78,7 +214,7 @@ ErlangCstat erlang_c_system(int channels, int lambda, double avg_duration, int n
             } else if (waiting_queue != NULL) {
                 double elapsed_time = event_list->time - waiting_queue->time;
 
-                total_waiting_time += elapsed_time;
+                compensated_add(&total_waiting_time, elapsed_time);
 
                 int bin_index = (int)(elapsed_time / delta);
 
@@ -88,37 +224,57 @@ ErlangCstat erlang_c_system(int channels, int lambda, double avg_duration, int n
                 }
 
                 histogram[bin_index]++;
+                hdr_histogram_record(&log_histogram, elapsed_time);
 
-                if (elapsed_time >= delay_threshold) {
-                    higher_than_threshold++;
-                }
+                reached[thresholds_reached(thresholds, n_thresholds, elapsed_time)]++;
 
-                double tmp = next_poisson(avg_duration);
+                double tmp = service_time(service, avg_duration);
                 event_list = __add(event_list, DEPARTURE, event_list->time + tmp);
                 waiting_queue = __remove(waiting_queue);
             }
         }
         event_list = __remove(event_list);
+        PROF_EVENT_END(prof_start, prof_type);
     }
+    PROF_FLUSH();
 
     ErlangCstat result;
     result.prob_pkt_delayed = (double)delayed / (double)total;
-    result.avg_delay_all_pkt = (delayed > 0) ? total_waiting_time / (double)delayed : 0.0;
-    result.prob_pkt_delayed_more_ax = (double)higher_than_threshold / (double)total;
+    result.avg_delay_all_pkt = (delayed > 0) ? compensated_value(&total_waiting_time) / (double)delayed : 0.0;
     result.histogram = histogram;
     result.histogram_size = n;
-    
+    result.log_histogram = log_histogram;
+
+    // Suffix sums: a wait counts towards every threshold at or below it
+    int64_t above = 0;
+    for (int k = n_thresholds - 1; k >= 0; k--) {
+        above += reached[k + 1];
+        prob_delayed_more[k] = (double)above / (double)total;
+    }
+    result.prob_pkt_delayed_more_ax = (n_thresholds > 0) ? prob_delayed_more[0] : 0.0;
+    free(reached);
+
     return result;
 }
 
-ErlangGenStat erlang_gen_system(int channels, int lambda, double avg_duration, int n_samples, double delay_threshold, int queue_capacity) {
-    int total = 0;
+ErlangCstat erlang_c_system(int channels, int lambda, double avg_duration, int n_samples, double delay_threshold) {
+    double prob_delayed_more;
+    return erlang_c_system_thresholds(channels, lambda, avg_duration, NULL, n_samples, &delay_threshold, 1,
+                                      &prob_delayed_more);
+}
+
+ErlangGenStat erlang_gen_system(int channels, int lambda, double avg_duration, const service_dist *service,
+                                int n_samples, double delay_threshold, int queue_capacity) {
+    int64_t total = 0;
     int busy = 0;
-    int higher_than_threshold = 0;
-    double total_waiting_time = 0.0;
-    int delayed = 0;
-    int blocked = 0;
+    int64_t higher_than_threshold = 0;
+    compensated_sum total_waiting_time = {0.0, 0.0};
+    int64_t delayed = 0;
+    int64_t blocked = 0;
     int in_queue = 0;
+    compensated_sum interarrival_total = {0.0, 0.0};
+    compensated_sum service_total = {0.0, 0.0};
+    int64_t services = 0;
 
     list *event_list = NULL;
     list *waiting_queue = NULL;
@@ -132,8 +288,21 @@ ErlangGenStat erlang_gen_system(int channels, int lambda, double avg_duration, i
     int n = round(v_max / delta);
 
     int *histogram = calloc(n, sizeof(int)); 
+    hdr_histogram log_histogram;
+    init_sample_histogram(&log_histogram);
+
+    time_average busy_avg, queue_avg;
+    init_time_average(&busy_avg, channels + 1);
+    init_time_average(&queue_avg, queue_capacity + 1);
 
     while (total < n_samples) {
+        PROF_EVENT_BEGIN(prof_start);
+#ifdef TELESIM_PROFILE
+        prof_event_type prof_type = (event_list->type == ARRIVAL) ? PROF_EVENT_ARRIVAL : PROF_EVENT_DEPARTURE;
+#endif
+        time_average_advance(&busy_avg, event_list->time, busy);
+        time_average_advance(&queue_avg, event_list->time, in_queue);
+
         if (event_list->type == ARRIVAL) {
             total++;
             if (busy >= channels) {
@@ -141,6 +310,7 @@ ErlangGenStat erlang_gen_system(int channels, int lambda, double avg_duration, i
                     delayed++;
                     waiting_queue = __add_fifo(waiting_queue, ARRIVAL, event_list->time);
                     in_queue++;
+                    PROF_QUEUE_LENGTH(PROF_QUEUE_ERLANG, in_queue);
                 }
                 else
                 {
@@ -148,10 +318,13 @@ ErlangGenStat erlang_gen_system(int channels, int lambda, double avg_duration, i
                 }
             } else {
                 busy++;
-                double dep = next_poisson(avg_duration);
+                double dep = service_time(service, avg_duration);
+                compensated_add(&service_total, dep);
+                services++;
                 event_list = __add(event_list, DEPARTURE, event_list->time + dep);
             }
             double tmp = next_poisson(1.0 / lambda);
+            compensated_add(&interarrival_total, tmp);
             event_list = __add(event_list, ARRIVAL, event_list->time + tmp);
         } else if (event_list->type == DEPARTURE) {
             if (waiting_queue == NULL && busy > 0) {
@@ -162,7 +335,7 @@ ErlangGenStat erlang_gen_system(int channels, int lambda, double avg_duration, i
             {
                 double elapsed_time = event_list->time - waiting_queue->time;
 
-                total_waiting_time += elapsed_time;
+                compensated_add(&total_waiting_time, elapsed_time);
 
                 int bin_index = (int)(elapsed_time / delta);
 
@@ -172,27 +345,143 @@ ErlangGenStat erlang_gen_system(int channels, int lambda, double avg_duration, i
                 }
 
                 histogram[bin_index]++;
+                hdr_histogram_record(&log_histogram, elapsed_time);
 
                 if (elapsed_time >= delay_threshold) {
                     higher_than_threshold++;
                 }
 
-                double tmp = next_poisson(avg_duration);
+                double tmp = service_time(service, avg_duration);
+                compensated_add(&service_total, tmp);
+                services++;
                 event_list = __add(event_list, DEPARTURE, event_list->time + tmp);
                 waiting_queue = __remove(waiting_queue);
                 in_queue--;
             }
         }
         event_list = __remove(event_list);
+        PROF_EVENT_END(prof_start, prof_type);
     }
+    PROF_FLUSH();
 
     ErlangGenStat result;
     result.prob_pkt_delayed = (double)delayed / (double)total;
-    result.avg_delay_all_pkt = (delayed > 0) ? total_waiting_time / (double)delayed : 0.0;
+    result.avg_delay_all_pkt = (delayed > 0) ? compensated_value(&total_waiting_time) / (double)delayed : 0.0;
     result.prob_pkt_delayed_more_ax = (double)higher_than_threshold / (double)total;
     result.block_probability = (double)blocked / (double)total;
     result.histogram = histogram;
     result.histogram_size = n;
+    result.log_histogram = log_histogram;
+    result.avg_busy = time_average_mean(&busy_avg);
+    result.avg_queue_length = time_average_mean(&queue_avg);
+    result.queue_length_distribution = time_average_distribution(&queue_avg, &result.queue_length_distribution_size);
+    result.mean_interarrival = compensated_value(&interarrival_total) / total;
+    result.mean_service = (services > 0) ? compensated_value(&service_total) / services : 0.0;
+
+    free_time_average(&busy_avg);
+    free_time_average(&queue_avg);
     
     return result;
-}
\ No newline at end of file
+}
+
+// Replications advanced together; one group of lanes fits in a few vector registers
+#define CTMC_LANES 16
+// Steps per block; lane counters are 32-bit and folded into 64-bit totals after each block.
+// The occupancy areas are 64-bit: with an unbounded queue a block can add more than 2^32.
+#define CTMC_BLOCK_STEPS 4096
+
+typedef struct {
+    uint32_t rng[CTMC_LANES];
+    uint32_t state[CTMC_LANES];     // Calls in the system
+    uint32_t arrivals[CTMC_LANES];
+    uint32_t blocked[CTMC_LANES];
+    uint32_t delayed[CTMC_LANES];
+    uint64_t busy_area[CTMC_LANES];
+    uint64_t queue_area[CTMC_LANES];
+} ctmc_lanes;
+
+// Uniformized CTMC for M/M/c/K: the state of a replication is just the number of calls
+// in the system. Every step draws one uniform and applies an arrival (rate lambda), a
+// departure (rate busy * mu) or a self-loop, all against the constant total rate
+// lambda + c * mu. Replications advance in lockstep with one lane per replication, and
+// the lane loop is branch-free integer code that the compiler vectorizes: xorshift32
+// draws are compared against rate thresholds scaled to 2^32.
+void erlang_ctmc_replications(int channels, int lambda, double avg_duration, int queue_capacity,
+                              int n_samples, int n_replications, ErlangRepStat *results) {
+    const double mu = 1.0 / avg_duration;
+    const double total_rate = lambda + channels * mu;
+    const double scale = 4294967295.0 / total_rate;
+    const uint32_t arrival_threshold = (uint32_t)(lambda * scale);
+    const uint32_t departure_threshold = (uint32_t)(mu * scale);
+    const uint32_t c = (uint32_t)channels;
+    const uint32_t capacity = (queue_capacity < 0) ? UINT32_MAX : c + (uint32_t)queue_capacity;
+    const long long total_steps = (long long)ceil(n_samples * total_rate / lambda);
+
+    for (int first = 0; first < n_replications; first += CTMC_LANES) {
+        ctmc_lanes lanes;
+        uint64_t arrivals[CTMC_LANES] = {0}, blocked[CTMC_LANES] = {0}, delayed[CTMC_LANES] = {0};
+        uint64_t busy_area[CTMC_LANES] = {0}, queue_area[CTMC_LANES] = {0};
+
+        memset(&lanes, 0, sizeof(lanes));
+        // Lane streams are seeded from the calling thread's generator; xorshift32 needs a nonzero seed
+        for (int r = 0; r < CTMC_LANES; r++) {
+            lanes.rng[r] = (uint32_t)(next_uniform() * 4294967296.0) | 1u;
+        }
+
+        for (long long done = 0; done < total_steps; done += CTMC_BLOCK_STEPS) {
+            long long steps = total_steps - done;
+            if (steps > CTMC_BLOCK_STEPS) {
+                steps = CTMC_BLOCK_STEPS;
+            }
+
+            for (long long step = 0; step < steps; step++) {
+                for (int r = 0; r < CTMC_LANES; r++) {
+                    uint32_t x = lanes.rng[r];
+                    x ^= x << 13;
+                    x ^= x >> 17;
+                    x ^= x << 5;
+                    lanes.rng[r] = x;
+
+                    uint32_t in_system = lanes.state[r];
+                    uint32_t busy = (in_system < c) ? in_system : c;
+                    lanes.busy_area[r] += busy;
+                    lanes.queue_area[r] += in_system - busy;
+
+                    uint32_t is_arrival = x < arrival_threshold;
+                    uint32_t is_departure = !is_arrival & (x - arrival_threshold < busy * departure_threshold);
+                    uint32_t admitted = is_arrival & (in_system != capacity);
+
+                    lanes.arrivals[r] += is_arrival;
+                    lanes.blocked[r] += is_arrival & !admitted;
+                    lanes.delayed[r] += admitted & (in_system >= c);
+                    lanes.state[r] = in_system + admitted - is_departure;
+                }
+            }
+
+            for (int r = 0; r < CTMC_LANES; r++) {
+                arrivals[r] += lanes.arrivals[r];
+                blocked[r] += lanes.blocked[r];
+                delayed[r] += lanes.delayed[r];
+                busy_area[r] += lanes.busy_area[r];
+                queue_area[r] += lanes.queue_area[r];
+                lanes.arrivals[r] = lanes.blocked[r] = lanes.delayed[r] = 0;
+                lanes.busy_area[r] = lanes.queue_area[r] = 0;
+            }
+        }
+
+        // The last group may be partial; its spare lanes are simulated and dropped
+        for (int r = 0; r < CTMC_LANES && first + r < n_replications; r++) {
+            ErlangRepStat *out = &results[first + r];
+            double n_arrivals = (arrivals[r] > 0) ? (double)arrivals[r] : 1.0;
+            double prob_delayed = delayed[r] / n_arrivals;
+            double avg_queue = queue_area[r] / (double)total_steps;
+
+            out->block_probability = blocked[r] / n_arrivals;
+            out->prob_pkt_delayed = prob_delayed;
+            out->avg_busy = busy_area[r] / (double)total_steps;
+            out->avg_queue_length = avg_queue;
+            // Little's law: L_q = lambda * P(delayed) * W(delayed)
+            out->avg_delay_delayed_pkt = (prob_delayed > 0.0) ? avg_queue / (lambda * prob_delayed) : 0.0;
+        }
+    }
+}
@@ -1,8 +1,28 @@
 #ifndef SYSTEM_H
 #define SYSTEM_H
 
+#include "../models/models.h"
+#include "../models/service_dist.h"
+
+// Part of every stored-result key; bump when a system's output for a given seed changes
+#define ERLANG_RESULTS_VERSION 3
+
 double erlang_b_system(int channels, int lambda, double avg_duration, int n_samples);
+void erlang_b_curve(int max_channels, int lambda, double avg_duration, int n_samples, double *blocking);
 ErlangCstat erlang_c_system(int channels, int lambda, double avg_duration, int n_samples, double delay_threshold);
-ErlangGenStat erlang_gen_system(int channels, int lambda, double avg_duration, int n_samples, double delay_threshold, int queue_capacity);
+// M/G/c and M/G/c/K: service times are drawn from `service` at mean avg_duration,
+// or are exponential when it is NULL
+ErlangCstat erlang_c_system_thresholds(int channels, int lambda, double avg_duration, const service_dist *service,
+                                       int n_samples, const double *thresholds, int n_thresholds,
+                                       double *prob_delayed_more);
+ErlangGenStat erlang_gen_system(int channels, int lambda, double avg_duration, const service_dist *service,
+                                int n_samples, double delay_threshold, int queue_capacity);
+void erlang_gen_analytic(int channels, int lambda, double avg_duration, int queue_capacity,
+                         double *block_probability, double *prob_delayed);
+
+// queue_capacity < 0 means an unbounded queue (Erlang C), 0 a loss system (Erlang B)
+#define CTMC_UNBOUNDED_QUEUE (-1)
+void erlang_ctmc_replications(int channels, int lambda, double avg_duration, int queue_capacity,
+                              int n_samples, int n_replications, ErlangRepStat *results);
 
-#endif // SYSTEM_H
\ No newline at end of file
+#endif // SYSTEM_H